@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Multi-file ingest with a worker thread pool
+ *              Input expansion (files, directories, globs) and parallel parse-to-database loading
+ */
+
+#ifndef BATCH_INGEST_H
+#define BATCH_INGEST_H
+
+#include "stdf_parser.h"
+#include "database.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace STDF {
+
+// Expand command-line inputs into a sorted, de-duplicated list of files.
+// Directories are searched recursively for *.stdf files and arguments with
+// wildcard characters are expanded with glob(3). Paths that do not exist are
+// passed through unchanged so the failure is reported when they are opened.
+std::vector<std::string> expandInputPaths(const std::vector<std::string>& inputs);
+
+// Parse the given record types of all files into an accumulating record
+// handler on up to `jobs` threads, one copy of `prototype` per thread, and
+// merge the copies. Throws std::runtime_error naming the file for the first
+// file that cannot be opened or does not parse to the end.
+template <typename Accumulator>
+Accumulator collectRecords(const std::vector<std::string>& files, size_t jobs, InputMode inputMode,
+                           const std::vector<RecordType>& types,
+                           const Accumulator& prototype = Accumulator()) {
+    std::vector<Accumulator> partial(std::max<size_t>(1, std::min(jobs, files.size())), prototype);
+    std::atomic<size_t> next{0};
+    std::mutex errorMutex;
+    std::string error;
+
+    auto fail = [&](const std::string& file, const std::string& message) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (error.empty()) {
+            error = file + ": " + message;
+        }
+    };
+    auto worker = [&](Accumulator& accumulator) {
+        for (size_t i = next++; i < files.size(); i = next++) {
+            try {
+                STDFParser parser(files[i], inputMode);
+                parser.setRecordFilter(types);
+                parser.parse(accumulator);
+                if (!parser.getLastError().empty()) {
+                    fail(files[i], parser.getLastError());
+                }
+            } catch (const std::exception& e) {
+                fail(files[i], e.what());
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < partial.size(); ++t) {
+        threads.emplace_back(worker, std::ref(partial[t]));
+    }
+    worker(partial[0]);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+
+    for (size_t t = 1; t < partial.size(); ++t) {
+        partial[0].merge(partial[t]);
+    }
+    return std::move(partial[0]);
+}
+
+// Busy and idle time of the two pipelined ingest stages. Idle is time spent
+// waiting on the ring: the parser when it is full, the writer when it is empty.
+struct PipelineStageTimes {
+    double parseBusySeconds = 0.0;
+    double parseIdleSeconds = 0.0;
+    double writeBusySeconds = 0.0;
+    double writeIdleSeconds = 0.0;
+    size_t batches = 0;
+
+    void add(const PipelineStageTimes& other);
+};
+
+// Outcome of loading a single STDF file
+struct FileIngestResult {
+    std::string filename;
+    size_t fileSize = 0;
+    size_t recordCount = 0;   // Records decoded from the file
+    size_t insertedCount = 0; // Records written to the database
+    bool committed = false;   // File transaction committed
+    std::string error;        // Reason the file was rolled back, if any
+    PipelineStageTimes pipeline; // Pipelined mode only
+};
+
+// Totals for a batch run
+struct BatchIngestSummary {
+    std::vector<FileIngestResult> files; // Same order as the input list
+    size_t totalRecords = 0;
+    size_t totalInserted = 0;
+    size_t totalBytes = 0;
+    size_t filesFailed = 0;
+    double elapsedSeconds = 0.0;
+    PipelineStageTimes pipeline; // Summed over files in pipelined mode
+
+    double recordsPerSecond() const;
+    double megabytesPerSecond() const;
+};
+
+class BatchIngest {
+public:
+    static const size_t DEFAULT_BUFFER_LIMIT = size_t{512} * 1024 * 1024;
+
+    BatchIngest(Database& database, size_t workerCount, InputMode mode = InputMode::Stream);
+
+    void setVerbose(bool verbose) { verbose_ = verbose; }
+    
+    // With a single worker, parse on one thread and write to the database on
+    // another, handing record batches over through a bounded ring
+    void setPipelined(bool pipelined) { pipelined_ = pipelined; }
+    
+    // Only decode and load these record types (see STDFParser::setRecordFilter)
+    void setRecordFilter(const std::vector<RecordType>& types) { recordTypes_ = types; }
+
+    // Pool workers decode a whole file before committing it, so memory grows
+    // with the files in flight. Each worker reserves its file's size from
+    // this many input bytes before parsing and returns it after the commit;
+    // a file larger than the limit waits until it can run alone. Decoded
+    // records take a few times their size in the file.
+    void setBufferLimit(size_t bytes) { bufferLimit_ = bytes > 0 ? bytes : 1; }
+
+    // Load every file into the database. Each file is committed in its own
+    // transaction, so a file that fails to parse or insert leaves no rows.
+    // Files are handed out largest first from a shared queue, so one huge file
+    // starts early and the remaining workers drain the small ones around it.
+    // With more workers than files, each file is decoded on several threads.
+    BatchIngestSummary run(const std::vector<std::string>& files);
+
+private:
+    Database& database_;
+    size_t workerCount_;
+    InputMode mode_;
+    bool verbose_;
+    bool pipelined_;
+    size_t decodeThreads_; // Decode threads per file
+    std::vector<RecordType> recordTypes_; // Empty loads every type
+    std::mutex databaseMutex_;
+    size_t bufferLimit_;
+    size_t buffered_;                    // Input bytes reserved by pool workers
+    std::mutex bufferMutex_;
+    std::condition_variable bufferReleased_;
+
+    size_t reserveBuffer(size_t fileSize);
+    void releaseBuffer(size_t bytes);
+
+    // Single worker: stream records straight into the open transaction
+    void ingestStreaming(FileIngestResult& result);
+
+    // Single worker, pipelined: a parser thread feeds batches through an
+    // SpscRing to this thread, which inserts them into the open transaction
+    void ingestPipelined(FileIngestResult& result);
+
+    // Pool worker: reserve buffer space, parse the whole file (in parallel
+    // chunks when decode threads are spare), then commit it under the
+    // database lock
+    void ingestBuffered(FileIngestResult& result);
+
+    // Open the file's transaction and register it in the files table
+    bool beginFileTransaction(FileIngestResult& result);
+
+    bool commitRecords(const std::vector<std::unique_ptr<STDFRecord>>& records,
+                       FileIngestResult& result);
+
+    // Insert records inside the caller's transaction, one insertBatch() per
+    // run of same-type records. Sets result.error on failure.
+    bool insertRecords(const std::vector<std::unique_ptr<STDFRecord>>& records,
+                       FileIngestResult& result);
+};
+
+} // namespace STDF
+
+#endif // BATCH_INGEST_H
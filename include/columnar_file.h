@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Columnar result files (.stdfc)
+ *              Chunked per-record-type columns with a footer of offsets and min/max stats
+ */
+
+#ifndef COLUMNAR_FILE_H
+#define COLUMNAR_FILE_H
+
+#include "stdf_parser.h"
+#include <fstream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace STDF {
+
+// Physical type of a column. Data is stored little-endian in the file.
+enum class ColumnType : uint8_t {
+    U8 = 1,
+    U16,
+    I16,
+    U32,
+    F32,
+    Dict  // uint32_t codes into a string dictionary stored in the footer
+};
+
+// Where one column's values for one chunk live, with their range so a scan
+// can skip chunks that cannot match
+struct ColumnChunkInfo {
+    uint64_t offset; // File offset, 8-byte aligned
+    uint64_t size;   // Bytes
+    double min;
+    double max;
+};
+
+// Read-only view of one column chunk inside the reader's mapping
+template <typename T>
+struct ColumnSpan {
+    const T* data = nullptr;
+    size_t size = 0;
+
+    const T* begin() const { return data; }
+    const T* end() const { return data + size; }
+    const T& operator[](size_t i) const { return data[i]; }
+};
+
+// C++ element type accepted by ColumnarReader::column<T>() for each ColumnType
+template <typename T> struct ColumnTypeOf;
+template <> struct ColumnTypeOf<U1> { static constexpr ColumnType value = ColumnType::U8; };
+template <> struct ColumnTypeOf<U2> { static constexpr ColumnType value = ColumnType::U16; };
+template <> struct ColumnTypeOf<I2> { static constexpr ColumnType value = ColumnType::I16; };
+template <> struct ColumnTypeOf<U4> { static constexpr ColumnType value = ColumnType::U32; };
+template <> struct ColumnTypeOf<R4> { static constexpr ColumnType value = ColumnType::F32; };
+
+// Writes PRR, PTR, FTR, HBR and SBR records to a .stdfc file as columns,
+// cut into chunks of chunkRows rows. Feed it with STDFParser::parse(), then
+// call finish(). Every PRR/PTR/FTR row has a part_index column: the number
+// of the PIR that opened its part (0-based, UINT32_MAX outside a part).
+//
+// Columns:
+//   PRR: part_index head_num site_num part_flg num_test hard_bin soft_bin
+//        x_coord y_coord test_t part_id(dict)
+//   PTR: part_index test_num head_num site_num test_flg parm_flg result test_txt(dict)
+//   FTR: part_index test_num head_num site_num test_flg
+//   HBR: head_num site_num hbin_num hbin_cnt hbin_pf hbin_nam(dict)
+//   SBR: head_num site_num sbin_num sbin_cnt sbin_pf sbin_nam(dict)
+class ColumnarWriter : public RecordHandler {
+public:
+    static const size_t DEFAULT_CHUNK_ROWS = 65536;
+
+    explicit ColumnarWriter(const std::string& path, size_t chunkRows = DEFAULT_CHUNK_ROWS);
+    ~ColumnarWriter() override;
+
+    void onPIR(const PIRRecord& record) override;
+    void onPRR(const PRRRecord& record) override;
+    void onPTR(const PTRRecord& record) override;
+    void onFTR(const FTRRecord& record) override;
+    void onHBR(const HBRRecord& record) override;
+    void onSBR(const SBRRecord& record) override;
+
+    // Start the next input file: parts its predecessor left open (a PIR
+    // without a PRR) no longer take rows
+    void beginFile() { openParts_.clear(); }
+
+    // Write the last chunks and the footer. Throws std::runtime_error on I/O
+    // errors; the destructor calls it (ignoring errors) if nobody did.
+    void finish();
+
+    size_t getRowCount(RecordType type) const;
+
+private:
+    struct Column {
+        std::string name;
+        ColumnType type;
+        std::vector<uint8_t> buffer; // Values of the current chunk
+        double min;
+        double max;
+        std::vector<ColumnChunkInfo> chunks;
+        std::unordered_map<std::string, uint32_t> codes; // Dict only
+        std::vector<std::string> dictionary;
+    };
+
+    struct Table {
+        RecordType type;
+        std::vector<Column> columns;
+        size_t chunkFill = 0; // Rows in the current chunk
+        std::vector<uint64_t> chunkRows;
+        size_t rows = 0;
+    };
+
+    std::string path_;
+    size_t chunkRows_;
+    std::ofstream out_;
+    uint64_t position_;
+    bool finished_;
+    std::vector<Table> tables_;
+
+    // Part ordinal of the PIR open on each head/site
+    std::unordered_map<uint16_t, U4> openParts_;
+    U4 partCount_;
+
+    Table& table(RecordType type);
+    U4 partIndex(U1 headNum, U1 siteNum) const;
+    template <typename T> static void put(Column& column, T value);
+    static void putString(Column& column, const std::string& value);
+    void endRow(Table& table);
+    void flushChunk(Table& table);
+    void write(const void* data, size_t size);
+};
+
+// Memory-maps a .stdfc file. Column chunks are returned as typed spans into
+// the mapping, so a scan is a plain loop over contiguous values with no
+// decoding step. Throws std::runtime_error for missing or corrupt files.
+class ColumnarReader {
+public:
+    explicit ColumnarReader(const std::string& path);
+    ~ColumnarReader();
+
+    ColumnarReader(const ColumnarReader&) = delete;
+    ColumnarReader& operator=(const ColumnarReader&) = delete;
+
+    bool hasTable(RecordType type) const { return tables_.count(type) != 0; }
+    size_t getRowCount(RecordType type) const;
+    size_t getChunkCount(RecordType type) const;
+    size_t getChunkRows(RecordType type, size_t chunk) const;
+    std::vector<std::string> getColumnNames(RecordType type) const;
+    ColumnType getColumnType(RecordType type, const std::string& name) const;
+    const ColumnChunkInfo& getChunkInfo(RecordType type, const std::string& name, size_t chunk) const;
+    const std::vector<std::string>& getDictionary(RecordType type, const std::string& name) const;
+
+    // Values of one column in one chunk. T must match the column type
+    // (U4 for dictionary codes).
+    template <typename T>
+    ColumnSpan<T> column(RecordType type, const std::string& name, size_t chunk) const {
+        const Column& c = findColumn(type, name);
+        if (ColumnTypeOf<T>::value != c.type &&
+            !(c.type == ColumnType::Dict && ColumnTypeOf<T>::value == ColumnType::U32)) {
+            throw std::runtime_error("Column " + name + " read with the wrong element type");
+        }
+        const ColumnChunkInfo& info = c.chunks.at(chunk);
+        ColumnSpan<T> span;
+        span.data = reinterpret_cast<const T*>(data_ + info.offset);
+        span.size = static_cast<size_t>(info.size / sizeof(T));
+        return span;
+    }
+
+private:
+    struct Column {
+        std::string name;
+        ColumnType type;
+        std::vector<ColumnChunkInfo> chunks;
+        std::vector<std::string> dictionary;
+    };
+
+    struct Table {
+        uint64_t rows = 0;
+        std::vector<uint64_t> chunkRows;
+        std::vector<Column> columns;
+    };
+
+    const uint8_t* data_;
+    size_t size_;
+    std::map<RecordType, Table> tables_;
+
+    const Table& findTable(RecordType type) const;
+    const Column& findColumn(RecordType type, const std::string& name) const;
+    void readFooter(const std::string& path);
+};
+
+} // namespace STDF
+
+#endif // COLUMNAR_FILE_H
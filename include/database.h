@@ -23,21 +23,83 @@
 
 #include "stdf_types.h"
 #include <sqlite3.h>
+#include <array>
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace STDF {
 
+// Connection settings applied by Database::open()
+enum class LoadProfile {
+    Default,    // SQLite defaults
+    BulkLoad,   // Fastest loading: in-memory journal, no fsync, large cache and
+                // mmap, exclusive lock. A crash mid-load can corrupt the file.
+    Production  // WAL with synchronous=NORMAL, so readers run alongside the loader
+};
+
+const char* loadProfileName(LoadProfile profile);
+bool loadProfileFromName(const std::string& name, LoadProfile& profile);
+
+// Table layout for parametric test results
+enum class SchemaMode {
+    Wide,       // Every ptr_records row repeats the test text, units, formats and limits
+    Normalized  // Static PTR metadata is stored once per file and test in test_defs;
+                // ptr_records keeps only the per-execution columns
+};
+
+const char* schemaModeName(SchemaMode mode);
+bool schemaModeFromName(const std::string& name, SchemaMode& mode);
+
 class Database {
 public:
-    explicit Database(const std::string& dbPath);
+    explicit Database(const std::string& dbPath, LoadProfile profile = LoadProfile::Default);
     ~Database();
 
     // Database operations
     bool open();
     void close();
     bool isOpen() const { return db_ != nullptr; }
+    LoadProfile getLoadProfile() const { return profile_; }
+    
+    // Build the database in memory and write it to dbPath with the SQLite
+    // backup API on flush() or close(). An existing file is read in first, so
+    // loads append as usual. Must be set before open().
+    void setInMemoryStaging(bool staging) { stageInMemory_ = staging; }
+    bool isStagedInMemory() const { return stageInMemory_; }
+    
+    // Write the staged in-memory database to dbPath (no-op when not staging).
+    // close() flushes again only if rows changed since.
+    bool flush();
+    
+    // Current value of a PRAGMA on this connection, e.g. "journal_mode"
+    std::string queryPragma(const std::string& name) const;
+    
+    // Layout used by createTables() for a new database. open() switches to
+    // the layout an existing database was created with.
+    void setSchemaMode(SchemaMode mode) { schemaMode_ = mode; }
+    SchemaMode getSchemaMode() const { return schemaMode_; }
+    
+    // Register a source file in the files table. Later rows carry its file_id
+    // until the next call. Returns the new file_id, or -1 on error.
+    //
+    // Rows are also linked to their part: between a PIR and the PRR for the
+    // same head/site, PTR, FTR and PRR rows get part_id (pir_id on the PRR)
+    // set to the PIR's row id.
+    long long beginFile(const std::string& path);
+    long long getCurrentFileId() const { return currentFileId_; }
+    
+    // Secondary indexes on test number, site, bins, lot and wafer, plus the
+    // file/part links. createTables() builds them unless they are deferred;
+    // a deferred load drops them and calls createIndexes() once at the end.
+    // Deferral defaults to on for LoadProfile::BulkLoad.
+    void setDeferIndexes(bool defer) { deferIndexes_ = defer; }
+    bool isDeferringIndexes() const { return deferIndexes_; }
+    bool createIndexes();
+    bool dropIndexes();
+    std::vector<std::string> getMissingIndexes() const;
     
     // Schema creation
     bool createTables();
@@ -57,6 +119,23 @@ public:
     // Generic record insertion
     bool insertRecord(const STDFRecord& record);
     
+    // Multi-row insertion of records that all have the same type. Rows go
+    // into cached INSERT ... VALUES (...), (...) statements sized to stay
+    // within SQLite's host parameter limit.
+    bool insertBatch(const std::vector<const STDFRecord*>& records);
+    
+    // Timing of the last insertBatch() call and of all calls so far
+    struct BatchTiming {
+        size_t rows = 0;
+        size_t statements = 0; // Multi-row statements executed
+        double seconds = 0.0;
+        
+        double rowsPerSecond() const { return seconds > 0.0 ? rows / seconds : 0.0; }
+    };
+    
+    const BatchTiming& getLastBatchTiming() const { return lastBatch_; }
+    const BatchTiming& getTotalBatchTiming() const { return totalBatch_; }
+    
     // Batch operations
     bool beginTransaction();
     bool commitTransaction();
@@ -65,6 +144,7 @@ public:
     // Query operations
     std::vector<std::string> getAvailableLots() const;
     std::vector<std::string> getAvailablePartTypes() const;
+    // Record tables are counted from db_summary; other tables with COUNT(*)
     int getRecordCount(const std::string& tableName) const;
     
     // Statistics
@@ -76,19 +156,131 @@ public:
         int totalTests;
     };
     
+    // Read from db_summary, or one aggregate query when it does not exist
     TestStatistics getTestStatistics() const;
     
+    // Insert statements are prepared once per connection and reused. These
+    // counters show how often each one was compiled and executed.
+    struct StatementStats {
+        size_t prepares = 0;
+        size_t executions = 0;
+        
+        size_t reuses() const { return executions > prepares ? executions - prepares : 0; }
+    };
+    
+    StatementStats getStatementStats(RecordType type) const;
+    
     // Error handling
     std::string getLastError() const { return lastError_; }
 
 private:
     std::string dbPath_;
     sqlite3* db_;
+    LoadProfile profile_;
+    bool stageInMemory_;
+    long long flushedChanges_; // sqlite3_total_changes() at the last flush, -1 before any
+    SchemaMode schemaMode_;
+    long long currentFileId_;  // 0 until beginFile()
+    bool deferIndexes_;
+    
+    // Row counts in db_summary, changed by in-memory deltas that are written
+    // when the transaction commits. Outside a transaction each insert runs in
+    // a savepoint that writes its rows and their deltas in one commit.
+    // Rows written behind Database's back are not counted.
+    bool summaryReady_;
+    bool inTransaction_;
+    bool inSavepoint_;
+    std::array<long long, RECORD_TYPE_COUNT> pendingRows_{};
+    long long pendingPassedParts_;
+    sqlite3_stmt* summaryStatement_;
+    sqlite3_stmt* savepointStatement_;
+    sqlite3_stmt* releaseStatement_;
+    sqlite3_stmt* rollbackToStatement_;
     std::string lastError_;
     
+    // Parts between their PIR and PRR, keyed by siteKey(); the value is the
+    // PIR's row id
+    std::unordered_map<uint16_t, long long> openParts_;
+    
+    // Normalized mode: tests already in test_defs for the current file
+    std::unordered_set<U4> definedTests_;
+    sqlite3_stmt* testDefStatement_;
+    
+    // Cached insert statements, indexed by RecordType
+    struct CachedStatement {
+        sqlite3_stmt* stmt = nullptr;
+        StatementStats stats;
+    };
+    std::array<CachedStatement, RECORD_TYPE_COUNT> insertStatements_;
+    
+    // Cached multi-row statements for insertBatch(), one per power-of-two row
+    // count (1 to 512 rows), so any batch size reuses a few statements
+    static constexpr size_t BATCH_SIZE_CLASSES = 10;
+    std::array<std::array<sqlite3_stmt*, BATCH_SIZE_CLASSES>, RECORD_TYPE_COUNT> batchStatements_{};
+    BatchTiming lastBatch_;
+    BatchTiming totalBatch_;
+    
     // Helper methods
     bool executeSQL(const std::string& sql);
     bool prepareStatement(const std::string& sql, sqlite3_stmt** stmt);
+    sqlite3_stmt* cachedStatement(RecordType type, const char* sql);
+    bool stepCachedStatement(sqlite3_stmt* stmt);
+    // Prepare sql into stmt on first use, then step it like the inserts
+    bool stepStatement(sqlite3_stmt*& stmt, const char* sql);
+    void finalizeStatements();
+    
+    // PRAGMAs for profile_ on a connection; inMemory skips file-only settings
+    bool applyProfile(sqlite3* db, bool inMemory);
+    
+    // Copy a whole database between connections with the backup API
+    bool copyDatabase(sqlite3* source, sqlite3* destination);
+    
+    // Pick up the schema mode of an existing database and whether it has a
+    // db_summary table
+    void detectSchemaMode();
+    
+    // Normalized mode: add the test_defs row for a PTR's test on first sight
+    bool defineTest(const PTRRecord& record);
+    
+    // Add file/part link columns missing from a database created by an older
+    // version
+    bool migrateLinkColumns();
+    
+    // Create db_summary, seeded from the existing rows when it is new
+    bool createSummary();
+    void countInserted(RecordType type, size_t rows);
+    bool flushSummary();
+    // Bracket one insert call. Outside a transaction the rows and their
+    // summary deltas commit together, or neither does; endWrite() returns
+    // whether they did. Inside a transaction both are no-ops.
+    bool beginWrite();
+    bool endWrite(bool ok);
+    void discardSummaryDeltas();
+    bool readSummary(const std::string& key, long long& value) const;
+    static const char* recordTable(RecordType type);
+    
+    static uint16_t siteKey(U1 headNum, U1 siteNum) { return static_cast<uint16_t>(headNum << 8 | siteNum); }
+    int bindPartId(sqlite3_stmt* stmt, int param, U1 headNum, U1 siteNum) const;
+    
+    // Parameter binding shared by the single-row and multi-row inserts. Each
+    // binds one record starting at param and returns the next free parameter.
+    int bindFAR(sqlite3_stmt* stmt, int param, const FARRecord& record);
+    int bindMIR(sqlite3_stmt* stmt, int param, const MIRRecord& record);
+    int bindPIR(sqlite3_stmt* stmt, int param, const PIRRecord& record);
+    int bindPRR(sqlite3_stmt* stmt, int param, const PRRRecord& record);
+    int bindPTR(sqlite3_stmt* stmt, int param, const PTRRecord& record);
+    int bindPTRResult(sqlite3_stmt* stmt, int param, const PTRRecord& record);
+    int bindFTR(sqlite3_stmt* stmt, int param, const FTRRecord& record);
+    int bindHBR(sqlite3_stmt* stmt, int param, const HBRRecord& record);
+    int bindSBR(sqlite3_stmt* stmt, int param, const SBRRecord& record);
+    int bindWIR(sqlite3_stmt* stmt, int param, const WIRRecord& record);
+    int bindWRR(sqlite3_stmt* stmt, int param, const WRRRecord& record);
+    int bindRecord(sqlite3_stmt* stmt, int param, const STDFRecord& record);
+    
+    const char* insertSQL(RecordType type) const;
+    static std::string multiRowSQL(const char* sql, size_t rows);
+    bool executeBatch(sqlite3_stmt* stmt, const std::vector<const STDFRecord*>& records,
+                      size_t first, size_t count);
     void setLastError(const std::string& error);
     void setLastSQLiteError();
     
@@ -103,6 +295,18 @@ private:
     static const char* CREATE_SBR_TABLE;
     static const char* CREATE_WIR_TABLE;
     static const char* CREATE_WRR_TABLE;
+    static const char* CREATE_FILES_TABLE;
+    static const char* CREATE_TEST_DEFS_TABLE;
+    static const char* CREATE_PTR_RESULTS_TABLE;
+    static const char* CREATE_PTR_FULL_VIEW;
+    static const char* CREATE_SUMMARY_TABLE;
+    static const char* PASSED_PARTS_KEY;
+    
+    struct IndexDefinition {
+        const char* name;
+        const char* definition; // "table(columns)"
+    };
+    static const IndexDefinition MANAGED_INDEXES[];
     
     // Insert statement definitions
     static const char* INSERT_FAR_SQL;
@@ -114,6 +318,8 @@ private:
     static const char* INSERT_HBR_SQL;
     static const char* INSERT_SBR_SQL;
     static const char* INSERT_WIR_SQL;
+    static const char* INSERT_PTR_RESULT_SQL;
+    static const char* INSERT_TEST_DEF_SQL;
     static const char* INSERT_WRR_SQL;
 };
 
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: What-if re-evaluation of PTR results against new test limits
+ *              Per-test result columns, SIMD limit kernels and the yield delta report
+ */
+
+#ifndef LIMIT_WHATIF_H
+#define LIMIT_WHATIF_H
+
+#include "stdf_parser.h"
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace STDF {
+
+class ColumnarReader;
+
+// Low/high limit of one test; a missing side never fails. Results pass when
+// LO <= RESULT <= HI.
+struct TestLimits {
+    bool hasLo = false;
+    bool hasHi = false;
+    float lo = 0.0f;
+    float hi = 0.0f;
+};
+
+using LimitSet = std::unordered_map<U4, TestLimits>;
+
+// Limits file: one test per line as "TEST_NUM LO HI" (whitespace or comma
+// separated), "-" for a missing limit, '#' starts a comment. Values are in
+// RESULT units, before RES_SCAL. Throws std::runtime_error naming the line
+// of a malformed entry.
+LimitSet parseLimits(std::istream& in);
+LimitSet loadLimitsFile(const std::string& path);
+
+// Compare kernels; Auto picks AVX2 when the CPU has it
+enum class LimitKernel {
+    Auto,
+    Scalar,
+    Avx2
+};
+
+bool avx2Available();
+
+// Sets bit i of mask (bit i % 64 of word i / 64) when values[i] is outside
+// the limits and returns the number of such values. mask needs
+// (count + 63) / 64 words; NaN values never fail.
+size_t markLimitFailures(const float* values, size_t count, const TestLimits& limits, uint64_t* mask,
+                         LimitKernel kernel = LimitKernel::Auto);
+
+// The results of one test number in contiguous arrays
+struct TestColumn {
+    U4 testNum = 0;
+    std::string testText;
+    TestLimits limits;                // Limits found in the PTRs (STDF input only)
+    std::vector<float> results;       // Valid RESULTs
+    std::vector<U4> parts;            // Part of each result
+    std::vector<uint64_t> failedMask; // Bit per result: TEST_FLG said it failed
+    uint64_t failed = 0;
+};
+
+// Outcome of one test under the new limits
+struct TestWhatIf {
+    U4 testNum = 0;
+    std::string testText;
+    uint64_t results = 0;
+    TestLimits oldLimits;
+    TestLimits newLimits;
+    uint64_t oldFails = 0;   // Results the tester flagged as failing
+    uint64_t newFails = 0;   // Results outside the new limits
+};
+
+struct WhatIfResult {
+    uint64_t parts = 0;        // Parts with a PRR
+    uint64_t binPassed = 0;    // Parts in a pass bin, as tested
+    uint64_t newPassed = 0;    // Parts passing under the new limits
+    uint64_t newlyFailing = 0; // binPassed parts that now fail
+    uint64_t newlyPassing = 0; // Failing parts whose every failure is cleared
+    std::vector<TestWhatIf> tests; // Tests named in the limit set, by test number
+
+    double oldYield() const { return parts ? static_cast<double>(binPassed) / static_cast<double>(parts) : 0.0; }
+    double newYield() const { return parts ? static_cast<double>(newPassed) / static_cast<double>(parts) : 0.0; }
+};
+
+// Loads PTR RESULTs per test number into TestColumns, either as a record
+// handler over STDF files (parts are opened by PIR and closed by PRR, as in
+// ColumnarWriter) or from the PTR/PRR/FTR columns of a .stdfc file. Not
+// executed and invalid results are dropped. evaluate() then re-judges every
+// test named in a limit set with markLimitFailures(); other tests keep the
+// tester's verdict. A part passes under the new limits when no PTR or FTR
+// fails and it was either in a pass bin or failed only on PTR/FTR results
+// (a part binned out for an unknown reason stays failed).
+class LimitWhatIf : public RecordHandler {
+public:
+    explicit LimitWhatIf(std::unordered_set<U2> passBins = {1});
+
+    void onPIR(const PIRRecord& record) override;
+    void onPRR(const PRRRecord& record) override;
+    void onPTR(const PTRRecord& record) override;
+    void onFTR(const FTRRecord& record) override;
+
+    // Start the next STDF file: parts its predecessor left open (a PIR
+    // without a PRR) no longer take results
+    void beginFile() { openParts_.clear(); }
+
+    // Append the parts and results of a columnar file
+    void loadColumnar(const ColumnarReader& reader);
+
+    // Append one input file: .stdfc through loadColumnar(), anything else
+    // parsed as STDF after beginFile(). Throws std::runtime_error when an
+    // STDF file stops parsing early; a yield delta over part of the lot
+    // would look like a real one.
+    void loadFile(const std::string& path, InputMode mode = InputMode::Stream);
+
+    WhatIfResult evaluate(const LimitSet& limits, LimitKernel kernel = LimitKernel::Auto) const;
+
+    const std::vector<TestColumn>& getTests() const { return tests_; }
+    size_t getPartCount() const { return partFlags_.size(); }
+    uint64_t getResultCount() const;
+
+    // Yield before/after, newly failing/passing parts, then one row per
+    // re-evaluated test with old and new limits and fail counts
+    static void writeReport(std::ostream& out, const WhatIfResult& result);
+
+private:
+    // partFlags_ bits
+    static constexpr uint8_t PART_DONE = 0x01;     // PRR seen
+    static constexpr uint8_t PART_BIN_PASS = 0x02; // Hard bin is a pass bin
+    static constexpr uint8_t PART_FLAGGED = 0x04;  // A PTR or FTR was flagged failing
+    static constexpr uint8_t PART_FTR_FAIL = 0x08; // An FTR was flagged failing
+
+    std::unordered_set<U2> passBins_;
+    std::vector<uint8_t> partFlags_;
+    std::unordered_map<uint16_t, U4> openParts_;  // head << 8 | site -> part
+    std::vector<TestColumn> tests_;
+    std::unordered_map<U4, uint32_t> testIndex_;
+    uint32_t lastTest_;
+
+    U4 openPart(U1 headNum, U1 siteNum) const;
+    TestColumn& column(U4 testNum);
+    void addResult(TestColumn& test, U4 part, U1 testFlg, float result);
+};
+
+} // namespace STDF
+
+#endif // LIMIT_WHATIF_H
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Mergeable bounded-memory quantile sketches (KLL) per test
+ *              Serializable so per-file sketches can be combined later
+ */
+
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include "stdf_parser.h"
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace STDF {
+
+// KLL quantile sketch over float values. Level h holds items that each stand
+// for 2^h inputs; a full level is sorted and every other item (random offset)
+// is promoted. Memory stays around 3k items however many values are added;
+// the rank error is under about 2% at the default k and shrinks as 1/k.
+class KllSketch {
+public:
+    static const uint16_t DEFAULT_K = 200;
+
+    explicit KllSketch(uint16_t k = DEFAULT_K);
+
+    void add(float value);
+
+    // Combine with a sketch of other values, as if they had been added here
+    void merge(const KllSketch& other);
+
+    uint64_t count() const { return n_; }
+    bool empty() const { return n_ == 0; }
+    float min() const { return min_; }   // Exact
+    float max() const { return max_; }   // Exact
+    size_t retained() const { return retained_; }
+
+    // Approximate value at rank q in [0, 1] (0 -> min, 1 -> max). NaN when empty.
+    double quantile(double q) const;
+    // Several ranks with one sort of the retained items
+    std::vector<double> quantiles(const std::vector<double>& ranks) const;
+
+    // Approximate counts of `bins` equal-width bins over [lo, hi). Values
+    // outside the range are not counted, except that hi itself falls into
+    // the last bin.
+    std::vector<uint64_t> histogram(double lo, double hi, size_t bins) const;
+
+    // Portable little-endian encoding; deserialize() throws
+    // std::runtime_error on malformed input
+    void serialize(std::vector<uint8_t>& out) const;
+    static KllSketch deserialize(const uint8_t* data, size_t size, size_t& consumed);
+
+private:
+    uint16_t k_;
+    uint64_t n_;
+    float min_;
+    float max_;
+    std::vector<std::vector<float>> levels_; // Level h items weigh 2^h
+    size_t retained_;                        // Items over all levels
+    size_t limit_;                           // totalCapacity() for the current levels
+    uint64_t random_;                        // xorshift state for compaction offsets
+
+    size_t capacity(size_t level) const;
+    size_t totalCapacity() const;
+    void compress();
+    std::vector<std::pair<float, uint64_t>> weightedItems() const; // Sorted by value
+};
+
+// Distribution of one test number's results
+struct TestDistribution {
+    U4 testNum = 0;
+    std::string testText;
+    std::string units;
+    bool hasResScale = false;
+    I1 resScale = 0;      // RES_SCAL: displayed value = RESULT * 10^RES_SCAL
+    KllSketch sketch;
+
+    double scale() const;              // 10^RES_SCAL, or 1 without RES_SCAL
+    std::string scaledUnits() const;   // Units with the RES_SCAL prefix, e.g. "mV"
+};
+
+// Record handler that keeps a KllSketch of RESULT per TEST_NUM (all sites
+// together). Results of tests that were not executed or are flagged invalid
+// are skipped. Collections from several files or threads combine with
+// merge(), directly or after a serialize()/deserialize() round trip.
+class TestQuantiles : public RecordHandler {
+public:
+    explicit TestQuantiles(uint16_t k = KllSketch::DEFAULT_K) : k_(k) {}
+
+    void onPTR(const PTRRecord& record) override;
+
+    void merge(const TestQuantiles& other);
+
+    // Entries ordered by test number
+    std::vector<const TestDistribution*> getResults() const;
+    const TestDistribution* find(U4 testNum) const;
+    size_t size() const { return tests_.size(); }
+
+    std::vector<uint8_t> serialize() const;
+    static TestQuantiles deserialize(const std::vector<uint8_t>& data);
+
+    // File form of serialize(); both throw std::runtime_error on I/O errors
+    void save(const std::string& path) const;
+    static TestQuantiles load(const std::string& path);
+
+    // P1/P50/P99 per test in RES_SCAL-scaled units; with histogramBins > 0
+    // each test is followed by a fixed-bin histogram over its min..max
+    static void writeReport(std::ostream& out, const std::vector<const TestDistribution*>& results,
+                            size_t histogramBins = 0);
+
+private:
+    uint16_t k_;
+    std::unordered_map<U4, TestDistribution> tests_;
+
+    TestDistribution& entry(U4 testNum);
+};
+
+} // namespace STDF
+
+#endif // QUANTILE_SKETCH_H
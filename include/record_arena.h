@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Bump allocator for whole-file record loads
+ *              Record bodies and views carved from large blocks and released all at once
+ */
+
+#ifndef RECORD_ARENA_H
+#define RECORD_ARENA_H
+
+#include "stdf_types.h"
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace STDF {
+
+// Hands out memory from large blocks by bumping a pointer. Nothing is freed
+// individually: all memory goes away when the arena is destroyed or reset().
+// Only trivially destructible objects may be created in it, since no
+// destructors are ever run.
+class RecordArena {
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+    explicit RecordArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    RecordArena(const RecordArena&) = delete;
+    RecordArena& operator=(const RecordArena&) = delete;
+    // The moved-from arena is left empty, as if newly constructed
+    RecordArena(RecordArena&& other) noexcept;
+    RecordArena& operator=(RecordArena&& other) noexcept;
+
+    // Uninitialized memory, aligned to align (a power of two no larger than
+    // alignof(std::max_align_t), the alignment of every block)
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        size_t offset = (used_ + align - 1) & ~(align - 1);
+        if (offset + size > capacity_) {
+            return allocateSlow(size, align);
+        }
+        used_ = offset + size;
+        return current_ + offset;
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "RecordArena never runs destructors");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Release every allocation. The first block is kept for reuse.
+    void reset();
+
+    // Bytes handed out, and bytes reserved from the system
+    size_t getBytesUsed() const { return bytesUsed_ + used_; }
+    size_t getBytesReserved() const { return bytesReserved_; }
+    size_t getBlockCount() const { return blocks_.size(); }
+
+private:
+    size_t blockSize_;
+    struct Block {
+        std::unique_ptr<U1[]> data;
+        size_t size;
+    };
+    std::vector<Block> blocks_;
+    U1* current_;
+    size_t used_;       // Offset into the current block
+    size_t capacity_;   // Size of the current block
+    size_t bytesUsed_;  // Bytes used in retired blocks
+    size_t bytesReserved_;
+
+    void* allocateSlow(size_t size, size_t align);
+};
+
+} // namespace STDF
+
+#endif // RECORD_ARENA_H
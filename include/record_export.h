@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Streaming CSV and JSON Lines exporters
+ *              Numbers are formatted with std::to_chars into large reusable buffers
+ */
+
+#ifndef RECORD_EXPORT_H
+#define RECORD_EXPORT_H
+
+#include "stdf_parser.h"
+#include <array>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace STDF {
+
+enum class ExportFormat {
+    Csv,       // One table per record type with a header row
+    JsonLines  // One object per record, all types in one stream
+};
+
+// "csv" / "jsonl", and the reverse lookup (false for unknown names)
+const char* exportFormatName(ExportFormat format);
+bool exportFormatFromName(const std::string& name, ExportFormat& format);
+
+// Append-only character buffer that is written to a FILE* in large blocks
+// whenever it fills up. The append functions are the formatting hot path and
+// stay inline.
+class ExportBuffer {
+public:
+    static const size_t DEFAULT_CAPACITY = 1 << 20;
+
+    explicit ExportBuffer(FILE* out, size_t capacity = DEFAULT_CAPACITY);
+    ~ExportBuffer(); // Flushes; errors are logged
+
+    ExportBuffer(const ExportBuffer&) = delete;
+    ExportBuffer& operator=(const ExportBuffer&) = delete;
+
+    // Write the buffered bytes. Throws std::runtime_error on write errors.
+    void flush();
+
+    uint64_t getBytesWritten() const { return written_ + size_; }
+
+    void append(char c) {
+        if (size_ == data_.size()) flush();
+        data_[size_++] = c;
+    }
+
+    void append(const char* text, size_t length) {
+        if (data_.size() - size_ < length) {
+            flush();
+            if (length > data_.size()) {
+                writeBlock(text, length);
+                return;
+            }
+        }
+        std::memcpy(data_.data() + size_, text, length);
+        size_ += length;
+    }
+
+    // Integers and floats; R4 values print the shortest text that reads
+    // back as the same float
+    template <typename T>
+    void appendNumber(T value) {
+        if (data_.size() - size_ < MAX_NUMBER_CHARS) flush();
+        char* begin = data_.data() + size_;
+        size_ += static_cast<size_t>(std::to_chars(begin, begin + MAX_NUMBER_CHARS, value).ptr - begin);
+    }
+
+private:
+    static const size_t MAX_NUMBER_CHARS = 32;
+
+    FILE* out_;
+    std::vector<char> data_;
+    size_t size_;
+    uint64_t written_;
+
+    void writeBlock(const char* data, size_t size);
+};
+
+// Record handler that formats records to text; finish() must be called
+// (or the destructor will flush, logging errors) once parsing is done
+class RecordExporter : public RecordHandler {
+public:
+    // Flush all buffers and close the files the exporter opened. Throws
+    // std::runtime_error on write errors.
+    virtual void finish() = 0;
+
+    virtual size_t getRowCount() const = 0;
+    virtual uint64_t getBytesWritten() const = 0;
+};
+
+// Writes one CSV table per record type: FAR, MIR, PIR, PRR, PTR, FTR, HBR,
+// SBR, WIR and WRR. Scalar and text fields are exported; binary and array
+// fields (PART_FIX, FTR pin arrays, ...) are not. Column names are the
+// lowercase STDF field names, as in the database tables.
+class CsvExporter : public RecordExporter {
+public:
+    // Each record type to <directory>/<type>.csv, created on its first record
+    explicit CsvExporter(const std::string& directory);
+    // Only records of one type, to an open stream such as stdout
+    CsvExporter(FILE* out, RecordType type);
+    ~CsvExporter() override;
+
+    void onFAR(const FARRecord& record) override;
+    void onMIR(const MIRRecord& record) override;
+    void onPIR(const PIRRecord& record) override;
+    void onPRR(const PRRRecord& record) override;
+    void onPTR(const PTRRecord& record) override;
+    void onFTR(const FTRRecord& record) override;
+    void onHBR(const HBRRecord& record) override;
+    void onSBR(const SBRRecord& record) override;
+    void onWIR(const WIRRecord& record) override;
+    void onWRR(const WRRRecord& record) override;
+
+    void finish() override;
+    size_t getRowCount() const override { return rows_; }
+    uint64_t getBytesWritten() const override;
+
+private:
+    struct Table {
+        FILE* file = nullptr;
+        bool owned = false;
+        bool headerWritten = false;
+        std::unique_ptr<ExportBuffer> buffer;
+    };
+
+    std::string directory_;
+    bool singleType_;
+    RecordType type_;
+    std::array<Table, RECORD_TYPE_COUNT> tables_; // Indexed by RecordType
+    size_t rows_;
+
+    Table* table(RecordType type);
+    template <typename Record> void exportRecord(const Record& record);
+};
+
+// Writes every record as one JSON object per line, tagged with its type:
+// {"type":"PTR","test_num":1000,...}. Fields are the same as CsvExporter's.
+// Non-finite floats become null.
+class JsonLinesExporter : public RecordExporter {
+public:
+    explicit JsonLinesExporter(const std::string& path);
+    explicit JsonLinesExporter(FILE* out);
+    ~JsonLinesExporter() override;
+
+    void onFAR(const FARRecord& record) override;
+    void onMIR(const MIRRecord& record) override;
+    void onPIR(const PIRRecord& record) override;
+    void onPRR(const PRRRecord& record) override;
+    void onPTR(const PTRRecord& record) override;
+    void onFTR(const FTRRecord& record) override;
+    void onHBR(const HBRRecord& record) override;
+    void onSBR(const SBRRecord& record) override;
+    void onWIR(const WIRRecord& record) override;
+    void onWRR(const WRRRecord& record) override;
+
+    void finish() override;
+    size_t getRowCount() const override { return rows_; }
+    uint64_t getBytesWritten() const override { return buffer_->getBytesWritten(); }
+
+private:
+    FILE* file_;
+    bool owned_;
+    std::unique_ptr<ExportBuffer> buffer_;
+    size_t rows_;
+
+    template <typename Record> void exportRecord(const Record& record);
+};
+
+} // namespace STDF
+
+#endif // RECORD_EXPORT_H
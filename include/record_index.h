@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Persistent record index for random access into STDF files
+ *              Record offsets, per-type lists and wafer/part byte ranges, saved as a .stdfidx sidecar
+ */
+
+#ifndef RECORD_INDEX_H
+#define RECORD_INDEX_H
+
+#include "stdf_types.h"
+#include <array>
+#include <string>
+#include <vector>
+
+namespace STDF {
+
+class RecordIndex {
+public:
+    // One record of a known type. Ordinals count every known-type record in
+    // the file, whatever record filter the parser has; unknown record types
+    // are not indexed. seekToRecord() takes the same numbering.
+    struct Entry {
+        uint64_t offset;  // Byte offset of the record header
+        RecordType type;
+    };
+
+    // Records from a WIR up to and including its WRR
+    struct WaferRange {
+        U1 headNum;
+        std::string waferId;
+        size_t firstRecord;   // Ordinal of the WIR
+        size_t lastRecord;    // Ordinal of the WRR
+        uint64_t beginOffset; // Offset of the WIR
+        uint64_t endOffset;   // Offset just past the WRR
+    };
+
+    // Records from a PIR up to and including the PRR for the same head/site
+    struct PartRange {
+        U1 headNum;
+        U1 siteNum;
+        size_t firstRecord;   // Ordinal of the PIR
+        size_t lastRecord;    // Ordinal of the PRR
+        uint64_t beginOffset; // Offset of the PIR
+        uint64_t endOffset;   // Offset just past the PRR
+    };
+
+    RecordIndex();
+
+    // Add the next decoded record. headNum/siteNum are only used for PIR, PRR,
+    // WIR and WRR (siteNum is SITE_GRP for wafers); waferId only for WIR.
+    void addRecord(RecordType type, uint64_t offset, uint64_t endOffset,
+                   U1 headNum = 0, U1 siteNum = 0, const std::string& waferId = "");
+    void clear();
+
+    size_t getRecordCount() const { return entries_.size(); }
+    const Entry& getRecord(size_t ordinal) const { return entries_[ordinal]; }
+    const std::vector<size_t>& getRecordsOfType(RecordType type) const;
+    const std::vector<WaferRange>& getWafers() const { return wafers_; }
+    const std::vector<PartRange>& getParts() const { return parts_; }
+
+    // File byte order, so a reader can seek without seeing the FAR first
+    bool isBigEndian() const { return bigEndian_; }
+    void setBigEndian(bool bigEndian) { bigEndian_ = bigEndian; }
+
+    // Sidecar file for an STDF file: "<file>.stdfidx"
+    static std::string sidecarPath(const std::string& stdfFile);
+
+    // Write/read the sidecar. load() fails when the file is missing, corrupt,
+    // or was written for a different size or modification time of stdfFile.
+    bool save(const std::string& stdfFile) const;
+    bool load(const std::string& stdfFile);
+
+    std::string getLastError() const { return lastError_; }
+
+private:
+    std::vector<Entry> entries_;
+    std::array<std::vector<size_t>, RECORD_TYPE_COUNT> byType_; // Indexed by RecordType
+    std::vector<WaferRange> wafers_;
+    std::vector<PartRange> parts_;
+    bool bigEndian_;
+    mutable std::string lastError_;
+
+    // Parts and wafers still waiting for their closing record
+    std::vector<size_t> openParts_;
+    std::vector<size_t> openWafers_;
+};
+
+} // namespace STDF
+
+#endif // RECORD_INDEX_H
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Per-site yield, bin and test-time counts gathered during the parse
+ *              Site-to-site comparison of yield and per-test means
+ */
+
+#ifndef SITE_YIELD_H
+#define SITE_YIELD_H
+
+#include "stdf_parser.h"
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace STDF {
+
+// Count, mean and sum of squared deviations of one test on one site
+struct SiteMoments {
+    uint64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    void add(double value) {
+        count++;
+        double delta = value - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (value - mean);
+    }
+    void merge(const SiteMoments& other);
+};
+
+// Everything counted for one (HEAD_NUM, SITE_NUM)
+struct SiteYield {
+    U1 headNum = 0;
+    U1 siteNum = 0;
+    uint64_t parts = 0;
+    uint64_t passed = 0;          // Parts whose hard bin is a pass bin
+    uint64_t retests = 0;         // PRRs flagged as retests (PART_FLG bits 0-1)
+    uint64_t timedParts = 0;      // Parts with a non-zero TEST_T
+    uint64_t totalTestTime = 0;   // Sum of TEST_T in milliseconds
+    std::vector<uint64_t> hardBins; // Part count indexed by hard bin number
+    std::vector<uint64_t> softBins; // Part count indexed by soft bin number; PRRs
+                                    // without a soft bin (65535) are not counted
+    std::vector<SiteMoments> tests; // Indexed like SiteYieldAccumulator::getTestNumbers()
+
+    double yield() const { return parts > 0 ? static_cast<double>(passed) / static_cast<double>(parts) : 0.0; }
+    double meanTestTime() const {
+        return timedParts > 0 ? static_cast<double>(totalTestTime) / static_cast<double>(timedParts) : 0.0;
+    }
+};
+
+// How far one site's mean of a test sits from the mean over all sites
+struct SiteTestDelta {
+    U4 testNum = 0;
+    U1 headNum = 0;
+    U1 siteNum = 0;
+    uint64_t count = 0;
+    double siteMean = 0.0;
+    double allMean = 0.0;
+    double sigma = 0.0;     // Standard deviation over all sites
+    double delta = 0.0;     // siteMean - allMean
+    double deltaSigma = 0.0; // delta / sigma (0 when sigma is 0)
+};
+
+// Thresholds for flagging outlier sites in the report
+struct SiteComparisonOptions {
+    double yieldZ = 3.0;         // Site yield this many binomial sigmas below the total
+    double meanShiftSigma = 0.5; // |site mean - all-sites mean| in all-sites sigmas
+};
+
+// Record handler that gathers per-site yield, bin distributions, test time
+// and per-test moments from PRRs and PTRs during the parse. Sites live in a
+// flat vector reached through a head/site slot table, and each site keeps
+// its test moments in a vector indexed by test; the test lookup first tries
+// the index after the site's previous test, which matches the usual fixed
+// test order without hashing. Accumulators from other threads or files
+// combine with merge().
+class SiteYieldAccumulator : public RecordHandler {
+public:
+    explicit SiteYieldAccumulator(std::unordered_set<U2> passBins = {1});
+
+    void onPRR(const PRRRecord& record) override;
+    void onPTR(const PTRRecord& record) override;
+
+    void merge(const SiteYieldAccumulator& other);
+
+    // Sites in first-seen order
+    const std::vector<SiteYield>& getSites() const { return sites_; }
+    const SiteYield* find(U1 headNum, U1 siteNum) const;
+    const std::vector<U4>& getTestNumbers() const { return testNums_; }
+    const std::unordered_set<U2>& getPassBins() const { return passBins_; }
+
+    uint64_t totalParts() const;
+    uint64_t totalPassed() const;
+    double yield() const;
+
+    // Binomial z-score of a site's yield against the yield of all sites
+    // together; negative when the site yields worse. 0 when undefined.
+    double yieldZ(const SiteYield& site) const;
+
+    // One entry per test and site with results, ordered by test, head and site
+    std::vector<SiteTestDelta> compareTests() const;
+
+    // Site table (parts, yield, delta to the total, test time, top fail
+    // bins, flag) followed by the per-test mean shifts beyond the threshold
+    void writeReport(std::ostream& out, const SiteComparisonOptions& options = {}) const;
+
+private:
+    // 32-bit slots, since all 65536 head/site pairs can be in use
+    static constexpr uint32_t NO_SLOT = 0xFFFFFFFF;
+
+    std::unordered_set<U2> passBins_;
+    std::vector<uint32_t> slots_;          // head << 8 | site -> position in sites_
+    std::vector<SiteYield> sites_;
+    std::vector<uint32_t> lastTest_;       // Per site: index of its previous PTR's test
+    std::vector<U4> testNums_;             // Test index -> TEST_NUM
+    std::vector<std::string> testTexts_;   // Test index -> first non-empty TEST_TXT
+    std::unordered_map<U4, uint32_t> testIndex_;
+
+    size_t site(U1 headNum, U1 siteNum);
+    uint32_t test(U4 testNum, uint32_t hint);
+};
+
+} // namespace STDF
+
+#endif // SITE_YIELD_H
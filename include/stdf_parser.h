@@ -22,23 +22,96 @@
 #define STDF_PARSER_H
 
 #include "stdf_types.h"
+#include "stdf_views.h"
+#include "record_index.h"
+#include "record_arena.h"
 #include <fstream>
 #include <memory>
 #include <vector>
 
 namespace STDF {
 
+// How the parser reads the underlying file
+enum class InputMode {
+    Stream,       // std::ifstream reads (works for pipes, FUSE mounts, etc.)
+    MemoryMapped  // Decode straight from an mmap()'d view of the whole file
+};
+
+// Receiver for STDFParser::parse(). Each callback gets the parser's reusable
+// record for that type, which is overwritten by the next record of the same
+// type, so copy anything that must outlive the call. Callbacks that are not
+// overridden forward to onRecord(), which ignores the record.
+class RecordHandler {
+public:
+    virtual ~RecordHandler() = default;
+    
+    virtual void onRecord(const STDFRecord& record) { (void)record; }
+    
+    virtual void onFAR(const FARRecord& record) { onRecord(record); }
+    virtual void onMIR(const MIRRecord& record) { onRecord(record); }
+    virtual void onPIR(const PIRRecord& record) { onRecord(record); }
+    virtual void onPRR(const PRRRecord& record) { onRecord(record); }
+    virtual void onPTR(const PTRRecord& record) { onRecord(record); }
+    virtual void onFTR(const FTRRecord& record) { onRecord(record); }
+    virtual void onHBR(const HBRRecord& record) { onRecord(record); }
+    virtual void onSBR(const SBRRecord& record) { onRecord(record); }
+    virtual void onWIR(const WIRRecord& record) { onRecord(record); }
+    virtual void onWRR(const WRRRecord& record) { onRecord(record); }
+};
+
 class STDFParser {
 public:
-    explicit STDFParser(const std::string& filename);
+    explicit STDFParser(const std::string& filename, InputMode mode = InputMode::Stream);
     ~STDFParser();
 
+    STDFParser(const STDFParser&) = delete;
+    STDFParser& operator=(const STDFParser&) = delete;
+
+    // Record header structure
+    struct RecordHeader {
+        U2 length;     // Record length (excluding length field)
+        U1 recordType; // Record type
+        U1 recordSub;  // Record subtype
+    };
+    
+    // Where a record lives in the file, as found by scanRecords()
+    struct RecordLocation {
+        size_t offset;       // Byte offset of the record header
+        RecordHeader header;
+    };
+
     // Parse the entire STDF file and return all records
     std::vector<std::unique_ptr<STDFRecord>> parseFile();
     
+    // Whole-file load without per-record heap allocations: each record body is
+    // read into the arena and decoded into a view that is also created there.
+    // The views stay valid for as long as the arena, independent of the parser.
+    std::vector<const RecordView*> parseFile(RecordArena& arena);
+    
+    // Header-only walk over the whole file that records the offset, type and
+    // length of every complete record without decoding any bodies
+    std::vector<RecordLocation> scanRecords();
+    
+    // Two-phase parse: scanRecords(), then decode contiguous chunks of records
+    // on threadCount threads. Returns exactly what parseFile() returns, in file
+    // order. Non-seekable inputs fall back to parseFile().
+    std::vector<std::unique_ptr<STDFRecord>> parseFileParallel(size_t threadCount);
+    
+    // Push-style streaming over the whole file: every decoded record is passed
+    // to the matching handler callback. One record object per type is reused,
+    // so once string and vector capacities have grown no further allocation
+    // happens. Parse errors stop the walk and are reported by getLastError();
+    // exceptions thrown by the handler propagate. Returns the records delivered.
+    size_t parse(RecordHandler& handler);
+    
     // Parse records one by one (for streaming)
     std::unique_ptr<STDFRecord> parseNextRecord();
     
+    // Zero-copy streaming: decode the next record into a view whose string and
+    // binary fields point into the parser's buffer. Returns nullptr for records
+    // that are not decoded. The view is only valid until the next parse call.
+    const RecordView* parseNextView();
+    
     // Check if end of file reached
     bool isEndOfFile();
     
@@ -46,6 +119,33 @@ public:
     std::string getFilename() const { return filename_; }
     size_t getFileSize() const { return fileSize_; }
     size_t getCurrentPosition();
+    InputMode getInputMode() const { return mode_; }
+    
+    // Random access. The index comes from the .stdfidx sidecar when that is
+    // current for this file; otherwise it is built with one pass over the
+    // headers and written next to the file so later opens skip the scan.
+    // parseFile()/parse() do not build it, so sequential reads pay nothing.
+    const RecordIndex& getIndex();
+    
+    // Position the parser so the next parseNextRecord()/parseNextView() returns
+    // the given record, or the first record of the given wafer (WIR) or part
+    // (PIR). Return false when there is no such record.
+    bool seekToRecord(size_t ordinal);
+    bool seekToWafer(size_t waferIndex);
+    bool seekToWafer(const std::string& waferId);
+    bool seekToPart(size_t partIndex);
+    
+    // Record-type filter. Records whose type is not enabled are skipped
+    // without decoding (long bodies of stream input by seeking over them,
+    // short ones through the stream buffer): nothing is allocated, and
+    // parseNextRecord()/parseNextView() return nullptr for them as they do for
+    // unknown types. All types are enabled by default.
+    void setRecordFilter(const std::vector<RecordType>& types);
+    void clearRecordFilter();
+    bool isRecordTypeEnabled(RecordType type) const;
+    
+    // Error that stopped the last parseFile()/scanRecords() early, if any
+    std::string getLastError() const { return lastError_; }
 
 private:
     // File handling
@@ -53,6 +153,36 @@ private:
     std::ifstream file_;
     size_t fileSize_;
     bool endianSwap_;
+    InputMode mode_;
+    bool seekable_;
+    std::string lastError_;
+    uint32_t recordFilter_; // Bit per RecordType
+    
+    // Record index, loaded on first random access
+    RecordIndex index_;
+    bool indexLoaded_;
+    
+    // Memory-mapped input (InputMode::MemoryMapped only)
+    const uint8_t* mapData_;
+    
+    // Byte offset of the next unread record, tracked without asking the stream
+    size_t position_;
+    
+    // Body of the current record: points into the mapping, or into
+    // recordBuffer_ which is refilled by one bulk read per record
+    std::vector<uint8_t> recordBuffer_;
+    const uint8_t* cursor_;
+    const uint8_t* recordEnd_;
+    
+    void openStream();
+    void openMapped();
+    void rewind();
+    void seekTo(size_t offset);
+    void buildIndex();
+    void fetch(void* dest, size_t count);
+    void loadRecordBody(size_t length);
+    void loadRecordBody(size_t length, RecordArena& arena);
+    void readBytes(void* dest, size_t count);
 
     // Binary data reading helpers
     U1 readU1();
@@ -64,8 +194,11 @@ private:
     R4 readR4();
     R8 readR8();
     C1 readC1();
-    Cn readCn();
-    Bn readBn();
+    void readCn(Cn& out);
+    void readBn(Bn& out);
+    CnView readCnView();
+    BnView readBnView();
+    BnView readRemainingView();
     
     // Record parsing methods
     std::unique_ptr<STDFRecord> parseRecord();
@@ -80,20 +213,71 @@ private:
     std::unique_ptr<WIRRecord> parseWIR();
     std::unique_ptr<WRRRecord> parseWRR();
     
+    // Record decoding into an existing object, shared by parse*() and by the
+    // reusable per-type records of parse(RecordHandler&)
+    void decodeFAR(FARRecord& record);
+    void decodeMIR(MIRRecord& record);
+    void decodePIR(PIRRecord& record);
+    void decodePRR(PRRRecord& record);
+    void decodePTR(PTRRecord& record);
+    void decodeFTR(FTRRecord& record);
+    void decodeHBR(HBRRecord& record);
+    void decodeSBR(SBRRecord& record);
+    void decodeWIR(WIRRecord& record);
+    void decodeWRR(WRRRecord& record);
+    
+    struct RecordSlots {
+        FARRecord far;
+        MIRRecord mir;
+        PIRRecord pir;
+        PRRRecord prr;
+        PTRRecord ptr;
+        FTRRecord ftr;
+        HBRRecord hbr;
+        SBRRecord sbr;
+        WIRRecord wir;
+        WRRRecord wrr;
+    };
+    std::unique_ptr<RecordSlots> records_; // Created on first parse(RecordHandler&)
+    
+    // View decoding into one reusable instance per record type
+    struct ViewSlots {
+        FARView far;
+        MIRView mir;
+        PIRView pir;
+        PRRView prr;
+        PTRView ptr;
+        FTRView ftr;
+        HBRView hbr;
+        SBRView sbr;
+        WIRView wir;
+        WRRView wrr;
+    };
+    ViewSlots views_;
+    
+    void decodeFARView(FARView& view);
+    void decodeMIRView(MIRView& view);
+    void decodePIRView(PIRView& view);
+    void decodePRRView(PRRView& view);
+    void decodePTRView(PTRView& view);
+    void decodeFTRView(FTRView& view);
+    void decodeHBRView(HBRView& view);
+    void decodeSBRView(SBRView& view);
+    void decodeWIRView(WIRView& view);
+    void decodeWRRView(WRRView& view);
+    
+    // Decode the current body into a view allocated in the arena
+    template <typename View>
+    const RecordView* createView(RecordArena& arena, void (STDFParser::*decode)(View&));
+    
     // Utility methods
-    void detectEndianness();
+    void detectEndianness(const U1* rawHeader);
     U2 swapBytes(U2 value);
     U4 swapBytes(U4 value);
     void skipBytes(size_t count);
     
-    // Record header structure
-    struct RecordHeader {
-        U2 length;     // Record length (excluding length field)
-        U1 recordType; // Record type
-        U1 recordSub;  // Record subtype
-    };
-    
     RecordHeader readRecordHeader();
+    static bool lookupRecordType(const RecordHeader& header, RecordType& type);
 };
 
 } // namespace STDF
@@ -70,6 +70,14 @@ enum class RecordType : uint8_t {
     DTR = 24  // Datalog Text Record
 };
 
+// Number of RecordType values, for tables indexed by record type
+constexpr size_t RECORD_TYPE_COUNT = 25;
+
+// Record type mnemonic ("PTR", "PRR", ...) and the reverse lookup, which is
+// case-insensitive and returns false for unknown names
+const char* recordTypeName(RecordType type);
+bool recordTypeFromName(const std::string& name, RecordType& type);
+
 // Base class for all STDF records
 class STDFRecord {
 public:
@@ -165,6 +173,14 @@ struct PRRRecord : public STDFRecord {
     size_t getSize() const override;
 };
 
+// PTR OPT_FLAG bits: which optional fields follow OPT_FLAG in the record
+constexpr U1 PTR_OPT_RES_SCAL = 0x01; // RES_SCAL
+constexpr U1 PTR_OPT_LO_LIMIT = 0x06; // LLM_SCAL, LO_LIMIT
+constexpr U1 PTR_OPT_HI_LIMIT = 0x18; // HLM_SCAL, HI_LIMIT
+constexpr U1 PTR_OPT_UNITS    = 0x20; // UNITS
+constexpr U1 PTR_OPT_RES_FMT  = 0x40; // C_RESFMT
+constexpr U1 PTR_OPT_LIM_FMT  = 0x80; // C_LLMFMT, C_HLMFMT
+
 // Parametric Test Record (PTR)
 struct PTRRecord : public STDFRecord {
     U4 TEST_NUM;   // Test number
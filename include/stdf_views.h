@@ -0,0 +1,364 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Zero-copy STDF record views
+ *              Non-owning record types whose variable-length fields point into the parser's buffer
+ */
+
+#ifndef STDF_VIEWS_H
+#define STDF_VIEWS_H
+
+#include "stdf_types.h"
+#include <cstring>
+#include <string_view>
+
+namespace STDF {
+
+// Variable length character string, borrowed from the parser's buffer
+using CnView = std::string_view;
+
+// Variable length binary data, borrowed from the parser's buffer
+struct BnView {
+    const U1* data = nullptr;
+    size_t size = 0;
+
+    bool empty() const { return size == 0; }
+    Bn toBn() const { return Bn(data, data + size); }
+};
+
+// Array of U2 values left in file byte order; elements are decoded on access
+class U2ArrayView {
+public:
+    U2ArrayView() : data_(nullptr), count_(0), swap_(false) {}
+    U2ArrayView(const U1* data, size_t count, bool swap) : data_(data), count_(count), swap_(swap) {}
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    U2 operator[](size_t i) const {
+        U2 value;
+        std::memcpy(&value, data_ + i * sizeof(U2), sizeof(U2));
+        return swap_ ? static_cast<U2>((value << 8) | (value >> 8)) : value;
+    }
+
+    std::vector<U2> toVector() const {
+        std::vector<U2> values(count_);
+        for (size_t i = 0; i < count_; ++i) {
+            values[i] = (*this)[i];
+        }
+        return values;
+    }
+
+private:
+    const U1* data_;
+    size_t count_;
+    bool swap_;
+};
+
+// Bounded reader over record bytes, used by the lazy view accessors. Like the
+// parser, reads past the end return zero or empty.
+class FieldReader {
+public:
+    FieldReader(const U1* begin, const U1* end, bool swap) : cursor_(begin), end_(end), swap_(swap) {}
+
+    U1 u1() { return cursor_ < end_ ? *cursor_++ : 0; }
+    I1 i1() { return static_cast<I1>(u1()); }
+
+    U2 u2() {
+        U2 value = 0;
+        take(&value, sizeof(value));
+        return swap_ ? static_cast<U2>((value << 8) | (value >> 8)) : value;
+    }
+
+    U4 u4() {
+        U4 value = 0;
+        take(&value, sizeof(value));
+        return swap_ ? __builtin_bswap32(value) : value;
+    }
+
+    R4 r4() {
+        U4 bits = u4();
+        R4 value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    CnView cn() {
+        size_t count = clamp(u1());
+        CnView result(reinterpret_cast<const char*>(cursor_), count);
+        cursor_ += count;
+        return result;
+    }
+
+    BnView bn() {
+        BnView result;
+        result.size = clamp(u2());
+        result.data = cursor_;
+        cursor_ += result.size;
+        return result;
+    }
+
+    U2ArrayView u2Array(size_t count) {
+        size_t available = static_cast<size_t>(end_ - cursor_) / sizeof(U2);
+        if (count > available) {
+            count = available;
+        }
+        U2ArrayView result(cursor_, count, swap_);
+        cursor_ += count * sizeof(U2);
+        return result;
+    }
+
+    void skip(size_t count) { cursor_ += clamp(count); }
+
+private:
+    const U1* cursor_;
+    const U1* end_;
+    bool swap_;
+
+    size_t clamp(size_t count) const {
+        size_t available = static_cast<size_t>(end_ - cursor_);
+        return count < available ? count : available;
+    }
+
+    void take(void* dest, size_t count) {
+        size_t available = clamp(count);
+        std::memcpy(dest, cursor_, available);
+        cursor_ += available;
+    }
+};
+
+// Base for all record views. Views are produced by STDFParser::parseNextView()
+// and, like the buffer they point into, are only valid until the next record is
+// read. Dispatch on `type` and static_cast to the matching view struct.
+struct RecordView {
+    RecordType type;
+
+    explicit RecordView(RecordType t) : type(t) {}
+};
+
+struct FARView : RecordView {
+    FARView() : RecordView(RecordType::FAR) {}
+
+    U1 CPU_TYP = 0;
+    U1 STDF_VER = 0;
+};
+
+struct MIRView : RecordView {
+    MIRView() : RecordView(RecordType::MIR) {}
+
+    U4 SETUP_T = 0;
+    U4 START_T = 0;
+    U1 STAT_NUM = 0;
+    C1 MODE_COD = ' ';
+    C1 RTST_COD = ' ';
+    C1 PROT_COD = ' ';
+    U2 BURN_TIM = 0;
+    C1 CMOD_COD = ' ';
+    CnView LOT_ID;
+    CnView PART_TYP;
+    CnView NODE_NAM;
+    CnView TSTR_TYP;
+    CnView JOB_NAM;
+    CnView JOB_REV;
+    CnView SBLOT_ID;
+    CnView OPER_NAM;
+    CnView EXEC_TYP;
+    CnView EXEC_VER;
+    CnView TEST_COD;
+    CnView TST_TEMP;
+    CnView USER_TXT;
+    CnView AUX_FILE;
+    CnView PKG_TYP;
+    CnView FAMLY_ID;
+    CnView DATE_COD;
+    CnView FACIL_ID;
+    CnView FLOOR_ID;
+    CnView PROC_ID;
+    CnView OPER_FRQ;
+    CnView SPEC_NAM;
+    CnView SPEC_VER;
+    CnView FLOW_ID;
+    CnView SETUP_ID;
+    CnView DSGN_REV;
+    CnView ENG_ID;
+    CnView ROM_COD;
+    CnView SERL_NUM;
+    CnView SUPR_NAM;
+};
+
+struct PIRView : RecordView {
+    PIRView() : RecordView(RecordType::PIR) {}
+
+    U1 HEAD_NUM = 0;
+    U1 SITE_NUM = 0;
+};
+
+struct PRRView : RecordView {
+    PRRView() : RecordView(RecordType::PRR) {}
+
+    U1 HEAD_NUM = 0;
+    U1 SITE_NUM = 0;
+    U1 PART_FLG = 0;
+    U2 NUM_TEST = 0;
+    U2 HARD_BIN = 0;
+    U2 SOFT_BIN = 0;
+    I2 X_COORD = 0;
+    I2 Y_COORD = 0;
+    U4 TEST_T = 0;
+    CnView PART_ID;
+    CnView PART_TXT;
+    BnView PART_FIX;
+};
+
+// Limits that follow OPT_FLAG in a PTR. The has* flags say whether the file
+// carried each limit; absent values are zero.
+struct PTRLimits {
+    bool hasLow = false;
+    bool hasHigh = false;
+    I1 LLM_SCAL = 0;
+    I1 HLM_SCAL = 0;
+    R4 LO_LIMIT = 0.0f;
+    R4 HI_LIMIT = 0.0f;
+};
+
+// PTR with the fixed prefix decoded. The fields behind OPT_FLAG stay in
+// file byte order and are decoded by the accessors, each time they are called.
+struct PTRView : RecordView {
+    PTRView() : RecordView(RecordType::PTR) {}
+
+    U4 TEST_NUM = 0;
+    U1 HEAD_NUM = 0;
+    U1 SITE_NUM = 0;
+    U1 TEST_FLG = 0;
+    U1 PARM_FLG = 0;
+    R4 RESULT = 0.0f;
+    CnView TEST_TXT;
+    CnView ALARM_ID;
+    U1 OPT_FLAG = 0;
+
+    // Undecoded bytes after OPT_FLAG
+    BnView optionalData;
+    bool swap = false;
+
+    I1 resScale() const;
+    PTRLimits limits() const;
+    CnView units() const;
+    CnView resultFormat() const;
+    CnView lowLimitFormat() const;
+    CnView highLimitFormat() const;
+
+private:
+    // Reader positioned after the optional fields selected by bits in skip
+    FieldReader optionalFieldsAfter(U1 skip) const;
+};
+
+// FTR with the fixed prefix (TEST_NUM to PGM_ICNT) decoded. The arrays and the
+// variable-length fields after them are located and decoded by the accessors.
+struct FTRView : RecordView {
+    FTRView() : RecordView(RecordType::FTR) {}
+
+    U4 TEST_NUM = 0;
+    U1 HEAD_NUM = 0;
+    U1 SITE_NUM = 0;
+    U1 TEST_FLG = 0;
+    U1 OPT_FLAG = 0;
+    U4 CYCL_CNT = 0;
+    U4 REL_VADR = 0;
+    U4 REPT_CNT = 0;
+    U4 NUM_FAIL = 0;
+    I4 XFAIL_AD = 0;
+    I4 YFAIL_AD = 0;
+    I2 VECT_OFF = 0;
+    U2 RTN_ICNT = 0;
+    U2 PGM_ICNT = 0;
+
+    // Undecoded bytes after PGM_ICNT
+    BnView variableData;
+    bool swap = false;
+
+    U2ArrayView rtnIndex() const;
+    U2ArrayView rtnStat() const;
+    U2ArrayView pgmIndex() const;
+    U2ArrayView pgmStat() const;
+    BnView failPin() const;
+    CnView vectName() const;
+    CnView timeSet() const;
+    CnView opCode() const;
+    CnView testText() const;
+    CnView alarmId() const;
+    CnView progText() const;
+    CnView resultText() const;
+    U1 patternNumber() const;
+    BnView spinMap() const;
+
+private:
+    // Reader positioned at the given field after the arrays (0 = FAIL_PIN)
+    FieldReader afterArrays(int field) const;
+};
+
+struct HBRView : RecordView {
+    HBRView() : RecordView(RecordType::HBR) {}
+
+    U1 HEAD_NUM = 0;
+    U1 SITE_NUM = 0;
+    U2 HBIN_NUM = 0;
+    U4 HBIN_CNT = 0;
+    C1 HBIN_PF = ' ';
+    CnView HBIN_NAM;
+};
+
+struct SBRView : RecordView {
+    SBRView() : RecordView(RecordType::SBR) {}
+
+    U1 HEAD_NUM = 0;
+    U1 SITE_NUM = 0;
+    U2 SBIN_NUM = 0;
+    U4 SBIN_CNT = 0;
+    C1 SBIN_PF = ' ';
+    CnView SBIN_NAM;
+};
+
+struct WIRView : RecordView {
+    WIRView() : RecordView(RecordType::WIR) {}
+
+    U1 HEAD_NUM = 0;
+    U1 SITE_GRP = 0;
+    U4 START_T = 0;
+    CnView WAFER_ID;
+};
+
+struct WRRView : RecordView {
+    WRRView() : RecordView(RecordType::WRR) {}
+
+    U1 HEAD_NUM = 0;
+    U1 SITE_GRP = 0;
+    U4 FINISH_T = 0;
+    U4 PART_CNT = 0;
+    U4 RTST_CNT = 0;
+    U4 ABRT_CNT = 0;
+    U4 GOOD_CNT = 0;
+    U4 FUNC_CNT = 0;
+    CnView WAFER_ID;
+    CnView FABWF_ID;
+    CnView FRAME_ID;
+    CnView MASK_ID;
+    CnView USR_DESC;
+    CnView EXC_DESC;
+};
+
+} // namespace STDF
+
+#endif // STDF_VIEWS_H
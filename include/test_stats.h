@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Streaming per-test parametric statistics
+ *              Welford moments, pass/fail counts and Cp/Cpk per test and site
+ */
+
+#ifndef TEST_STATS_H
+#define TEST_STATS_H
+
+#include "stdf_parser.h"
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace STDF {
+
+// PTR TEST_FLG bits used by the statistics
+constexpr U1 PTR_FLG_RESULT_INVALID = 0x02; // RESULT is not valid
+constexpr U1 PTR_FLG_NOT_EXECUTED   = 0x10; // Test was not executed
+constexpr U1 PTR_FLG_NO_PASS_FAIL   = 0x40; // No pass/fail indication
+constexpr U1 PTR_FLG_FAILED         = 0x80; // Test failed
+
+// Running statistics of one test on one head/site
+struct TestStats {
+    U4 testNum = 0;
+    U1 headNum = 0;
+    U1 siteNum = 0;
+    std::string testText; // First non-empty TEST_TXT
+    std::string units;    // First non-empty UNITS
+
+    uint64_t count = 0;   // Valid results included in the moments
+    uint64_t passed = 0;
+    uint64_t failed = 0;
+    uint64_t invalid = 0; // Not executed or RESULT flagged invalid
+    double mean = 0.0;
+    double m2 = 0.0;      // Sum of squared deviations from the mean
+    double min = 0.0;
+    double max = 0.0;
+
+    bool hasLoLimit = false;
+    bool hasHiLimit = false;
+    double loLimit = 0.0;
+    double hiLimit = 0.0;
+
+    // Welford update with one result
+    void add(double value) {
+        count++;
+        double delta = value - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (value - mean);
+        if (count == 1 || value < min) min = value;
+        if (count == 1 || value > max) max = value;
+    }
+
+    // Combine with statistics of the same test gathered elsewhere (another
+    // file or thread), as if all results had been added here
+    void merge(const TestStats& other);
+
+    double variance() const { return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0; }
+    double stddev() const;
+
+    // Process capability against the test limits. NaN when a needed limit is
+    // missing or the results have no spread; Cpk uses whichever limits exist.
+    double cp() const;
+    double cpk() const;
+};
+
+// Record handler that keeps TestStats per (TEST_NUM, HEAD_NUM, SITE_NUM)
+// straight from parsed PTRs, without a database. STDF only requires the first
+// PTR of a test to carry its limits, so a new site entry starts with the last
+// limits seen for the same test number.
+class TestStatsAccumulator : public RecordHandler {
+public:
+    void onPTR(const PTRRecord& record) override { add(record); }
+
+    void add(const PTRRecord& record);
+
+    // Fold in the statistics of another accumulator
+    void merge(const TestStatsAccumulator& other);
+
+    // All entries ordered by test number, head and site
+    std::vector<TestStats> getResults() const;
+    size_t size() const { return stats_.size(); }
+    void clear();
+
+    // Fixed-width text table with one row per test and site
+    static void writeReport(std::ostream& out, const std::vector<TestStats>& results);
+
+private:
+    struct Limits {
+        bool hasLo = false;
+        bool hasHi = false;
+        double lo = 0.0;
+        double hi = 0.0;
+    };
+
+    std::vector<TestStats> stats_;
+    std::unordered_map<uint64_t, size_t> index_;  // Key -> position in stats_
+    std::unordered_map<U4, Limits> limits_;       // Last limits per test number
+
+    static uint64_t key(U4 testNum, U1 headNum, U1 siteNum) {
+        return (static_cast<uint64_t>(testNum) << 16) | (static_cast<uint64_t>(headNum) << 8) | siteNum;
+    }
+
+    TestStats& entry(U4 testNum, U1 headNum, U1 siteNum);
+};
+
+} // namespace STDF
+
+#endif // TEST_STATS_H
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Dense wafer maps built from PRR die coordinates
+ *              PGM/PPM rendering and a compact binary form
+ */
+
+#ifndef WAFER_MAP_H
+#define WAFER_MAP_H
+
+#include "stdf_parser.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace STDF {
+
+// Dense die grid of one wafer covering the bounding box of its PRR
+// coordinates. Cells are stored row-major (y, then x) as hard and soft bin
+// numbers; cells without a die hold NO_DIE.
+class WaferMap {
+public:
+    static constexpr U2 NO_DIE = 0xFFFF;
+
+    std::string waferId;
+    U1 headNum = 0;
+    I2 minX = 0;
+    I2 minY = 0;
+    U2 width = 0;
+    U2 height = 0;
+    U4 dieCount = 0;
+    std::vector<U2> hardBins;
+    std::vector<U2> softBins;
+
+    bool contains(int x, int y) const {
+        return x >= minX && y >= minY && x < minX + width && y < minY + height;
+    }
+    size_t cell(int x, int y) const {
+        return static_cast<size_t>(y - minY) * width + static_cast<size_t>(x - minX);
+    }
+    // NO_DIE outside the grid or where no die was tested
+    U2 hardBin(int x, int y) const { return contains(x, y) ? hardBins[cell(x, y)] : NO_DIE; }
+    U2 softBin(int x, int y) const { return contains(x, y) ? softBins[cell(x, y)] : NO_DIE; }
+
+    // Pass/fail image (8-bit PGM): pass dies white, failing dies grey, no die
+    // black. `scale` is the size of a die in pixels. Throws std::runtime_error
+    // on I/O errors, like the other writers below.
+    void writePGM(const std::string& path, const std::unordered_set<U2>& passBins = {1},
+                  bool softBin = false, unsigned scale = 4) const;
+
+    // Bin image (PPM): pass bins green, other bins from a fixed palette keyed
+    // by bin number, no die dark grey
+    void writePPM(const std::string& path, const std::unordered_set<U2>& passBins = {1},
+                  bool softBin = false, unsigned scale = 4) const;
+
+    // Little-endian binary form: magic, head, wafer ID, bounding box, die
+    // count, then both bin grids
+    std::vector<uint8_t> serialize() const;
+    static WaferMap deserialize(const std::vector<uint8_t>& data);
+    void save(const std::string& path) const;
+    static WaferMap load(const std::string& path);
+};
+
+// Record handler that builds one WaferMap per WIR/WRR pair in a single pass.
+// PRRs between a head's WIR and WRR are collected as compact die entries; the
+// grid is sized and filled when the WRR arrives. A retested die keeps its
+// last result. PRRs without coordinates (-32768) are ignored, and PRRs
+// outside any WIR go to a map with an empty wafer ID.
+class WaferMapBuilder : public RecordHandler {
+public:
+    // Largest grid (width * height) a wafer may have; wafers with wilder
+    // coordinates are skipped with a warning
+    static constexpr size_t MAX_CELLS = size_t{1} << 24;
+
+    void onWIR(const WIRRecord& record) override;
+    void onPRR(const PRRRecord& record) override;
+    void onWRR(const WRRRecord& record) override;
+
+    // Build maps for wafers still open (no WRR), e.g. at the end of a file
+    void finish();
+
+    const std::vector<WaferMap>& getMaps() const { return maps_; }
+    std::vector<WaferMap> takeMaps();
+
+private:
+    struct Die {
+        I2 x;
+        I2 y;
+        U2 hardBin;
+        U2 softBin;
+    };
+
+    struct OpenWafer {
+        std::string waferId;
+        std::vector<Die> dies;
+    };
+
+    std::unordered_map<U1, OpenWafer> open_; // By HEAD_NUM
+    std::vector<WaferMap> maps_;
+
+    void build(U1 headNum, OpenWafer& wafer);
+};
+
+// Maps of every wafer in one STDF file, open wafers included. Throws
+// std::runtime_error when the file stops parsing early, as its last wafer
+// would otherwise come back looking complete.
+std::vector<WaferMap> loadWaferMaps(const std::string& path, InputMode mode = InputMode::Stream);
+
+} // namespace STDF
+
+#endif // WAFER_MAP_H
@@ -0,0 +1,485 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Multi-file ingest with a worker thread pool
+ *              Input expansion and parallel parsing with per-file atomic commits
+ */
+
+#include "batch_ingest.h"
+#include "logger.h"
+#include "spsc_ring.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <glob.h>
+#include <numeric>
+#include <set>
+#include <thread>
+
+namespace STDF {
+
+namespace {
+
+bool hasStdfExtension(const std::filesystem::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext == ".stdf" || ext == ".std";
+}
+
+void addPath(const std::string& path, std::set<std::string>& files) {
+    std::error_code ec;
+    if (std::filesystem::is_directory(path, ec)) {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(path, ec)) {
+            if (entry.is_regular_file(ec) && hasStdfExtension(entry.path())) {
+                files.insert(entry.path().string());
+            }
+        }
+    } else {
+        files.insert(path);
+    }
+}
+
+// Streams records from STDFParser::parse() into the open transaction
+class InsertHandler : public RecordHandler {
+public:
+    InsertHandler(Database& database, FileIngestResult& result, bool verbose)
+        : database_(database), result_(result), verbose_(verbose) {}
+
+    void onRecord(const STDFRecord& record) override {
+        result_.recordCount++;
+
+        if (verbose_ && result_.recordCount % 1000 == 0) {
+            STDF_LOG_DEBUG << result_.filename << ": processed " << result_.recordCount << " records...";
+        }
+        if (verbose_ && result_.recordCount <= 10) {
+            STDF_LOG_DEBUG << "Record " << result_.recordCount << ": " << record.toString();
+        }
+
+        if (!database_.insertRecord(record)) {
+            throw std::runtime_error("Failed to insert record " + std::to_string(result_.recordCount) +
+                                     ": " + database_.getLastError());
+        }
+        result_.insertedCount++;
+    }
+
+private:
+    Database& database_;
+    FileIngestResult& result_;
+    bool verbose_;
+};
+
+// Records handed from the parser thread to the writer in one ring slot
+const size_t PIPELINE_BATCH_RECORDS = 4096;
+const size_t PIPELINE_RING_SLOTS = 16;
+
+// Wait step for a full or empty ring: yield a few times, then sleep so a
+// stage that is far ahead does not burn a core
+void backoff(unsigned& spins) {
+    if (++spins < 64) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+std::vector<std::string> expandInputPaths(const std::vector<std::string>& inputs) {
+    std::set<std::string> files;
+
+    for (const auto& input : inputs) {
+        if (input.find_first_of("*?[") == std::string::npos) {
+            addPath(input, files);
+            continue;
+        }
+
+        glob_t matches;
+        if (glob(input.c_str(), 0, nullptr, &matches) == 0) {
+            for (size_t i = 0; i < matches.gl_pathc; ++i) {
+                addPath(matches.gl_pathv[i], files);
+            }
+        } else {
+            STDF_LOG_WARNING << "No files match pattern: " << input;
+        }
+        globfree(&matches);
+    }
+
+    return std::vector<std::string>(files.begin(), files.end());
+}
+
+void PipelineStageTimes::add(const PipelineStageTimes& other) {
+    parseBusySeconds += other.parseBusySeconds;
+    parseIdleSeconds += other.parseIdleSeconds;
+    writeBusySeconds += other.writeBusySeconds;
+    writeIdleSeconds += other.writeIdleSeconds;
+    batches += other.batches;
+}
+
+double BatchIngestSummary::recordsPerSecond() const {
+    return elapsedSeconds > 0.0 ? totalRecords / elapsedSeconds : 0.0;
+}
+
+double BatchIngestSummary::megabytesPerSecond() const {
+    return elapsedSeconds > 0.0 ? (totalBytes / (1024.0 * 1024.0)) / elapsedSeconds : 0.0;
+}
+
+BatchIngest::BatchIngest(Database& database, size_t workerCount, InputMode mode)
+    : database_(database), workerCount_(workerCount > 0 ? workerCount : 1),
+      mode_(mode), verbose_(false), pipelined_(false), decodeThreads_(1),
+      bufferLimit_(DEFAULT_BUFFER_LIMIT), buffered_(0) {
+}
+
+size_t BatchIngest::reserveBuffer(size_t fileSize) {
+    size_t bytes = std::min(fileSize, bufferLimit_);
+    std::unique_lock<std::mutex> lock(bufferMutex_);
+    bufferReleased_.wait(lock, [&]() { return buffered_ + bytes <= bufferLimit_; });
+    buffered_ += bytes;
+    return bytes;
+}
+
+void BatchIngest::releaseBuffer(size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex_);
+        buffered_ -= bytes;
+    }
+    bufferReleased_.notify_all();
+}
+
+BatchIngestSummary BatchIngest::run(const std::vector<std::string>& files) {
+    BatchIngestSummary summary;
+    summary.files.resize(files.size());
+
+    for (size_t i = 0; i < files.size(); ++i) {
+        summary.files[i].filename = files[i];
+        std::error_code ec;
+        auto size = std::filesystem::file_size(files[i], ec);
+        summary.files[i].fileSize = ec ? 0 : static_cast<size_t>(size);
+    }
+
+    // Largest files first so the long poles start immediately
+    std::vector<size_t> order(files.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return summary.files[a].fileSize > summary.files[b].fileSize;
+    });
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Threads left over when there are fewer files than workers go to
+    // decoding chunks of each file in parallel
+    size_t workers = std::min(workerCount_, files.size());
+    decodeThreads_ = workers > 0 ? workerCount_ / workers : 1;
+    if (workerCount_ <= 1) {
+        for (size_t index : order) {
+            if (pipelined_) {
+                ingestPipelined(summary.files[index]);
+            } else {
+                ingestStreaming(summary.files[index]);
+            }
+        }
+    } else {
+        std::atomic<size_t> next(0);
+        std::vector<std::thread> pool;
+        for (size_t w = 0; w < workers; ++w) {
+            pool.emplace_back([&]() {
+                for (size_t job = next++; job < order.size(); job = next++) {
+                    ingestBuffered(summary.files[order[job]]);
+                }
+            });
+        }
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+
+    auto endTime = std::chrono::steady_clock::now();
+    summary.elapsedSeconds = std::chrono::duration<double>(endTime - startTime).count();
+
+    for (const auto& result : summary.files) {
+        summary.totalRecords += result.recordCount;
+        summary.totalInserted += result.insertedCount;
+        summary.totalBytes += result.fileSize;
+        summary.pipeline.add(result.pipeline);
+        if (!result.committed) {
+            summary.filesFailed++;
+        }
+    }
+
+    return summary;
+}
+
+void BatchIngest::ingestStreaming(FileIngestResult& result) {
+    if (!beginFileTransaction(result)) {
+        return;
+    }
+
+    try {
+        STDFParser parser(result.filename, mode_);
+        if (!recordTypes_.empty()) {
+            parser.setRecordFilter(recordTypes_);
+        }
+
+        InsertHandler handler(database_, result, verbose_);
+        parser.parse(handler);
+        if (!parser.getLastError().empty()) {
+            throw std::runtime_error(parser.getLastError());
+        }
+    } catch (const std::exception& e) {
+        result.error = e.what();
+        result.insertedCount = 0;
+        database_.rollbackTransaction();
+        STDF_LOG_ERROR << result.filename << ": " << result.error << " (rolled back)";
+        return;
+    }
+
+    if (!database_.commitTransaction()) {
+        result.error = "Failed to commit transaction: " + database_.getLastError();
+        result.insertedCount = 0;
+        database_.rollbackTransaction();
+        STDF_LOG_ERROR << result.filename << ": " << result.error;
+        return;
+    }
+
+    result.committed = true;
+    STDF_LOG_INFO << "Loaded " << result.filename << ": " << result.insertedCount << " records";
+}
+
+void BatchIngest::ingestPipelined(FileIngestResult& result) {
+    if (!beginFileTransaction(result)) {
+        return;
+    }
+
+    using Batch = std::vector<std::unique_ptr<STDFRecord>>;
+    SpscRing<Batch> ring(PIPELINE_RING_SLOTS);
+    std::atomic<bool> writerFailed(false);
+    std::string parseError;
+    PipelineStageTimes& times = result.pipeline;
+
+    // Producer: decode batches and push them, waiting while the ring is full.
+    // Stops early if the writer gives up so it never blocks on a dead consumer.
+    std::thread parserThread([&]() {
+        auto start = std::chrono::steady_clock::now();
+        double idle = 0.0;
+        try {
+            STDFParser parser(result.filename, mode_);
+            if (!recordTypes_.empty()) {
+                parser.setRecordFilter(recordTypes_);
+            }
+
+            Batch batch;
+            batch.reserve(PIPELINE_BATCH_RECORDS);
+            bool endOfFile = false;
+            while (!endOfFile && !writerFailed.load(std::memory_order_relaxed)) {
+                auto record = parser.parseNextRecord();
+                if (record) {
+                    batch.push_back(std::move(record));
+                }
+                endOfFile = parser.isEndOfFile();
+                bool flush = batch.size() >= PIPELINE_BATCH_RECORDS || (endOfFile && !batch.empty());
+                if (!flush) {
+                    continue;
+                }
+
+                auto waitStart = std::chrono::steady_clock::now();
+                unsigned spins = 0;
+                while (!ring.tryPush(batch) && !writerFailed.load(std::memory_order_relaxed)) {
+                    backoff(spins);
+                }
+                idle += secondsSince(waitStart);
+                batch = Batch();
+                batch.reserve(PIPELINE_BATCH_RECORDS);
+            }
+            if (!parser.getLastError().empty()) {
+                parseError = parser.getLastError();
+            }
+        } catch (const std::exception& e) {
+            parseError = e.what();
+        }
+        times.parseIdleSeconds = idle;
+        times.parseBusySeconds = secondsSince(start) - idle;
+        ring.close();
+    });
+
+    // Consumer: drain the ring into the open transaction until the parser has
+    // closed it and every pushed batch is written
+    auto start = std::chrono::steady_clock::now();
+    double idle = 0.0;
+    Batch batch;
+    while (true) {
+        if (!ring.tryPop(batch)) {
+            if (ring.isDrained()) {
+                break;
+            }
+            auto waitStart = std::chrono::steady_clock::now();
+            unsigned spins = 0;
+            bool popped = false;
+            while (!(popped = ring.tryPop(batch)) && !ring.isDrained()) {
+                backoff(spins);
+            }
+            idle += secondsSince(waitStart);
+            if (!popped) {
+                break;
+            }
+        }
+
+        result.recordCount += batch.size();
+        times.batches++;
+        if (verbose_) {
+            STDF_LOG_DEBUG << result.filename << ": processed " << result.recordCount << " records...";
+        }
+        if (!insertRecords(batch, result)) {
+            writerFailed.store(true, std::memory_order_relaxed);
+            break;
+        }
+    }
+    parserThread.join();
+    times.writeIdleSeconds = idle;
+    times.writeBusySeconds = secondsSince(start) - idle;
+
+    if (result.error.empty() && !parseError.empty()) {
+        result.error = parseError;
+    }
+    if (!result.error.empty()) {
+        result.insertedCount = 0;
+        database_.rollbackTransaction();
+        STDF_LOG_ERROR << result.filename << ": " << result.error << " (rolled back)";
+        return;
+    }
+
+    if (!database_.commitTransaction()) {
+        result.error = "Failed to commit transaction: " + database_.getLastError();
+        result.insertedCount = 0;
+        database_.rollbackTransaction();
+        STDF_LOG_ERROR << result.filename << ": " << result.error;
+        return;
+    }
+
+    result.committed = true;
+    STDF_LOG_INFO << "Loaded " << result.filename << ": " << result.insertedCount << " records";
+}
+
+void BatchIngest::ingestBuffered(FileIngestResult& result) {
+    // Returned once the records below are freed
+    struct Reservation {
+        BatchIngest& ingest;
+        size_t bytes;
+        ~Reservation() { ingest.releaseBuffer(bytes); }
+    } reservation{*this, reserveBuffer(result.fileSize)};
+    std::vector<std::unique_ptr<STDFRecord>> records;
+
+    try {
+        STDFParser parser(result.filename, mode_);
+        if (!recordTypes_.empty()) {
+            parser.setRecordFilter(recordTypes_);
+        }
+        if (decodeThreads_ > 1) {
+            records = parser.parseFileParallel(decodeThreads_);
+            if (!parser.getLastError().empty()) {
+                throw std::runtime_error(parser.getLastError());
+            }
+        } else {
+            while (!parser.isEndOfFile()) {
+                auto record = parser.parseNextRecord();
+                if (record) {
+                    records.push_back(std::move(record));
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        result.error = e.what();
+        STDF_LOG_ERROR << result.filename << ": " << result.error << " (skipped)";
+        return;
+    }
+
+    result.recordCount = records.size();
+
+    std::lock_guard<std::mutex> lock(databaseMutex_);
+    if (commitRecords(records, result)) {
+        STDF_LOG_INFO << "Loaded " << result.filename << ": " << result.insertedCount << " records";
+    }
+}
+
+bool BatchIngest::commitRecords(const std::vector<std::unique_ptr<STDFRecord>>& records,
+                                FileIngestResult& result) {
+    if (!beginFileTransaction(result)) {
+        return false;
+    }
+
+    if (!insertRecords(records, result)) {
+        result.insertedCount = 0;
+        database_.rollbackTransaction();
+        STDF_LOG_ERROR << result.filename << ": " << result.error << " (rolled back)";
+        return false;
+    }
+
+    if (!database_.commitTransaction()) {
+        result.error = "Failed to commit transaction: " + database_.getLastError();
+        result.insertedCount = 0;
+        database_.rollbackTransaction();
+        STDF_LOG_ERROR << result.filename << ": " << result.error;
+        return false;
+    }
+
+    result.committed = true;
+    return true;
+}
+
+bool BatchIngest::insertRecords(const std::vector<std::unique_ptr<STDFRecord>>& records,
+                                FileIngestResult& result) {
+    // Consecutive records of one type go in as a single multi-row batch
+    std::vector<const STDFRecord*> run;
+    size_t i = 0;
+    while (i < records.size()) {
+        RecordType type = records[i]->getRecordType();
+        run.clear();
+        while (i < records.size() && records[i]->getRecordType() == type) {
+            run.push_back(records[i].get());
+            ++i;
+        }
+        if (!database_.insertBatch(run)) {
+            result.error = "Failed to insert records " + std::to_string(result.insertedCount + 1) +
+                           "-" + std::to_string(result.insertedCount + run.size()) +
+                           ": " + database_.getLastError();
+            return false;
+        }
+        result.insertedCount += run.size();
+    }
+    return true;
+}
+
+bool BatchIngest::beginFileTransaction(FileIngestResult& result) {
+    if (!database_.beginTransaction()) {
+        result.error = "Failed to begin transaction: " + database_.getLastError();
+        STDF_LOG_ERROR << result.filename << ": " << result.error;
+        return false;
+    }
+    if (database_.beginFile(result.filename) < 0) {
+        result.error = "Failed to register file: " + database_.getLastError();
+        database_.rollbackTransaction();
+        STDF_LOG_ERROR << result.filename << ": " << result.error;
+        return false;
+    }
+    return true;
+}
+
+} // namespace STDF
@@ -0,0 +1,582 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Columnar result file writer and memory-mapped reader
+ *              File layout: magic, 8-byte-aligned column blocks, footer, footer offset, magic
+ */
+
+#include "columnar_file.h"
+#include "logger.h"
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace STDF {
+
+namespace {
+
+const char MAGIC[8] = {'S', 'T', 'D', 'F', 'C', 'O', 'L', '1'};
+
+// Trailer: footer offset followed by the magic again
+const size_t TRAILER_SIZE = sizeof(uint64_t) + sizeof(MAGIC);
+
+// Column blocks start on 8-byte boundaries so every span is aligned
+const size_t BLOCK_ALIGNMENT = 8;
+
+// Values are written in host order, which must be little-endian
+bool isLittleEndian() {
+    const uint16_t one = 1;
+    return *reinterpret_cast<const uint8_t*>(&one) == 1;
+}
+
+struct ColumnSchema {
+    const char* name;
+    ColumnType type;
+};
+
+// Column order here is the order the on*() handlers append values in
+const std::vector<ColumnSchema>& columnSchema(RecordType type) {
+    static const std::vector<ColumnSchema> prr = {
+        {"part_index", ColumnType::U32}, {"head_num", ColumnType::U8},
+        {"site_num", ColumnType::U8},    {"part_flg", ColumnType::U8},
+        {"num_test", ColumnType::U16},   {"hard_bin", ColumnType::U16},
+        {"soft_bin", ColumnType::U16},   {"x_coord", ColumnType::I16},
+        {"y_coord", ColumnType::I16},    {"test_t", ColumnType::U32},
+        {"part_id", ColumnType::Dict}};
+    static const std::vector<ColumnSchema> ptr = {
+        {"part_index", ColumnType::U32}, {"test_num", ColumnType::U32},
+        {"head_num", ColumnType::U8},    {"site_num", ColumnType::U8},
+        {"test_flg", ColumnType::U8},    {"parm_flg", ColumnType::U8},
+        {"result", ColumnType::F32},     {"test_txt", ColumnType::Dict}};
+    static const std::vector<ColumnSchema> ftr = {
+        {"part_index", ColumnType::U32}, {"test_num", ColumnType::U32},
+        {"head_num", ColumnType::U8},    {"site_num", ColumnType::U8},
+        {"test_flg", ColumnType::U8}};
+    static const std::vector<ColumnSchema> hbr = {
+        {"head_num", ColumnType::U8},  {"site_num", ColumnType::U8},
+        {"hbin_num", ColumnType::U16}, {"hbin_cnt", ColumnType::U32},
+        {"hbin_pf", ColumnType::U8},   {"hbin_nam", ColumnType::Dict}};
+    static const std::vector<ColumnSchema> sbr = {
+        {"head_num", ColumnType::U8},  {"site_num", ColumnType::U8},
+        {"sbin_num", ColumnType::U16}, {"sbin_cnt", ColumnType::U32},
+        {"sbin_pf", ColumnType::U8},   {"sbin_nam", ColumnType::Dict}};
+
+    switch (type) {
+        case RecordType::PRR: return prr;
+        case RecordType::PTR: return ptr;
+        case RecordType::FTR: return ftr;
+        case RecordType::HBR: return hbr;
+        case RecordType::SBR: return sbr;
+        default: throw std::runtime_error("Record type has no columnar schema");
+    }
+}
+
+size_t columnTypeSize(ColumnType type) {
+    switch (type) {
+        case ColumnType::U8: return 1;
+        case ColumnType::U16:
+        case ColumnType::I16: return 2;
+        case ColumnType::U32:
+        case ColumnType::F32:
+        case ColumnType::Dict: return 4;
+    }
+    return 0;
+}
+
+uint16_t siteKey(U1 headNum, U1 siteNum) {
+    return static_cast<uint16_t>((headNum << 8) | siteNum);
+}
+
+// Appends plain values to the footer buffer
+template <typename T>
+void append(std::vector<uint8_t>& out, T value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void appendString(std::vector<uint8_t>& out, const std::string& value) {
+    append<uint32_t>(out, static_cast<uint32_t>(value.size()));
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+// Bounds-checked cursor over the footer
+class FooterCursor {
+public:
+    FooterCursor(const uint8_t* data, size_t size) : data_(data), size_(size), pos_(0) {}
+
+    template <typename T>
+    T read() {
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return value;
+    }
+
+    std::string readString() {
+        uint32_t length = read<uint32_t>();
+        require(length);
+        std::string value(reinterpret_cast<const char*>(data_ + pos_), length);
+        pos_ += length;
+        return value;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_;
+
+    void require(size_t bytes) const {
+        if (bytes > size_ - pos_) {
+            throw std::runtime_error("Corrupt columnar file: footer is truncated");
+        }
+    }
+};
+
+} // namespace
+
+// === ColumnarWriter ===
+
+ColumnarWriter::ColumnarWriter(const std::string& path, size_t chunkRows)
+    : path_(path), chunkRows_(chunkRows > 0 ? chunkRows : DEFAULT_CHUNK_ROWS),
+      position_(0), finished_(false), partCount_(0) {
+    if (!isLittleEndian()) {
+        throw std::runtime_error("Columnar files are only supported on little-endian hosts");
+    }
+
+    out_.open(path_, std::ios::binary | std::ios::trunc);
+    if (!out_.is_open()) {
+        throw std::runtime_error("Failed to create columnar file: " + path_);
+    }
+    write(MAGIC, sizeof(MAGIC));
+
+    for (RecordType type : {RecordType::PRR, RecordType::PTR, RecordType::FTR,
+                            RecordType::HBR, RecordType::SBR}) {
+        Table t;
+        t.type = type;
+        for (const ColumnSchema& schema : columnSchema(type)) {
+            Column column;
+            column.name = schema.name;
+            column.type = schema.type;
+            column.min = std::numeric_limits<double>::infinity();
+            column.max = -std::numeric_limits<double>::infinity();
+            column.buffer.reserve(chunkRows_ * columnTypeSize(schema.type));
+            t.columns.push_back(std::move(column));
+        }
+        tables_.push_back(std::move(t));
+    }
+}
+
+ColumnarWriter::~ColumnarWriter() {
+    if (!finished_) {
+        try {
+            finish();
+        } catch (const std::exception& e) {
+            STDF_LOG_ERROR << "Failed to finish columnar file " << path_ << ": " << e.what();
+        }
+    }
+}
+
+ColumnarWriter::Table& ColumnarWriter::table(RecordType type) {
+    for (Table& t : tables_) {
+        if (t.type == type) {
+            return t;
+        }
+    }
+    throw std::runtime_error("Record type has no columnar schema");
+}
+
+U4 ColumnarWriter::partIndex(U1 headNum, U1 siteNum) const {
+    auto it = openParts_.find(siteKey(headNum, siteNum));
+    return it != openParts_.end() ? it->second : std::numeric_limits<U4>::max();
+}
+
+template <typename T>
+void ColumnarWriter::put(Column& column, T value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    column.buffer.insert(column.buffer.end(), bytes, bytes + sizeof(T));
+    double v = static_cast<double>(value);
+    if (v < column.min) column.min = v;
+    if (v > column.max) column.max = v;
+}
+
+void ColumnarWriter::putString(Column& column, const std::string& value) {
+    auto it = column.codes.find(value);
+    uint32_t code;
+    if (it != column.codes.end()) {
+        code = it->second;
+    } else {
+        code = static_cast<uint32_t>(column.dictionary.size());
+        column.codes.emplace(value, code);
+        column.dictionary.push_back(value);
+    }
+    put<uint32_t>(column, code);
+}
+
+void ColumnarWriter::endRow(Table& table) {
+    table.rows++;
+    if (++table.chunkFill == chunkRows_) {
+        flushChunk(table);
+    }
+}
+
+void ColumnarWriter::flushChunk(Table& table) {
+    if (table.chunkFill == 0) {
+        return;
+    }
+
+    static const uint8_t padding[BLOCK_ALIGNMENT] = {};
+    for (Column& column : table.columns) {
+        size_t misalignment = position_ % BLOCK_ALIGNMENT;
+        if (misalignment != 0) {
+            write(padding, BLOCK_ALIGNMENT - misalignment);
+        }
+
+        ColumnChunkInfo info;
+        info.offset = position_;
+        info.size = column.buffer.size();
+        info.min = column.min;
+        info.max = column.max;
+        column.chunks.push_back(info);
+        write(column.buffer.data(), column.buffer.size());
+
+        column.buffer.clear();
+        column.min = std::numeric_limits<double>::infinity();
+        column.max = -std::numeric_limits<double>::infinity();
+    }
+    table.chunkRows.push_back(table.chunkFill);
+    table.chunkFill = 0;
+}
+
+void ColumnarWriter::write(const void* data, size_t size) {
+    out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    if (!out_) {
+        throw std::runtime_error("Failed to write columnar file: " + path_);
+    }
+    position_ += size;
+}
+
+void ColumnarWriter::onPIR(const PIRRecord& record) {
+    openParts_[siteKey(record.HEAD_NUM, record.SITE_NUM)] = partCount_++;
+}
+
+void ColumnarWriter::onPRR(const PRRRecord& record) {
+    Table& t = table(RecordType::PRR);
+    std::vector<Column>& c = t.columns;
+    put<U4>(c[0], partIndex(record.HEAD_NUM, record.SITE_NUM));
+    put<U1>(c[1], record.HEAD_NUM);
+    put<U1>(c[2], record.SITE_NUM);
+    put<U1>(c[3], record.PART_FLG);
+    put<U2>(c[4], record.NUM_TEST);
+    put<U2>(c[5], record.HARD_BIN);
+    put<U2>(c[6], record.SOFT_BIN);
+    put<I2>(c[7], record.X_COORD);
+    put<I2>(c[8], record.Y_COORD);
+    put<U4>(c[9], record.TEST_T);
+    putString(c[10], record.PART_ID);
+    endRow(t);
+
+    openParts_.erase(siteKey(record.HEAD_NUM, record.SITE_NUM));
+}
+
+void ColumnarWriter::onPTR(const PTRRecord& record) {
+    Table& t = table(RecordType::PTR);
+    std::vector<Column>& c = t.columns;
+    put<U4>(c[0], partIndex(record.HEAD_NUM, record.SITE_NUM));
+    put<U4>(c[1], record.TEST_NUM);
+    put<U1>(c[2], record.HEAD_NUM);
+    put<U1>(c[3], record.SITE_NUM);
+    put<U1>(c[4], record.TEST_FLG);
+    put<U1>(c[5], record.PARM_FLG);
+    put<R4>(c[6], record.RESULT);
+    putString(c[7], record.TEST_TXT);
+    endRow(t);
+}
+
+void ColumnarWriter::onFTR(const FTRRecord& record) {
+    Table& t = table(RecordType::FTR);
+    std::vector<Column>& c = t.columns;
+    put<U4>(c[0], partIndex(record.HEAD_NUM, record.SITE_NUM));
+    put<U4>(c[1], record.TEST_NUM);
+    put<U1>(c[2], record.HEAD_NUM);
+    put<U1>(c[3], record.SITE_NUM);
+    put<U1>(c[4], record.TEST_FLG);
+    endRow(t);
+}
+
+void ColumnarWriter::onHBR(const HBRRecord& record) {
+    Table& t = table(RecordType::HBR);
+    std::vector<Column>& c = t.columns;
+    put<U1>(c[0], record.HEAD_NUM);
+    put<U1>(c[1], record.SITE_NUM);
+    put<U2>(c[2], record.HBIN_NUM);
+    put<U4>(c[3], record.HBIN_CNT);
+    put<U1>(c[4], static_cast<U1>(record.HBIN_PF));
+    putString(c[5], record.HBIN_NAM);
+    endRow(t);
+}
+
+void ColumnarWriter::onSBR(const SBRRecord& record) {
+    Table& t = table(RecordType::SBR);
+    std::vector<Column>& c = t.columns;
+    put<U1>(c[0], record.HEAD_NUM);
+    put<U1>(c[1], record.SITE_NUM);
+    put<U2>(c[2], record.SBIN_NUM);
+    put<U4>(c[3], record.SBIN_CNT);
+    put<U1>(c[4], static_cast<U1>(record.SBIN_PF));
+    putString(c[5], record.SBIN_NAM);
+    endRow(t);
+}
+
+void ColumnarWriter::finish() {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+
+    for (Table& t : tables_) {
+        flushChunk(t);
+    }
+
+    // Footer: tables with rows, their chunk row counts, then per column the
+    // name, type, one block descriptor per chunk and the dictionary
+    std::vector<uint8_t> footer;
+    uint32_t tableCount = 0;
+    for (const Table& t : tables_) {
+        if (t.rows > 0) tableCount++;
+    }
+    append<uint32_t>(footer, tableCount);
+
+    for (const Table& t : tables_) {
+        if (t.rows == 0) {
+            continue;
+        }
+        append<uint8_t>(footer, static_cast<uint8_t>(t.type));
+        append<uint64_t>(footer, t.rows);
+        append<uint32_t>(footer, static_cast<uint32_t>(t.chunkRows.size()));
+        for (uint64_t rows : t.chunkRows) {
+            append<uint64_t>(footer, rows);
+        }
+        append<uint32_t>(footer, static_cast<uint32_t>(t.columns.size()));
+        for (const Column& column : t.columns) {
+            appendString(footer, column.name);
+            append<uint8_t>(footer, static_cast<uint8_t>(column.type));
+            for (const ColumnChunkInfo& info : column.chunks) {
+                append<uint64_t>(footer, info.offset);
+                append<uint64_t>(footer, info.size);
+                append<double>(footer, info.min);
+                append<double>(footer, info.max);
+            }
+            append<uint32_t>(footer, static_cast<uint32_t>(column.dictionary.size()));
+            for (const std::string& value : column.dictionary) {
+                appendString(footer, value);
+            }
+        }
+    }
+
+    uint64_t footerOffset = position_;
+    write(footer.data(), footer.size());
+    write(&footerOffset, sizeof(footerOffset));
+    write(MAGIC, sizeof(MAGIC));
+
+    out_.close();
+    if (out_.fail()) {
+        throw std::runtime_error("Failed to close columnar file: " + path_);
+    }
+    STDF_LOG_INFO << "Wrote columnar file " << path_ << " (" << position_ << " bytes)";
+}
+
+size_t ColumnarWriter::getRowCount(RecordType type) const {
+    for (const Table& t : tables_) {
+        if (t.type == type) {
+            return t.rows;
+        }
+    }
+    return 0;
+}
+
+// === ColumnarReader ===
+
+ColumnarReader::ColumnarReader(const std::string& path) : data_(nullptr), size_(0) {
+    if (!isLittleEndian()) {
+        throw std::runtime_error("Columnar files are only supported on little-endian hosts");
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to stat file: " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ < sizeof(MAGIC) + TRAILER_SIZE) {
+        ::close(fd);
+        throw std::runtime_error("Not a columnar file: " + path);
+    }
+
+    void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error("Failed to memory-map file: " + path +
+                                 " (" + std::strerror(errno) + ")");
+    }
+    data_ = static_cast<const uint8_t*>(addr);
+
+    try {
+        readFooter(path);
+    } catch (...) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+        data_ = nullptr;
+        throw;
+    }
+}
+
+ColumnarReader::~ColumnarReader() {
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+        data_ = nullptr;
+    }
+}
+
+void ColumnarReader::readFooter(const std::string& path) {
+    if (std::memcmp(data_, MAGIC, sizeof(MAGIC)) != 0 ||
+        std::memcmp(data_ + size_ - sizeof(MAGIC), MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a columnar file: " + path);
+    }
+
+    uint64_t footerOffset;
+    std::memcpy(&footerOffset, data_ + size_ - TRAILER_SIZE, sizeof(footerOffset));
+    size_t footerEnd = size_ - TRAILER_SIZE;
+    if (footerOffset < sizeof(MAGIC) || footerOffset > footerEnd) {
+        throw std::runtime_error("Corrupt columnar file: bad footer offset in " + path);
+    }
+
+    FooterCursor cursor(data_ + footerOffset, footerEnd - footerOffset);
+    uint32_t tableCount = cursor.read<uint32_t>();
+    for (uint32_t i = 0; i < tableCount; i++) {
+        RecordType type = static_cast<RecordType>(cursor.read<uint8_t>());
+        Table& table = tables_[type];
+        table.rows = cursor.read<uint64_t>();
+
+        uint32_t chunkCount = cursor.read<uint32_t>();
+        uint64_t totalRows = 0;
+        for (uint32_t c = 0; c < chunkCount; c++) {
+            table.chunkRows.push_back(cursor.read<uint64_t>());
+            totalRows += table.chunkRows.back();
+        }
+        if (totalRows != table.rows) {
+            throw std::runtime_error("Corrupt columnar file: chunk rows do not add up in " + path);
+        }
+
+        uint32_t columnCount = cursor.read<uint32_t>();
+        for (uint32_t c = 0; c < columnCount; c++) {
+            Column column;
+            column.name = cursor.readString();
+            column.type = static_cast<ColumnType>(cursor.read<uint8_t>());
+            size_t elementSize = columnTypeSize(column.type);
+            if (elementSize == 0) {
+                throw std::runtime_error("Corrupt columnar file: unknown type for column " +
+                                         column.name + " in " + path);
+            }
+            for (uint32_t k = 0; k < chunkCount; k++) {
+                ColumnChunkInfo info;
+                info.offset = cursor.read<uint64_t>();
+                info.size = cursor.read<uint64_t>();
+                info.min = cursor.read<double>();
+                info.max = cursor.read<double>();
+                if (info.offset % BLOCK_ALIGNMENT != 0 || info.offset > footerOffset ||
+                    info.size > footerOffset - info.offset ||
+                    info.size != table.chunkRows[k] * elementSize) {
+                    throw std::runtime_error("Corrupt columnar file: bad block for column " +
+                                             column.name + " in " + path);
+                }
+                column.chunks.push_back(info);
+            }
+            uint32_t dictionarySize = cursor.read<uint32_t>();
+            for (uint32_t k = 0; k < dictionarySize; k++) {
+                column.dictionary.push_back(cursor.readString());
+            }
+            table.columns.push_back(std::move(column));
+        }
+    }
+
+    // Scans walk chunks front to back
+    madvise(const_cast<uint8_t*>(data_), footerOffset, MADV_SEQUENTIAL);
+}
+
+const ColumnarReader::Table& ColumnarReader::findTable(RecordType type) const {
+    auto it = tables_.find(type);
+    if (it == tables_.end()) {
+        throw std::runtime_error("Columnar file has no table for this record type");
+    }
+    return it->second;
+}
+
+const ColumnarReader::Column& ColumnarReader::findColumn(RecordType type, const std::string& name) const {
+    for (const Column& column : findTable(type).columns) {
+        if (column.name == name) {
+            return column;
+        }
+    }
+    throw std::runtime_error("Columnar file has no column " + name);
+}
+
+size_t ColumnarReader::getRowCount(RecordType type) const {
+    auto it = tables_.find(type);
+    return it != tables_.end() ? static_cast<size_t>(it->second.rows) : 0;
+}
+
+size_t ColumnarReader::getChunkCount(RecordType type) const {
+    auto it = tables_.find(type);
+    return it != tables_.end() ? it->second.chunkRows.size() : 0;
+}
+
+size_t ColumnarReader::getChunkRows(RecordType type, size_t chunk) const {
+    return static_cast<size_t>(findTable(type).chunkRows.at(chunk));
+}
+
+std::vector<std::string> ColumnarReader::getColumnNames(RecordType type) const {
+    std::vector<std::string> names;
+    for (const Column& column : findTable(type).columns) {
+        names.push_back(column.name);
+    }
+    return names;
+}
+
+ColumnType ColumnarReader::getColumnType(RecordType type, const std::string& name) const {
+    return findColumn(type, name).type;
+}
+
+const ColumnChunkInfo& ColumnarReader::getChunkInfo(RecordType type, const std::string& name,
+                                                    size_t chunk) const {
+    return findColumn(type, name).chunks.at(chunk);
+}
+
+const std::vector<std::string>& ColumnarReader::getDictionary(RecordType type,
+                                                              const std::string& name) const {
+    return findColumn(type, name).dictionary;
+}
+
+} // namespace STDF
@@ -19,6 +19,10 @@
  */
 
 #include "database.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <iostream>
 #include <sstream>
 
@@ -82,6 +86,7 @@ const char* Database::CREATE_MIR_TABLE = R"(
 const char* Database::CREATE_PIR_TABLE = R"(
     CREATE TABLE IF NOT EXISTS pir_records (
         id INTEGER PRIMARY KEY AUTOINCREMENT,
+        file_id INTEGER,
         head_num INTEGER NOT NULL,
         site_num INTEGER NOT NULL,
         created_at DATETIME DEFAULT CURRENT_TIMESTAMP
@@ -91,6 +96,8 @@ const char* Database::CREATE_PIR_TABLE = R"(
 const char* Database::CREATE_PRR_TABLE = R"(
     CREATE TABLE IF NOT EXISTS prr_records (
         id INTEGER PRIMARY KEY AUTOINCREMENT,
+        file_id INTEGER,
+        pir_id INTEGER,
         head_num INTEGER NOT NULL,
         site_num INTEGER NOT NULL,
         part_flg INTEGER,
@@ -109,6 +116,8 @@ const char* Database::CREATE_PRR_TABLE = R"(
 const char* Database::CREATE_PTR_TABLE = R"(
     CREATE TABLE IF NOT EXISTS ptr_records (
         id INTEGER PRIMARY KEY AUTOINCREMENT,
+        file_id INTEGER,
+        part_id INTEGER,
         test_num INTEGER NOT NULL,
         head_num INTEGER NOT NULL,
         site_num INTEGER NOT NULL,
@@ -136,6 +145,8 @@ const char* Database::CREATE_PTR_TABLE = R"(
 const char* Database::CREATE_FTR_TABLE = R"(
     CREATE TABLE IF NOT EXISTS ftr_records (
         id INTEGER PRIMARY KEY AUTOINCREMENT,
+        file_id INTEGER,
+        part_id INTEGER,
         test_num INTEGER NOT NULL,
         head_num INTEGER NOT NULL,
         site_num INTEGER NOT NULL,
@@ -191,6 +202,7 @@ const char* Database::CREATE_SBR_TABLE = R"(
 const char* Database::CREATE_WIR_TABLE = R"(
     CREATE TABLE IF NOT EXISTS wir_records (
         id INTEGER PRIMARY KEY AUTOINCREMENT,
+        file_id INTEGER,
         head_num INTEGER NOT NULL,
         site_grp INTEGER NOT NULL,
         start_t INTEGER NOT NULL,
@@ -202,6 +214,7 @@ const char* Database::CREATE_WIR_TABLE = R"(
 const char* Database::CREATE_WRR_TABLE = R"(
     CREATE TABLE IF NOT EXISTS wrr_records (
         id INTEGER PRIMARY KEY AUTOINCREMENT,
+        file_id INTEGER,
         head_num INTEGER NOT NULL,
         site_grp INTEGER NOT NULL,
         finish_t INTEGER NOT NULL,
@@ -220,6 +233,92 @@ const char* Database::CREATE_WRR_TABLE = R"(
     );
 )";
 
+// Source files, one row per beginFile()
+const char* Database::CREATE_FILES_TABLE = R"(
+    CREATE TABLE IF NOT EXISTS files (
+        file_id INTEGER PRIMARY KEY,
+        path TEXT NOT NULL,
+        loaded_at DATETIME DEFAULT CURRENT_TIMESTAMP
+    );
+)";
+
+// Normalized mode: static PTR metadata, stored once per file and test
+const char* Database::CREATE_TEST_DEFS_TABLE = R"(
+    CREATE TABLE IF NOT EXISTS test_defs (
+        file_id INTEGER NOT NULL,
+        test_num INTEGER NOT NULL,
+        test_txt TEXT,
+        opt_flag INTEGER,
+        res_scal INTEGER,
+        llm_scal INTEGER,
+        hlm_scal INTEGER,
+        lo_limit REAL,
+        hi_limit REAL,
+        units TEXT,
+        c_resfmt TEXT,
+        c_llmfmt TEXT,
+        c_hlmfmt TEXT,
+        lo_spec REAL,
+        hi_spec REAL,
+        PRIMARY KEY (file_id, test_num)
+    ) WITHOUT ROWID;
+)";
+
+// Normalized mode: per-execution PTR columns only. The id is a plain rowid
+// alias (no AUTOINCREMENT bookkeeping) and there is no timestamp.
+const char* Database::CREATE_PTR_RESULTS_TABLE = R"(
+    CREATE TABLE IF NOT EXISTS ptr_records (
+        id INTEGER PRIMARY KEY,
+        file_id INTEGER NOT NULL,
+        part_id INTEGER,
+        test_num INTEGER NOT NULL,
+        head_num INTEGER NOT NULL,
+        site_num INTEGER NOT NULL,
+        test_flg INTEGER,
+        parm_flg INTEGER,
+        result REAL,
+        alarm_id TEXT
+    );
+)";
+
+// Normalized mode: results joined back to their definitions
+const char* Database::CREATE_PTR_FULL_VIEW = R"(
+    CREATE VIEW IF NOT EXISTS ptr_full AS
+        SELECT p.*, d.test_txt, d.opt_flag, d.res_scal, d.llm_scal, d.hlm_scal,
+               d.lo_limit, d.hi_limit, d.units, d.c_resfmt, d.c_llmfmt, d.c_hlmfmt,
+               d.lo_spec, d.hi_spec
+        FROM ptr_records p LEFT JOIN test_defs d USING (file_id, test_num);
+)";
+
+// Row counts kept up to date by the insert paths, so statistics do not
+// have to scan the record tables
+const char* Database::CREATE_SUMMARY_TABLE = R"(
+    CREATE TABLE IF NOT EXISTS db_summary (
+        key TEXT PRIMARY KEY,
+        value INTEGER NOT NULL
+    ) WITHOUT ROWID;
+)";
+
+const char* Database::PASSED_PARTS_KEY = "passed_parts";
+
+// Secondary indexes for reporting queries, kept as one managed set so a
+// bulk load can drop them and build them once at the end
+const Database::IndexDefinition Database::MANAGED_INDEXES[] = {
+    {"idx_ptr_test",     "ptr_records(test_num, site_num)"},
+    {"idx_ptr_part",     "ptr_records(part_id)"},
+    {"idx_ftr_test",     "ftr_records(test_num, site_num)"},
+    {"idx_ftr_part",     "ftr_records(part_id)"},
+    {"idx_prr_hard_bin", "prr_records(hard_bin)"},
+    {"idx_prr_soft_bin", "prr_records(soft_bin)"},
+    {"idx_prr_site",     "prr_records(site_num)"},
+    {"idx_prr_die",      "prr_records(file_id, x_coord, y_coord)"},
+    {"idx_hbr_bin",      "hbr_records(hbin_num)"},
+    {"idx_sbr_bin",      "sbr_records(sbin_num)"},
+    {"idx_mir_lot",      "mir_records(lot_id)"},
+    {"idx_wir_wafer",    "wir_records(wafer_id, file_id)"},
+    {"idx_wrr_wafer",    "wrr_records(wafer_id)"},
+};
+
 // Insert statement definitions
 const char* Database::INSERT_FAR_SQL = 
     "INSERT INTO far_records (cpu_typ, stdf_ver) VALUES (?, ?);";
@@ -235,29 +334,29 @@ const char* Database::INSERT_MIR_SQL = R"(
 )";
 
 const char* Database::INSERT_PIR_SQL = 
-    "INSERT INTO pir_records (head_num, site_num) VALUES (?, ?);";
+    "INSERT INTO pir_records (file_id, head_num, site_num) VALUES (?, ?, ?);";
 
 const char* Database::INSERT_PRR_SQL = R"(
     INSERT INTO prr_records (
-        head_num, site_num, part_flg, num_test, hard_bin, soft_bin,
+        file_id, pir_id, head_num, site_num, part_flg, num_test, hard_bin, soft_bin,
         x_coord, y_coord, test_t, part_id, part_txt
-    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);
+    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);
 )";
 
 const char* Database::INSERT_PTR_SQL = R"(
     INSERT INTO ptr_records (
-        test_num, head_num, site_num, test_flg, parm_flg, result, test_txt, alarm_id,
+        file_id, part_id, test_num, head_num, site_num, test_flg, parm_flg, result, test_txt, alarm_id,
         opt_flag, res_scal, llm_scal, hlm_scal, lo_limit, hi_limit, units,
         c_resfmt, c_llmfmt, c_hlmfmt, lo_spec, hi_spec
-    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);
+    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);
 )";
 
 const char* Database::INSERT_FTR_SQL = R"(
     INSERT INTO ftr_records (
-        test_num, head_num, site_num, test_flg, opt_flag, cycl_cnt, rel_vadr,
+        file_id, part_id, test_num, head_num, site_num, test_flg, opt_flag, cycl_cnt, rel_vadr,
         rept_cnt, num_fail, xfail_ad, yfail_ad, vect_off, rtn_icnt, pgm_icnt,
         vect_nam, time_set, op_code, test_txt, alarm_id, prog_txt, rslt_txt, patg_num
-    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);
+    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);
 )";
 
 const char* Database::INSERT_HBR_SQL = R"(
@@ -274,18 +373,69 @@ const char* Database::INSERT_SBR_SQL = R"(
 
 const char* Database::INSERT_WIR_SQL = R"(
     INSERT INTO wir_records (
-        head_num, site_grp, start_t, wafer_id
-    ) VALUES (?, ?, ?, ?);
+        file_id, head_num, site_grp, start_t, wafer_id
+    ) VALUES (?, ?, ?, ?, ?);
 )";
 
 const char* Database::INSERT_WRR_SQL = R"(
     INSERT INTO wrr_records (
-        head_num, site_grp, finish_t, part_cnt, rtst_cnt, abrt_cnt, good_cnt, func_cnt,
+        file_id, head_num, site_grp, finish_t, part_cnt, rtst_cnt, abrt_cnt, good_cnt, func_cnt,
         wafer_id, fabwf_id, frame_id, mask_id, usr_desc, exc_desc
-    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);
+    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);
 )";
 
-Database::Database(const std::string& dbPath) : dbPath_(dbPath), db_(nullptr) {
+const char* Database::INSERT_PTR_RESULT_SQL = R"(
+    INSERT INTO ptr_records (
+        file_id, part_id, test_num, head_num, site_num, test_flg, parm_flg, result, alarm_id
+    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);
+)";
+
+const char* Database::INSERT_TEST_DEF_SQL = R"(
+    INSERT OR IGNORE INTO test_defs (
+        file_id, test_num, test_txt, opt_flag, res_scal, llm_scal, hlm_scal, lo_limit,
+        hi_limit, units, c_resfmt, c_llmfmt, c_hlmfmt, lo_spec, hi_spec
+    ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);
+)";
+
+const char* loadProfileName(LoadProfile profile) {
+    switch (profile) {
+        case LoadProfile::BulkLoad:   return "bulk";
+        case LoadProfile::Production: return "production";
+        default:                      return "default";
+    }
+}
+
+bool loadProfileFromName(const std::string& name, LoadProfile& profile) {
+    for (LoadProfile candidate : {LoadProfile::Default, LoadProfile::BulkLoad, LoadProfile::Production}) {
+        if (name == loadProfileName(candidate)) {
+            profile = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* schemaModeName(SchemaMode mode) {
+    return mode == SchemaMode::Normalized ? "normalized" : "wide";
+}
+
+bool schemaModeFromName(const std::string& name, SchemaMode& mode) {
+    for (SchemaMode candidate : {SchemaMode::Wide, SchemaMode::Normalized}) {
+        if (name == schemaModeName(candidate)) {
+            mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+Database::Database(const std::string& dbPath, LoadProfile profile)
+    : dbPath_(dbPath), db_(nullptr), profile_(profile), stageInMemory_(false),
+      flushedChanges_(-1), schemaMode_(SchemaMode::Wide), currentFileId_(0),
+      deferIndexes_(profile == LoadProfile::BulkLoad), summaryReady_(false),
+      inTransaction_(false), inSavepoint_(false), pendingPassedParts_(0),
+      summaryStatement_(nullptr), savepointStatement_(nullptr), releaseStatement_(nullptr),
+      rollbackToStatement_(nullptr), testDefStatement_(nullptr) {
 }
 
 Database::~Database() {
@@ -293,21 +443,186 @@ Database::~Database() {
 }
 
 bool Database::open() {
-    int result = sqlite3_open(dbPath_.c_str(), &db_);
-    if (result != SQLITE_OK) {
+    if (!stageInMemory_) {
+        int result = sqlite3_open(dbPath_.c_str(), &db_);
+        if (result != SQLITE_OK) {
+            setLastSQLiteError();
+            sqlite3_close(db_);
+            db_ = nullptr;
+            return false;
+        }
+        if (!applyProfile(db_, false)) {
+            sqlite3_close(db_);
+            db_ = nullptr;
+            return false;
+        }
+        detectSchemaMode();
+        return true;
+    }
+
+    flushedChanges_ = -1;
+    if (sqlite3_open(":memory:", &db_) != SQLITE_OK) {
         setLastSQLiteError();
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return false;
+    }
+    if (!applyProfile(db_, true)) {
+        std::string error = lastError_;
+        sqlite3_close(db_);
+        db_ = nullptr;
+        setLastError(error);
         return false;
     }
+
+    // Start from the current contents of the file, if there is one
+    std::error_code ec;
+    if (std::filesystem::file_size(dbPath_, ec) > 0 && !ec) {
+        sqlite3* disk = nullptr;
+        bool copied = false;
+        if (sqlite3_open_v2(dbPath_.c_str(), &disk, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+            setLastError(sqlite3_errmsg(disk));
+        } else {
+            copied = copyDatabase(disk, db_);
+        }
+        sqlite3_close(disk);
+        if (!copied) {
+            setLastError("Failed to stage " + dbPath_ + " in memory: " + lastError_);
+            sqlite3_close(db_);
+            db_ = nullptr;
+            return false;
+        }
+    }
+    detectSchemaMode();
     return true;
 }
 
+void Database::detectSchemaMode() {
+    summaryReady_ = false;
+    sqlite3_stmt* stmt = nullptr;
+    const char* sql = "SELECT name FROM sqlite_master WHERE type = 'table' "
+                      "AND name IN ('ptr_records', 'test_defs', 'db_summary');";
+    if (!prepareStatement(sql, &stmt)) {
+        return;
+    }
+    bool hasResults = false;
+    bool hasTestDefs = false;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        hasResults = hasResults || name == "ptr_records";
+        hasTestDefs = hasTestDefs || name == "test_defs";
+        summaryReady_ = summaryReady_ || name == "db_summary";
+    }
+    sqlite3_finalize(stmt);
+    if (hasResults) {
+        schemaMode_ = hasTestDefs ? SchemaMode::Normalized : SchemaMode::Wide;
+    }
+}
+
 void Database::close() {
+    if (db_ && stageInMemory_ && sqlite3_total_changes64(db_) != flushedChanges_ && !flush()) {
+        STDF_LOG_ERROR << lastError_;
+    }
+    finalizeStatements();
     if (db_) {
         sqlite3_close(db_);
         db_ = nullptr;
     }
 }
 
+bool Database::flush() {
+    if (!stageInMemory_) {
+        return true;
+    }
+    if (!db_) {
+        setLastError("Database not open");
+        return false;
+    }
+
+    sqlite3* disk = nullptr;
+    if (sqlite3_open(dbPath_.c_str(), &disk) != SQLITE_OK) {
+        setLastError("Failed to open " + dbPath_ + ": " + sqlite3_errmsg(disk));
+        sqlite3_close(disk);
+        return false;
+    }
+    bool ok = applyProfile(disk, false) && copyDatabase(db_, disk);
+    sqlite3_close(disk);
+    if (!ok) {
+        setLastError("Failed to write staged database to " + dbPath_ + ": " + lastError_);
+        return false;
+    }
+    flushedChanges_ = sqlite3_total_changes64(db_);
+    return true;
+}
+
+bool Database::applyProfile(sqlite3* db, bool inMemory) {
+    std::vector<const char*> pragmas;
+    switch (profile_) {
+        case LoadProfile::BulkLoad:
+            // The journal stays in memory rather than OFF so that rolling
+            // back a failed file still works
+            pragmas = {"PRAGMA page_size = 16384;",
+                       "PRAGMA journal_mode = MEMORY;",
+                       "PRAGMA synchronous = OFF;",
+                       "PRAGMA cache_size = -262144;",
+                       "PRAGMA temp_store = MEMORY;",
+                       "PRAGMA locking_mode = EXCLUSIVE;"};
+            if (!inMemory) {
+                pragmas.push_back("PRAGMA mmap_size = 1073741824;");
+            }
+            break;
+        case LoadProfile::Production:
+            pragmas = {"PRAGMA synchronous = NORMAL;",
+                       "PRAGMA cache_size = -65536;",
+                       "PRAGMA temp_store = MEMORY;"};
+            if (!inMemory) {
+                pragmas.push_back("PRAGMA journal_mode = WAL;");
+                pragmas.push_back("PRAGMA mmap_size = 268435456;");
+            }
+            sqlite3_busy_timeout(db, 5000);
+            break;
+        default:
+            break;
+    }
+
+    for (const char* pragma : pragmas) {
+        char* errorMessage = nullptr;
+        if (sqlite3_exec(db, pragma, nullptr, nullptr, &errorMessage) != SQLITE_OK) {
+            setLastError(std::string("Failed to apply ") + pragma + " " +
+                         (errorMessage ? errorMessage : sqlite3_errmsg(db)));
+            sqlite3_free(errorMessage);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Database::copyDatabase(sqlite3* source, sqlite3* destination) {
+    sqlite3_backup* backup = sqlite3_backup_init(destination, "main", source, "main");
+    if (!backup) {
+        setLastError(sqlite3_errmsg(destination));
+        return false;
+    }
+    sqlite3_backup_step(backup, -1);
+    if (sqlite3_backup_finish(backup) != SQLITE_OK) {
+        setLastError(sqlite3_errmsg(destination));
+        return false;
+    }
+    return true;
+}
+
+std::string Database::queryPragma(const std::string& name) const {
+    std::string value;
+    sqlite3_stmt* stmt = nullptr;
+    if (db_ && sqlite3_prepare_v2(db_, ("PRAGMA " + name + ";").c_str(), -1, &stmt, nullptr) == SQLITE_OK &&
+        sqlite3_step(stmt) == SQLITE_ROW) {
+        const unsigned char* text = sqlite3_column_text(stmt, 0);
+        value = text ? reinterpret_cast<const char*>(text) : "";
+    }
+    sqlite3_finalize(stmt);
+    return value;
+}
+
 bool Database::createTables() {
     if (!db_) {
         setLastError("Database not open");
@@ -319,7 +634,7 @@ bool Database::createTables() {
         !executeSQL(CREATE_MIR_TABLE) ||
         !executeSQL(CREATE_PIR_TABLE) ||
         !executeSQL(CREATE_PRR_TABLE) ||
-        !executeSQL(CREATE_PTR_TABLE) ||
+        !executeSQL(CREATE_FILES_TABLE) ||
         !executeSQL(CREATE_FTR_TABLE) ||
         !executeSQL(CREATE_HBR_TABLE) ||
         !executeSQL(CREATE_SBR_TABLE) ||
@@ -328,36 +643,122 @@ bool Database::createTables() {
         return false;
     }
 
+    if (schemaMode_ == SchemaMode::Normalized) {
+        if (!executeSQL(CREATE_TEST_DEFS_TABLE) ||
+            !executeSQL(CREATE_PTR_RESULTS_TABLE) ||
+            !executeSQL(CREATE_PTR_FULL_VIEW)) {
+            return false;
+        }
+    } else if (!executeSQL(CREATE_PTR_TABLE)) {
+        return false;
+    }
+
+    if (!migrateLinkColumns() || !createSummary()) {
+        return false;
+    }
+
+    // Deferred indexes are dropped so the load does not maintain them
+    return deferIndexes_ ? dropIndexes() : createIndexes();
+}
+
+bool Database::migrateLinkColumns() {
+    static const char* const LINK_COLUMNS[][2] = {
+        {"pir_records", "file_id"},
+        {"prr_records", "file_id"}, {"prr_records", "pir_id"},
+        {"ptr_records", "file_id"}, {"ptr_records", "part_id"},
+        {"ftr_records", "file_id"}, {"ftr_records", "part_id"},
+        {"wir_records", "file_id"},
+        {"wrr_records", "file_id"},
+    };
+    for (const auto& link : LINK_COLUMNS) {
+        sqlite3_stmt* stmt = nullptr;
+        if (!prepareStatement(std::string("PRAGMA table_info(") + link[0] + ");", &stmt)) {
+            return false;
+        }
+        bool present = false;
+        while (!present && sqlite3_step(stmt) == SQLITE_ROW) {
+            present = std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1))) == link[1];
+        }
+        sqlite3_finalize(stmt);
+        if (!present &&
+            !executeSQL(std::string("ALTER TABLE ") + link[0] + " ADD COLUMN " + link[1] + " INTEGER;")) {
+            return false;
+        }
+    }
     return true;
 }
 
-bool Database::insertFAR(const FARRecord& record) {
-    sqlite3_stmt* stmt;
-    if (!prepareStatement(INSERT_FAR_SQL, &stmt)) {
-        return false;
+bool Database::createIndexes() {
+    for (const auto& index : MANAGED_INDEXES) {
+        if (!executeSQL(std::string("CREATE INDEX IF NOT EXISTS ") + index.name + " ON " + index.definition + ";")) {
+            return false;
+        }
     }
+    return true;
+}
 
-    sqlite3_bind_int(stmt, 1, record.CPU_TYP);
-    sqlite3_bind_int(stmt, 2, record.STDF_VER);
+bool Database::dropIndexes() {
+    for (const auto& index : MANAGED_INDEXES) {
+        if (!executeSQL(std::string("DROP INDEX IF EXISTS ") + index.name + ";")) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    int result = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+std::vector<std::string> Database::getMissingIndexes() const {
+    std::vector<std::string> missing;
+    for (const auto& index : MANAGED_INDEXES) {
+        sqlite3_stmt* stmt = nullptr;
+        bool present = false;
+        if (sqlite3_prepare_v2(db_, "SELECT 1 FROM sqlite_master WHERE type = 'index' AND name = ?;",
+                               -1, &stmt, nullptr) == SQLITE_OK) {
+            sqlite3_bind_text(stmt, 1, index.name, -1, SQLITE_STATIC);
+            present = sqlite3_step(stmt) == SQLITE_ROW;
+        }
+        sqlite3_finalize(stmt);
+        if (!present) {
+            missing.push_back(index.name);
+        }
+    }
+    return missing;
+}
 
-    if (result != SQLITE_DONE) {
-        setLastSQLiteError();
+bool Database::insertFAR(const FARRecord& record) {
+    sqlite3_stmt* stmt = cachedStatement(RecordType::FAR, INSERT_FAR_SQL);
+    if (!stmt || !beginWrite()) {
         return false;
     }
 
-    return true;
+    bindFAR(stmt, 1, record);
+    bool ok = stepCachedStatement(stmt);
+    if (ok) {
+        countInserted(RecordType::FAR, 1);
+    }
+    return endWrite(ok);
+}
+
+int Database::bindFAR(sqlite3_stmt* stmt, int param, const FARRecord& record) {
+    sqlite3_bind_int(stmt, param++, record.CPU_TYP);
+    sqlite3_bind_int(stmt, param++, record.STDF_VER);
+    return param;
 }
 
 bool Database::insertMIR(const MIRRecord& record) {
-    sqlite3_stmt* stmt;
-    if (!prepareStatement(INSERT_MIR_SQL, &stmt)) {
+    sqlite3_stmt* stmt = cachedStatement(RecordType::MIR, INSERT_MIR_SQL);
+    if (!stmt || !beginWrite()) {
         return false;
     }
 
-    int param = 1;
+    bindMIR(stmt, 1, record);
+    bool ok = stepCachedStatement(stmt);
+    if (ok) {
+        countInserted(RecordType::MIR, 1);
+    }
+    return endWrite(ok);
+}
+
+int Database::bindMIR(sqlite3_stmt* stmt, int param, const MIRRecord& record) {
     sqlite3_bind_int(stmt, param++, record.SETUP_T);
     sqlite3_bind_int(stmt, param++, record.START_T);
     sqlite3_bind_int(stmt, param++, record.STAT_NUM);
@@ -396,74 +797,95 @@ bool Database::insertMIR(const MIRRecord& record) {
     sqlite3_bind_text(stmt, param++, record.ROM_COD.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, param++, record.SERL_NUM.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, param++, record.SUPR_NAM.c_str(), -1, SQLITE_STATIC);
-
-    int result = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-
-    if (result != SQLITE_DONE) {
-        setLastSQLiteError();
-        return false;
-    }
-
-    return true;
+    return param;
 }
 
 bool Database::insertPIR(const PIRRecord& record) {
-    sqlite3_stmt* stmt;
-    if (!prepareStatement(INSERT_PIR_SQL, &stmt)) {
+    sqlite3_stmt* stmt = cachedStatement(RecordType::PIR, INSERT_PIR_SQL);
+    if (!stmt || !beginWrite()) {
         return false;
     }
 
-    sqlite3_bind_int(stmt, 1, record.HEAD_NUM);
-    sqlite3_bind_int(stmt, 2, record.SITE_NUM);
-
-    int result = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-
-    if (result != SQLITE_DONE) {
-        setLastSQLiteError();
+    bindPIR(stmt, 1, record);
+    bool ok = stepCachedStatement(stmt);
+    long long rowId = sqlite3_last_insert_rowid(db_);
+    if (ok) {
+        countInserted(RecordType::PIR, 1);
+    }
+    if (!endWrite(ok)) {
         return false;
     }
-
+    openParts_[siteKey(record.HEAD_NUM, record.SITE_NUM)] = rowId;
     return true;
 }
 
+int Database::bindPIR(sqlite3_stmt* stmt, int param, const PIRRecord& record) {
+    sqlite3_bind_int64(stmt, param++, currentFileId_);
+    sqlite3_bind_int(stmt, param++, record.HEAD_NUM);
+    sqlite3_bind_int(stmt, param++, record.SITE_NUM);
+    return param;
+}
+
 bool Database::insertPRR(const PRRRecord& record) {
-    sqlite3_stmt* stmt;
-    if (!prepareStatement(INSERT_PRR_SQL, &stmt)) {
+    sqlite3_stmt* stmt = cachedStatement(RecordType::PRR, INSERT_PRR_SQL);
+    if (!stmt || !beginWrite()) {
         return false;
     }
 
-    sqlite3_bind_int(stmt, 1, record.HEAD_NUM);
-    sqlite3_bind_int(stmt, 2, record.SITE_NUM);
-    sqlite3_bind_int(stmt, 3, record.PART_FLG);
-    sqlite3_bind_int(stmt, 4, record.NUM_TEST);
-    sqlite3_bind_int(stmt, 5, record.HARD_BIN);
-    sqlite3_bind_int(stmt, 6, record.SOFT_BIN);
-    sqlite3_bind_int(stmt, 7, record.X_COORD);
-    sqlite3_bind_int(stmt, 8, record.Y_COORD);
-    sqlite3_bind_int(stmt, 9, record.TEST_T);
-    sqlite3_bind_text(stmt, 10, record.PART_ID.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 11, record.PART_TXT.c_str(), -1, SQLITE_STATIC);
-
-    int result = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-
-    if (result != SQLITE_DONE) {
-        setLastSQLiteError();
+    bindPRR(stmt, 1, record);
+    bool ok = stepCachedStatement(stmt);
+    if (ok) {
+        pendingPassedParts_ += record.HARD_BIN == 1;
+        countInserted(RecordType::PRR, 1);
+    }
+    if (!endWrite(ok)) {
         return false;
     }
-
+    openParts_.erase(siteKey(record.HEAD_NUM, record.SITE_NUM));
     return true;
 }
 
+int Database::bindPRR(sqlite3_stmt* stmt, int param, const PRRRecord& record) {
+    sqlite3_bind_int64(stmt, param++, currentFileId_);
+    param = bindPartId(stmt, param, record.HEAD_NUM, record.SITE_NUM);
+    sqlite3_bind_int(stmt, param++, record.HEAD_NUM);
+    sqlite3_bind_int(stmt, param++, record.SITE_NUM);
+    sqlite3_bind_int(stmt, param++, record.PART_FLG);
+    sqlite3_bind_int(stmt, param++, record.NUM_TEST);
+    sqlite3_bind_int(stmt, param++, record.HARD_BIN);
+    sqlite3_bind_int(stmt, param++, record.SOFT_BIN);
+    sqlite3_bind_int(stmt, param++, record.X_COORD);
+    sqlite3_bind_int(stmt, param++, record.Y_COORD);
+    sqlite3_bind_int(stmt, param++, record.TEST_T);
+    sqlite3_bind_text(stmt, param++, record.PART_ID.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, param++, record.PART_TXT.c_str(), -1, SQLITE_STATIC);
+    return param;
+}
+
 bool Database::insertPTR(const PTRRecord& record) {
-    sqlite3_stmt* stmt;
-    if (!prepareStatement(INSERT_PTR_SQL, &stmt)) {
+    sqlite3_stmt* stmt = cachedStatement(RecordType::PTR, insertSQL(RecordType::PTR));
+    if (!stmt || !beginWrite()) {
         return false;
     }
 
-    int param = 1;
+    // The test_defs row goes in with the result that first needs it
+    bool ok = schemaMode_ != SchemaMode::Normalized || defineTest(record);
+    if (ok) {
+        bindPTR(stmt, 1, record);
+        ok = stepCachedStatement(stmt);
+    }
+    if (ok) {
+        countInserted(RecordType::PTR, 1);
+    }
+    return endWrite(ok);
+}
+
+int Database::bindPTR(sqlite3_stmt* stmt, int param, const PTRRecord& record) {
+    if (schemaMode_ == SchemaMode::Normalized) {
+        return bindPTRResult(stmt, param, record);
+    }
+    sqlite3_bind_int64(stmt, param++, currentFileId_);
+    param = bindPartId(stmt, param, record.HEAD_NUM, record.SITE_NUM);
     sqlite3_bind_int(stmt, param++, record.TEST_NUM);
     sqlite3_bind_int(stmt, param++, record.HEAD_NUM);
     sqlite3_bind_int(stmt, param++, record.SITE_NUM);
@@ -484,25 +906,108 @@ bool Database::insertPTR(const PTRRecord& record) {
     sqlite3_bind_text(stmt, param++, record.C_HLMFMT.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_double(stmt, param++, record.LO_SPEC);
     sqlite3_bind_double(stmt, param++, record.HI_SPEC);
+    return param;
+}
 
-    int result = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+int Database::bindPTRResult(sqlite3_stmt* stmt, int param, const PTRRecord& record) {
+    sqlite3_bind_int64(stmt, param++, currentFileId_);
+    param = bindPartId(stmt, param, record.HEAD_NUM, record.SITE_NUM);
+    sqlite3_bind_int(stmt, param++, record.TEST_NUM);
+    sqlite3_bind_int(stmt, param++, record.HEAD_NUM);
+    sqlite3_bind_int(stmt, param++, record.SITE_NUM);
+    sqlite3_bind_int(stmt, param++, record.TEST_FLG);
+    sqlite3_bind_int(stmt, param++, record.PARM_FLG);
+    sqlite3_bind_double(stmt, param++, record.RESULT);
+    // Almost always empty; NULL costs less to store than ''
+    if (record.ALARM_ID.empty()) {
+        sqlite3_bind_null(stmt, param++);
+    } else {
+        sqlite3_bind_text(stmt, param++, record.ALARM_ID.c_str(), -1, SQLITE_STATIC);
+    }
+    return param;
+}
 
-    if (result != SQLITE_DONE) {
-        setLastSQLiteError();
+int Database::bindPartId(sqlite3_stmt* stmt, int param, U1 headNum, U1 siteNum) const {
+    auto it = openParts_.find(siteKey(headNum, siteNum));
+    if (it != openParts_.end()) {
+        sqlite3_bind_int64(stmt, param, it->second);
+    } else {
+        sqlite3_bind_null(stmt, param); // Outside any PIR/PRR pair
+    }
+    return param + 1;
+}
+
+bool Database::defineTest(const PTRRecord& record) {
+    // The first PTR of a test in a file carries its text and limits; later
+    // ones may leave them out, so only the first one is stored
+    if (!definedTests_.insert(record.TEST_NUM).second) {
+        return true;
+    }
+    if (!testDefStatement_ && !prepareStatement(INSERT_TEST_DEF_SQL, &testDefStatement_)) {
+        testDefStatement_ = nullptr;
+        definedTests_.erase(record.TEST_NUM);
         return false;
     }
 
+    sqlite3_stmt* stmt = testDefStatement_;
+    int param = 1;
+    sqlite3_bind_int64(stmt, param++, currentFileId_);
+    sqlite3_bind_int(stmt, param++, record.TEST_NUM);
+    sqlite3_bind_text(stmt, param++, record.TEST_TXT.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, param++, record.OPT_FLAG);
+    sqlite3_bind_int(stmt, param++, record.RES_SCAL);
+    sqlite3_bind_int(stmt, param++, record.LLM_SCAL);
+    sqlite3_bind_int(stmt, param++, record.HLM_SCAL);
+    sqlite3_bind_double(stmt, param++, record.LO_LIMIT);
+    sqlite3_bind_double(stmt, param++, record.HI_LIMIT);
+    sqlite3_bind_text(stmt, param++, record.UNITS.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, param++, record.C_RESFMT.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, param++, record.C_LLMFMT.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, param++, record.C_HLMFMT.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_double(stmt, param++, record.LO_SPEC);
+    sqlite3_bind_double(stmt, param++, record.HI_SPEC);
+    if (!stepCachedStatement(stmt)) {
+        definedTests_.erase(record.TEST_NUM);
+        return false;
+    }
     return true;
 }
 
+long long Database::beginFile(const std::string& path) {
+    sqlite3_stmt* stmt = nullptr;
+    if (!prepareStatement("INSERT INTO files (path) VALUES (?);", &stmt)) {
+        return -1;
+    }
+    sqlite3_bind_text(stmt, 1, path.c_str(), -1, SQLITE_STATIC);
+    int result = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (result != SQLITE_DONE) {
+        setLastSQLiteError();
+        return -1;
+    }
+    currentFileId_ = sqlite3_last_insert_rowid(db_);
+    definedTests_.clear();
+    openParts_.clear();
+    return currentFileId_;
+}
+
 bool Database::insertFTR(const FTRRecord& record) {
-    sqlite3_stmt* stmt;
-    if (!prepareStatement(INSERT_FTR_SQL, &stmt)) {
+    sqlite3_stmt* stmt = cachedStatement(RecordType::FTR, INSERT_FTR_SQL);
+    if (!stmt || !beginWrite()) {
         return false;
     }
 
-    int param = 1;
+    bindFTR(stmt, 1, record);
+    bool ok = stepCachedStatement(stmt);
+    if (ok) {
+        countInserted(RecordType::FTR, 1);
+    }
+    return endWrite(ok);
+}
+
+int Database::bindFTR(sqlite3_stmt* stmt, int param, const FTRRecord& record) {
+    sqlite3_bind_int64(stmt, param++, currentFileId_);
+    param = bindPartId(stmt, param, record.HEAD_NUM, record.SITE_NUM);
     sqlite3_bind_int(stmt, param++, record.TEST_NUM);
     sqlite3_bind_int(stmt, param++, record.HEAD_NUM);
     sqlite3_bind_int(stmt, param++, record.SITE_NUM);
@@ -525,95 +1030,96 @@ bool Database::insertFTR(const FTRRecord& record) {
     sqlite3_bind_text(stmt, param++, record.PROG_TXT.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, param++, record.RSLT_TXT.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_int(stmt, param++, record.PATG_NUM);
-
-    int result = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-
-    if (result != SQLITE_DONE) {
-        setLastSQLiteError();
-        return false;
-    }
-
-    return true;
+    return param;
 }
 
 bool Database::insertHBR(const HBRRecord& record) {
-    sqlite3_stmt* stmt;
-    if (!prepareStatement(INSERT_HBR_SQL, &stmt)) {
+    sqlite3_stmt* stmt = cachedStatement(RecordType::HBR, INSERT_HBR_SQL);
+    if (!stmt || !beginWrite()) {
         return false;
     }
 
-    sqlite3_bind_int(stmt, 1, record.HEAD_NUM);
-    sqlite3_bind_int(stmt, 2, record.SITE_NUM);
-    sqlite3_bind_int(stmt, 3, record.HBIN_NUM);
-    sqlite3_bind_int(stmt, 4, record.HBIN_CNT);
-    sqlite3_bind_text(stmt, 5, &record.HBIN_PF, 1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 6, record.HBIN_NAM.c_str(), -1, SQLITE_STATIC);
-
-    int result = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-
-    if (result != SQLITE_DONE) {
-        setLastSQLiteError();
-        return false;
+    bindHBR(stmt, 1, record);
+    bool ok = stepCachedStatement(stmt);
+    if (ok) {
+        countInserted(RecordType::HBR, 1);
     }
+    return endWrite(ok);
+}
 
-    return true;
+int Database::bindHBR(sqlite3_stmt* stmt, int param, const HBRRecord& record) {
+    sqlite3_bind_int(stmt, param++, record.HEAD_NUM);
+    sqlite3_bind_int(stmt, param++, record.SITE_NUM);
+    sqlite3_bind_int(stmt, param++, record.HBIN_NUM);
+    sqlite3_bind_int(stmt, param++, record.HBIN_CNT);
+    sqlite3_bind_text(stmt, param++, &record.HBIN_PF, 1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, param++, record.HBIN_NAM.c_str(), -1, SQLITE_STATIC);
+    return param;
 }
 
 bool Database::insertSBR(const SBRRecord& record) {
-    sqlite3_stmt* stmt;
-    if (!prepareStatement(INSERT_SBR_SQL, &stmt)) {
+    sqlite3_stmt* stmt = cachedStatement(RecordType::SBR, INSERT_SBR_SQL);
+    if (!stmt || !beginWrite()) {
         return false;
     }
 
-    sqlite3_bind_int(stmt, 1, record.HEAD_NUM);
-    sqlite3_bind_int(stmt, 2, record.SITE_NUM);
-    sqlite3_bind_int(stmt, 3, record.SBIN_NUM);
-    sqlite3_bind_int(stmt, 4, record.SBIN_CNT);
-    sqlite3_bind_text(stmt, 5, &record.SBIN_PF, 1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 6, record.SBIN_NAM.c_str(), -1, SQLITE_STATIC);
-
-    int result = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-
-    if (result != SQLITE_DONE) {
-        setLastSQLiteError();
-        return false;
+    bindSBR(stmt, 1, record);
+    bool ok = stepCachedStatement(stmt);
+    if (ok) {
+        countInserted(RecordType::SBR, 1);
     }
+    return endWrite(ok);
+}
 
-    return true;
+int Database::bindSBR(sqlite3_stmt* stmt, int param, const SBRRecord& record) {
+    sqlite3_bind_int(stmt, param++, record.HEAD_NUM);
+    sqlite3_bind_int(stmt, param++, record.SITE_NUM);
+    sqlite3_bind_int(stmt, param++, record.SBIN_NUM);
+    sqlite3_bind_int(stmt, param++, record.SBIN_CNT);
+    sqlite3_bind_text(stmt, param++, &record.SBIN_PF, 1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, param++, record.SBIN_NAM.c_str(), -1, SQLITE_STATIC);
+    return param;
 }
 
 bool Database::insertWIR(const WIRRecord& record) {
-    sqlite3_stmt* stmt;
-    if (!prepareStatement(INSERT_WIR_SQL, &stmt)) {
+    sqlite3_stmt* stmt = cachedStatement(RecordType::WIR, INSERT_WIR_SQL);
+    if (!stmt || !beginWrite()) {
         return false;
     }
 
-    sqlite3_bind_int(stmt, 1, record.HEAD_NUM);
-    sqlite3_bind_int(stmt, 2, record.SITE_GRP);
-    sqlite3_bind_int(stmt, 3, record.START_T);
-    sqlite3_bind_text(stmt, 4, record.WAFER_ID.c_str(), -1, SQLITE_STATIC);
-
-    int result = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-
-    if (result != SQLITE_DONE) {
-        setLastSQLiteError();
-        return false;
+    bindWIR(stmt, 1, record);
+    bool ok = stepCachedStatement(stmt);
+    if (ok) {
+        countInserted(RecordType::WIR, 1);
     }
+    return endWrite(ok);
+}
 
-    return true;
+int Database::bindWIR(sqlite3_stmt* stmt, int param, const WIRRecord& record) {
+    sqlite3_bind_int64(stmt, param++, currentFileId_);
+    sqlite3_bind_int(stmt, param++, record.HEAD_NUM);
+    sqlite3_bind_int(stmt, param++, record.SITE_GRP);
+    sqlite3_bind_int(stmt, param++, record.START_T);
+    sqlite3_bind_text(stmt, param++, record.WAFER_ID.c_str(), -1, SQLITE_STATIC);
+    return param;
 }
 
 bool Database::insertWRR(const WRRRecord& record) {
-    sqlite3_stmt* stmt;
-    if (!prepareStatement(INSERT_WRR_SQL, &stmt)) {
+    sqlite3_stmt* stmt = cachedStatement(RecordType::WRR, INSERT_WRR_SQL);
+    if (!stmt || !beginWrite()) {
         return false;
     }
 
-    int param = 1;
+    bindWRR(stmt, 1, record);
+    bool ok = stepCachedStatement(stmt);
+    if (ok) {
+        countInserted(RecordType::WRR, 1);
+    }
+    return endWrite(ok);
+}
+
+int Database::bindWRR(sqlite3_stmt* stmt, int param, const WRRRecord& record) {
+    sqlite3_bind_int64(stmt, param++, currentFileId_);
     sqlite3_bind_int(stmt, param++, record.HEAD_NUM);
     sqlite3_bind_int(stmt, param++, record.SITE_GRP);
     sqlite3_bind_int(stmt, param++, record.FINISH_T);
@@ -628,16 +1134,7 @@ bool Database::insertWRR(const WRRRecord& record) {
     sqlite3_bind_text(stmt, param++, record.MASK_ID.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, param++, record.USR_DESC.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, param++, record.EXC_DESC.c_str(), -1, SQLITE_STATIC);
-
-    int result = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-
-    if (result != SQLITE_DONE) {
-        setLastSQLiteError();
-        return false;
-    }
-
-    return true;
+    return param;
 }
 
 bool Database::insertRecord(const STDFRecord& record) {
@@ -668,15 +1165,200 @@ bool Database::insertRecord(const STDFRecord& record) {
     }
 }
 
+bool Database::insertBatch(const std::vector<const STDFRecord*>& records) {
+    lastBatch_ = BatchTiming();
+    if (records.empty()) {
+        return true;
+    }
+    if (!db_) {
+        setLastError("Database not open");
+        return false;
+    }
+
+    RecordType type = records.front()->getRecordType();
+    for (const STDFRecord* record : records) {
+        if (record->getRecordType() != type) {
+            setLastError("insertBatch requires records of a single type");
+            return false;
+        }
+    }
+    const char* sql = insertSQL(type);
+    if (!sql) {
+        setLastError("Unsupported record type for insertion");
+        return false;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    if (!beginWrite()) {
+        return false;
+    }
+
+    bool ok = true;
+    if (type == RecordType::PTR && schemaMode_ == SchemaMode::Normalized) {
+        for (size_t i = 0; ok && i < records.size(); ++i) {
+            ok = defineTest(static_cast<const PTRRecord&>(*records[i]));
+        }
+    }
+
+    // Split the batch into power-of-two chunks no larger than the host
+    // parameter limit allows, so every chunk reuses a cached statement
+    size_t columns = 0;
+    for (const char* c = sql; *c; ++c) {
+        columns += (*c == '?');
+    }
+    size_t parameterLimit = static_cast<size_t>(sqlite3_limit(db_, SQLITE_LIMIT_VARIABLE_NUMBER, -1));
+    size_t rowLimit = std::max<size_t>(1, parameterLimit / columns);
+    // PIRs go in one row at a time so each one's row id can open its part
+    size_t largestClass = 0;
+    while (type != RecordType::PIR && largestClass + 1 < BATCH_SIZE_CLASSES &&
+           (size_t(2) << largestClass) <= rowLimit) {
+        ++largestClass;
+    }
+
+    size_t done = 0;
+    std::vector<long long> pirRowIds;
+    auto& statements = batchStatements_[static_cast<size_t>(type)];
+    while (ok && done < records.size()) {
+        size_t sizeClass = largestClass;
+        while ((size_t(1) << sizeClass) > records.size() - done) {
+            --sizeClass;
+        }
+        size_t rows = size_t(1) << sizeClass;
+        sqlite3_stmt*& stmt = statements[sizeClass];
+        if (!stmt && !prepareStatement(multiRowSQL(sql, rows), &stmt)) {
+            stmt = nullptr;
+            ok = false;
+            break;
+        }
+        ok = executeBatch(stmt, records, done, rows);
+        if (ok && type == RecordType::PIR) {
+            pirRowIds.push_back(sqlite3_last_insert_rowid(db_));
+        }
+        done += rows;
+    }
+    if (ok) {
+        if (type == RecordType::PRR) {
+            for (const STDFRecord* record : records) {
+                pendingPassedParts_ += static_cast<const PRRRecord&>(*record).HARD_BIN == 1;
+            }
+        }
+        countInserted(type, records.size());
+    }
+    // Every chunk and its counts commit together, so parts are only opened
+    // or closed once the rows are known to stay
+    ok = endWrite(ok);
+    if (ok && type == RecordType::PIR) {
+        for (size_t i = 0; i < records.size(); ++i) {
+            const auto& pir = static_cast<const PIRRecord&>(*records[i]);
+            openParts_[siteKey(pir.HEAD_NUM, pir.SITE_NUM)] = pirRowIds[i];
+        }
+    }
+    if (ok && type == RecordType::PRR) {
+        for (const STDFRecord* record : records) {
+            const auto& prr = static_cast<const PRRRecord&>(*record);
+            openParts_.erase(siteKey(prr.HEAD_NUM, prr.SITE_NUM));
+        }
+    }
+
+    auto endTime = std::chrono::steady_clock::now();
+    lastBatch_.seconds = std::chrono::duration<double>(endTime - startTime).count();
+    totalBatch_.rows += lastBatch_.rows;
+    totalBatch_.statements += lastBatch_.statements;
+    totalBatch_.seconds += lastBatch_.seconds;
+    return ok;
+}
+
+bool Database::executeBatch(sqlite3_stmt* stmt, const std::vector<const STDFRecord*>& records,
+                            size_t first, size_t count) {
+    int param = 1;
+    for (size_t i = first; i < first + count; ++i) {
+        param = bindRecord(stmt, param, *records[i]);
+    }
+    if (!stepCachedStatement(stmt)) {
+        return false;
+    }
+    lastBatch_.rows += count;
+    lastBatch_.statements++;
+    return true;
+}
+
+int Database::bindRecord(sqlite3_stmt* stmt, int param, const STDFRecord& record) {
+    switch (record.getRecordType()) {
+        case RecordType::FAR: return bindFAR(stmt, param, static_cast<const FARRecord&>(record));
+        case RecordType::MIR: return bindMIR(stmt, param, static_cast<const MIRRecord&>(record));
+        case RecordType::PIR: return bindPIR(stmt, param, static_cast<const PIRRecord&>(record));
+        case RecordType::PRR: return bindPRR(stmt, param, static_cast<const PRRRecord&>(record));
+        case RecordType::PTR: return bindPTR(stmt, param, static_cast<const PTRRecord&>(record));
+        case RecordType::FTR: return bindFTR(stmt, param, static_cast<const FTRRecord&>(record));
+        case RecordType::HBR: return bindHBR(stmt, param, static_cast<const HBRRecord&>(record));
+        case RecordType::SBR: return bindSBR(stmt, param, static_cast<const SBRRecord&>(record));
+        case RecordType::WIR: return bindWIR(stmt, param, static_cast<const WIRRecord&>(record));
+        case RecordType::WRR: return bindWRR(stmt, param, static_cast<const WRRRecord&>(record));
+        default:              return param;
+    }
+}
+
+const char* Database::insertSQL(RecordType type) const {
+    switch (type) {
+        case RecordType::FAR: return INSERT_FAR_SQL;
+        case RecordType::MIR: return INSERT_MIR_SQL;
+        case RecordType::PIR: return INSERT_PIR_SQL;
+        case RecordType::PRR: return INSERT_PRR_SQL;
+        case RecordType::PTR:
+            return schemaMode_ == SchemaMode::Normalized ? INSERT_PTR_RESULT_SQL : INSERT_PTR_SQL;
+        case RecordType::FTR: return INSERT_FTR_SQL;
+        case RecordType::HBR: return INSERT_HBR_SQL;
+        case RecordType::SBR: return INSERT_SBR_SQL;
+        case RecordType::WIR: return INSERT_WIR_SQL;
+        case RecordType::WRR: return INSERT_WRR_SQL;
+        default:              return nullptr;
+    }
+}
+
+std::string Database::multiRowSQL(const char* sql, size_t rows) {
+    // Repeat the "(?, ?, ...)" tuple of a single-row INSERT_*_SQL statement
+    std::string single(sql);
+    size_t values = single.find("VALUES");
+    size_t tupleStart = single.find('(', values);
+    size_t tupleEnd = single.find(')', tupleStart);
+    std::string tuple = single.substr(tupleStart, tupleEnd - tupleStart + 1);
+
+    std::string result = single.substr(0, values) + "VALUES ";
+    result.reserve(result.size() + rows * (tuple.size() + 2));
+    for (size_t i = 0; i < rows; ++i) {
+        if (i > 0) {
+            result += ", ";
+        }
+        result += tuple;
+    }
+    result += ";";
+    return result;
+}
+
 bool Database::beginTransaction() {
-    return executeSQL("BEGIN TRANSACTION;");
+    if (!executeSQL("BEGIN TRANSACTION;")) {
+        return false;
+    }
+    inTransaction_ = true;
+    return true;
 }
 
 bool Database::commitTransaction() {
-    return executeSQL("COMMIT;");
+    // The summary deltas commit atomically with the rows they count
+    if (!flushSummary() || !executeSQL("COMMIT;")) {
+        return false;
+    }
+    inTransaction_ = false;
+    return true;
 }
 
 bool Database::rollbackTransaction() {
+    // test_defs and PIR rows written in the transaction are gone again, and
+    // so are the rows the pending summary deltas count
+    definedTests_.clear();
+    openParts_.clear();
+    discardSummaryDeltas();
+    inTransaction_ = false;
     return executeSQL("ROLLBACK;");
 }
 
@@ -719,6 +1401,17 @@ std::vector<std::string> Database::getAvailablePartTypes() const {
 }
 
 int Database::getRecordCount(const std::string& tableName) const {
+    long long count = 0;
+    if (readSummary(tableName, count)) {
+        for (size_t type = 0; type < RECORD_TYPE_COUNT; ++type) {
+            const char* table = recordTable(static_cast<RecordType>(type));
+            if (table && tableName == table) {
+                count += pendingRows_[type];
+            }
+        }
+        return static_cast<int>(count);
+    }
+
     std::string sql = "SELECT COUNT(*) FROM " + tableName + ";";
     sqlite3_stmt* stmt;
     
@@ -736,39 +1429,188 @@ int Database::getRecordCount(const std::string& tableName) const {
 
 Database::TestStatistics Database::getTestStatistics() const {
     TestStatistics stats = {0, 0, 0, 0.0, 0};
-    
-    // Get total parts
-    sqlite3_stmt* stmt;
-    if (const_cast<Database*>(this)->prepareStatement("SELECT COUNT(*) FROM prr_records;", &stmt)) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            stats.totalParts = sqlite3_column_int(stmt, 0);
-        }
-        sqlite3_finalize(stmt);
-    }
-    
-    // Get passed parts (assuming hard_bin = 1 means pass)
-    if (const_cast<Database*>(this)->prepareStatement("SELECT COUNT(*) FROM prr_records WHERE hard_bin = 1;", &stmt)) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            stats.passedParts = sqlite3_column_int(stmt, 0);
+
+    long long parts = 0;
+    long long passed = 0;
+    long long tests = 0;
+    if (readSummary("prr_records", parts) && readSummary(PASSED_PARTS_KEY, passed) &&
+        readSummary("ptr_records", tests)) {
+        parts += pendingRows_[static_cast<size_t>(RecordType::PRR)];
+        passed += pendingPassedParts_;
+        tests += pendingRows_[static_cast<size_t>(RecordType::PTR)];
+    } else {
+        // No summary table (database from an older version, not yet opened
+        // for loading): part and pass counts in one pass over prr_records
+        // (covered by idx_prr_hard_bin), plus the PTR row count
+        sqlite3_stmt* stmt;
+        const char* sql = "SELECT COUNT(*), COALESCE(SUM(hard_bin = 1), 0), "
+                          "(SELECT COUNT(*) FROM ptr_records) FROM prr_records;";
+        if (const_cast<Database*>(this)->prepareStatement(sql, &stmt)) {
+            if (sqlite3_step(stmt) == SQLITE_ROW) {
+                parts = sqlite3_column_int64(stmt, 0);
+                passed = sqlite3_column_int64(stmt, 1);
+                tests = sqlite3_column_int64(stmt, 2);
+            }
+            sqlite3_finalize(stmt);
         }
-        sqlite3_finalize(stmt);
     }
-    
-    // Calculate failed parts and yield
+
+    stats.totalParts = static_cast<int>(parts);
+    stats.passedParts = static_cast<int>(passed);
+    stats.totalTests = static_cast<int>(tests);
+
+    // Calculate failed parts and yield (hard_bin = 1 means pass)
     stats.failedParts = stats.totalParts - stats.passedParts;
     if (stats.totalParts > 0) {
         stats.yieldPercent = (static_cast<double>(stats.passedParts) / stats.totalParts) * 100.0;
     }
-    
-    // Get total tests
-    if (const_cast<Database*>(this)->prepareStatement("SELECT COUNT(*) FROM ptr_records;", &stmt)) {
+
+    return stats;
+}
+
+const char* Database::recordTable(RecordType type) {
+    switch (type) {
+        case RecordType::FAR: return "far_records";
+        case RecordType::MIR: return "mir_records";
+        case RecordType::PIR: return "pir_records";
+        case RecordType::PRR: return "prr_records";
+        case RecordType::PTR: return "ptr_records";
+        case RecordType::FTR: return "ftr_records";
+        case RecordType::HBR: return "hbr_records";
+        case RecordType::SBR: return "sbr_records";
+        case RecordType::WIR: return "wir_records";
+        case RecordType::WRR: return "wrr_records";
+        default:              return nullptr;
+    }
+}
+
+bool Database::createSummary() {
+    bool exists = false;
+    sqlite3_stmt* stmt = nullptr;
+    if (prepareStatement("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'db_summary';", &stmt)) {
+        exists = sqlite3_step(stmt) == SQLITE_ROW;
+        sqlite3_finalize(stmt);
+    }
+    if (exists) {
+        summaryReady_ = true;
+        return true;
+    }
+
+    // Seed from whatever an older version already loaded, in one statement
+    std::string seed = "INSERT INTO db_summary (key, value) ";
+    for (size_t type = 0; type < RECORD_TYPE_COUNT; ++type) {
+        if (const char* table = recordTable(static_cast<RecordType>(type))) {
+            seed += std::string("SELECT '") + table + "', COUNT(*) FROM " + table + " UNION ALL ";
+        }
+    }
+    seed += std::string("SELECT '") + PASSED_PARTS_KEY + "', COUNT(*) FROM prr_records WHERE hard_bin = 1;";
+
+    if (!executeSQL(CREATE_SUMMARY_TABLE) || !executeSQL(seed)) {
+        return false;
+    }
+    summaryReady_ = true;
+    return true;
+}
+
+void Database::countInserted(RecordType type, size_t rows) {
+    pendingRows_[static_cast<size_t>(type)] += static_cast<long long>(rows);
+}
+
+bool Database::beginWrite() {
+    if (inTransaction_ || !summaryReady_) {
+        return true;
+    }
+    if (!stepStatement(savepointStatement_, "SAVEPOINT insert_write;")) {
+        return false;
+    }
+    inSavepoint_ = true;
+    return true;
+}
+
+bool Database::endWrite(bool ok) {
+    if (inTransaction_) {
+        return ok; // Counted when the transaction commits
+    }
+    if (!inSavepoint_) {
+        // No db_summary to keep in step
+        discardSummaryDeltas();
+        return ok;
+    }
+    inSavepoint_ = false;
+    if (ok && flushSummary() && stepStatement(releaseStatement_, "RELEASE insert_write;")) {
+        return true;
+    }
+
+    // Neither the rows nor their counts stay. test_defs rows written here go
+    // too; re-adding one later is harmless (INSERT OR IGNORE).
+    std::string error = lastError_;
+    stepStatement(rollbackToStatement_, "ROLLBACK TO insert_write;");
+    stepStatement(releaseStatement_, "RELEASE insert_write;");
+    discardSummaryDeltas();
+    definedTests_.clear();
+    lastError_ = error;
+    return false;
+}
+
+bool Database::flushSummary() {
+    if (!summaryReady_) {
+        discardSummaryDeltas();
+        return true;
+    }
+
+    if (!summaryStatement_ &&
+        !prepareStatement("UPDATE db_summary SET value = value + ? WHERE key = ?;", &summaryStatement_)) {
+        summaryStatement_ = nullptr;
+        return false;
+    }
+    sqlite3_stmt* stmt = summaryStatement_;
+    auto add = [&](const char* key, long long delta) {
+        if (delta == 0) {
+            return true;
+        }
+        sqlite3_bind_int64(stmt, 1, delta);
+        sqlite3_bind_text(stmt, 2, key, -1, SQLITE_STATIC);
+        bool done = sqlite3_step(stmt) == SQLITE_DONE;
+        sqlite3_reset(stmt);
+        return done;
+    };
+
+    bool ok = add(PASSED_PARTS_KEY, pendingPassedParts_);
+    for (size_t type = 0; ok && type < RECORD_TYPE_COUNT; ++type) {
+        if (const char* table = recordTable(static_cast<RecordType>(type))) {
+            ok = add(table, pendingRows_[type]);
+        }
+    }
+    if (!ok) {
+        setLastSQLiteError();
+    }
+    sqlite3_clear_bindings(stmt);
+    if (ok) {
+        discardSummaryDeltas();
+    }
+    return ok;
+}
+
+void Database::discardSummaryDeltas() {
+    pendingRows_.fill(0);
+    pendingPassedParts_ = 0;
+}
+
+bool Database::readSummary(const std::string& key, long long& value) const {
+    if (!summaryReady_ || !db_) {
+        return false;
+    }
+    sqlite3_stmt* stmt = nullptr;
+    bool found = false;
+    if (sqlite3_prepare_v2(db_, "SELECT value FROM db_summary WHERE key = ?;", -1, &stmt, nullptr) == SQLITE_OK) {
+        sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_STATIC);
         if (sqlite3_step(stmt) == SQLITE_ROW) {
-            stats.totalTests = sqlite3_column_int(stmt, 0);
+            value = sqlite3_column_int64(stmt, 0);
+            found = true;
         }
-        sqlite3_finalize(stmt);
     }
-    
-    return stats;
+    sqlite3_finalize(stmt);
+    return found;
 }
 
 // Helper methods
@@ -809,6 +1651,68 @@ bool Database::prepareStatement(const std::string& sql, sqlite3_stmt** stmt) {
     return true;
 }
 
+sqlite3_stmt* Database::cachedStatement(RecordType type, const char* sql) {
+    CachedStatement& cached = insertStatements_[static_cast<size_t>(type)];
+    if (!cached.stmt) {
+        if (!prepareStatement(sql, &cached.stmt)) {
+            cached.stmt = nullptr;
+            return nullptr;
+        }
+        cached.stats.prepares++;
+    }
+    cached.stats.executions++;
+    return cached.stmt;
+}
+
+bool Database::stepStatement(sqlite3_stmt*& stmt, const char* sql) {
+    if (!stmt && !prepareStatement(sql, &stmt)) {
+        stmt = nullptr;
+        return false;
+    }
+    return stepCachedStatement(stmt);
+}
+
+bool Database::stepCachedStatement(sqlite3_stmt* stmt) {
+    int result = sqlite3_step(stmt);
+    if (result != SQLITE_DONE) {
+        setLastSQLiteError();
+    }
+    
+    // Reset right away so the statement holds no locks between inserts and
+    // no binding keeps pointing into the caller's record
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return result == SQLITE_DONE;
+}
+
+void Database::finalizeStatements() {
+    for (auto& cached : insertStatements_) {
+        if (cached.stmt) {
+            sqlite3_finalize(cached.stmt);
+            cached.stmt = nullptr;
+        }
+    }
+    for (sqlite3_stmt** stmt : {&testDefStatement_, &summaryStatement_, &savepointStatement_,
+                                &releaseStatement_, &rollbackToStatement_}) {
+        if (*stmt) {
+            sqlite3_finalize(*stmt);
+            *stmt = nullptr;
+        }
+    }
+    for (auto& statements : batchStatements_) {
+        for (auto& stmt : statements) {
+            if (stmt) {
+                sqlite3_finalize(stmt);
+                stmt = nullptr;
+            }
+        }
+    }
+}
+
+Database::StatementStats Database::getStatementStats(RecordType type) const {
+    return insertStatements_[static_cast<size_t>(type)].stats;
+}
+
 void Database::setLastError(const std::string& error) {
     lastError_ = error;
 }
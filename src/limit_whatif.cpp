@@ -0,0 +1,482 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: What-if limit engine: result loading, compare kernels and evaluation
+ *              The AVX2 kernel is compiled per function and chosen at run time
+ */
+
+#include "limit_whatif.h"
+#include "columnar_file.h"
+#include "test_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define STDF_HAVE_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+namespace STDF {
+
+namespace {
+
+int popcount64(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    int count = 0;
+    for (; word; word &= word - 1) count++;
+    return count;
+#endif
+}
+
+int lowestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while (!(word & 1)) { word >>= 1; bit++; }
+    return bit;
+#endif
+}
+
+// Bounds with missing sides opened to infinity
+void bounds(const TestLimits& limits, float& lo, float& hi) {
+    lo = limits.hasLo ? limits.lo : -std::numeric_limits<float>::infinity();
+    hi = limits.hasHi ? limits.hi : std::numeric_limits<float>::infinity();
+}
+
+// Marks values from `begin` (a multiple of 64) to `count`
+size_t markScalar(const float* values, size_t begin, size_t count, float lo, float hi, uint64_t* mask) {
+    size_t failures = 0;
+    for (size_t word = begin; word < count; word += 64) {
+        size_t end = std::min(word + 64, count);
+        uint64_t bits = 0;
+        for (size_t i = word; i < end; ++i) {
+            bits |= static_cast<uint64_t>(values[i] < lo || values[i] > hi) << (i - word);
+        }
+        mask[word / 64] = bits;
+        failures += static_cast<size_t>(popcount64(bits));
+    }
+    return failures;
+}
+
+#ifdef STDF_HAVE_AVX2_KERNEL
+// Eight compares per instruction; eight vectors fill one mask word
+__attribute__((target("avx2")))
+size_t markAvx2(const float* values, size_t count, float lo, float hi, uint64_t* mask) {
+    const __m256 low = _mm256_set1_ps(lo);
+    const __m256 high = _mm256_set1_ps(hi);
+    size_t failures = 0;
+    size_t word = 0;
+    for (; word + 64 <= count; word += 64) {
+        uint64_t bits = 0;
+        for (int lane = 0; lane < 8; ++lane) {
+            __m256 v = _mm256_loadu_ps(values + word + lane * 8);
+            __m256 out = _mm256_or_ps(_mm256_cmp_ps(v, low, _CMP_LT_OQ), _mm256_cmp_ps(v, high, _CMP_GT_OQ));
+            bits |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_ps(out))) << (lane * 8);
+        }
+        mask[word / 64] = bits;
+        failures += static_cast<size_t>(popcount64(bits));
+    }
+    return failures + markScalar(values, word, count, lo, hi, mask);
+}
+#endif
+
+bool parseLimit(const std::string& token, bool& present, float& value) {
+    if (token == "-") {
+        present = false;
+        return true;
+    }
+    try {
+        size_t used = 0;
+        value = std::stof(token, &used);
+        present = true;
+        return used == token.size();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+} // namespace
+
+// === Limits files ===
+
+LimitSet parseLimits(std::istream& in) {
+    LimitSet limits;
+    std::string line;
+    for (size_t lineNumber = 1; std::getline(in, line); ++lineNumber) {
+        line = line.substr(0, line.find('#'));
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream fields(line);
+        std::vector<std::string> tokens;
+        for (std::string token; fields >> token;) {
+            tokens.push_back(token);
+        }
+        if (tokens.empty()) {
+            continue;
+        }
+
+        std::string error;
+        unsigned long testNum = 0;
+        TestLimits entry;
+        if (tokens.size() != 3) {
+            error = "expected TEST_NUM LO HI";
+        } else {
+            try {
+                size_t used = 0;
+                testNum = std::stoul(tokens[0], &used);
+                if (used != tokens[0].size() || testNum > std::numeric_limits<U4>::max()) {
+                    error = "bad test number '" + tokens[0] + "'";
+                }
+            } catch (const std::exception&) {
+                error = "bad test number '" + tokens[0] + "'";
+            }
+            if (error.empty() && !parseLimit(tokens[1], entry.hasLo, entry.lo)) {
+                error = "bad low limit '" + tokens[1] + "'";
+            }
+            if (error.empty() && !parseLimit(tokens[2], entry.hasHi, entry.hi)) {
+                error = "bad high limit '" + tokens[2] + "'";
+            }
+        }
+        if (!error.empty()) {
+            throw std::runtime_error("Limits line " + std::to_string(lineNumber) + ": " + error);
+        }
+        limits[static_cast<U4>(testNum)] = entry;
+    }
+    return limits;
+}
+
+LimitSet loadLimitsFile(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    return parseLimits(in);
+}
+
+// === Compare kernels ===
+
+bool avx2Available() {
+#ifdef STDF_HAVE_AVX2_KERNEL
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+size_t markLimitFailures(const float* values, size_t count, const TestLimits& limits, uint64_t* mask,
+                         LimitKernel kernel) {
+    float lo, hi;
+    bounds(limits, lo, hi);
+    if (kernel == LimitKernel::Auto) {
+        kernel = avx2Available() ? LimitKernel::Avx2 : LimitKernel::Scalar;
+    }
+#ifdef STDF_HAVE_AVX2_KERNEL
+    if (kernel == LimitKernel::Avx2 && avx2Available()) {
+        return markAvx2(values, count, lo, hi, mask);
+    }
+#endif
+    return markScalar(values, 0, count, lo, hi, mask);
+}
+
+// === LimitWhatIf ===
+
+LimitWhatIf::LimitWhatIf(std::unordered_set<U2> passBins)
+    : passBins_(std::move(passBins)), lastTest_(std::numeric_limits<uint32_t>::max()) {}
+
+U4 LimitWhatIf::openPart(U1 headNum, U1 siteNum) const {
+    auto it = openParts_.find(static_cast<uint16_t>((headNum << 8) | siteNum));
+    return it != openParts_.end() ? it->second : std::numeric_limits<U4>::max();
+}
+
+TestColumn& LimitWhatIf::column(U4 testNum) {
+    // Tests usually arrive in the same order for every part
+    if (lastTest_ < tests_.size() && tests_[lastTest_].testNum == testNum) {
+        return tests_[lastTest_];
+    }
+    uint32_t next = lastTest_ + 1;
+    if (next < tests_.size() && tests_[next].testNum == testNum) {
+        lastTest_ = next;
+        return tests_[next];
+    }
+    auto inserted = testIndex_.emplace(testNum, static_cast<uint32_t>(tests_.size()));
+    if (inserted.second) {
+        tests_.emplace_back();
+        tests_.back().testNum = testNum;
+    }
+    lastTest_ = inserted.first->second;
+    return tests_[lastTest_];
+}
+
+void LimitWhatIf::addResult(TestColumn& test, U4 part, U1 testFlg, float result) {
+    if ((testFlg & (PTR_FLG_NOT_EXECUTED | PTR_FLG_RESULT_INVALID)) || std::isnan(result)) {
+        return;
+    }
+    size_t row = test.results.size();
+    if (row % 64 == 0) {
+        test.failedMask.push_back(0);
+    }
+    test.results.push_back(result);
+    test.parts.push_back(part);
+    if (testFlg & PTR_FLG_FAILED) {
+        test.failedMask.back() |= uint64_t{1} << (row % 64);
+        test.failed++;
+        partFlags_[part] |= PART_FLAGGED;
+    }
+}
+
+void LimitWhatIf::onPIR(const PIRRecord& record) {
+    openParts_[static_cast<uint16_t>((record.HEAD_NUM << 8) | record.SITE_NUM)] = static_cast<U4>(partFlags_.size());
+    partFlags_.push_back(0);
+}
+
+void LimitWhatIf::onPRR(const PRRRecord& record) {
+    U4 part = openPart(record.HEAD_NUM, record.SITE_NUM);
+    if (part >= partFlags_.size()) {
+        return;
+    }
+    partFlags_[part] |= PART_DONE;
+    if (passBins_.count(record.HARD_BIN)) {
+        partFlags_[part] |= PART_BIN_PASS;
+    }
+    openParts_.erase(static_cast<uint16_t>((record.HEAD_NUM << 8) | record.SITE_NUM));
+}
+
+void LimitWhatIf::onPTR(const PTRRecord& record) {
+    U4 part = openPart(record.HEAD_NUM, record.SITE_NUM);
+    if (part >= partFlags_.size()) {
+        return;
+    }
+
+    // Keep the limits and name the tester used, for the report
+    TestColumn& test = column(record.TEST_NUM);
+    if (record.OPT_FLAG & PTR_OPT_LO_LIMIT) {
+        test.limits.hasLo = true;
+        test.limits.lo = record.LO_LIMIT;
+    }
+    if (record.OPT_FLAG & PTR_OPT_HI_LIMIT) {
+        test.limits.hasHi = true;
+        test.limits.hi = record.HI_LIMIT;
+    }
+    if (test.testText.empty() && !record.TEST_TXT.empty()) {
+        test.testText = record.TEST_TXT;
+    }
+    addResult(test, part, record.TEST_FLG, record.RESULT);
+}
+
+void LimitWhatIf::onFTR(const FTRRecord& record) {
+    U4 part = openPart(record.HEAD_NUM, record.SITE_NUM);
+    if (part < partFlags_.size() && !(record.TEST_FLG & PTR_FLG_NOT_EXECUTED) && (record.TEST_FLG & PTR_FLG_FAILED)) {
+        partFlags_[part] |= PART_FLAGGED | PART_FTR_FAIL;
+    }
+}
+
+void LimitWhatIf::loadFile(const std::string& path, InputMode mode) {
+    beginFile();
+    if (std::filesystem::path(path).extension() == ".stdfc") {
+        loadColumnar(ColumnarReader(path));
+        return;
+    }
+    STDFParser parser(path, mode);
+    parser.setRecordFilter({RecordType::PIR, RecordType::PRR, RecordType::PTR, RecordType::FTR});
+    parser.parse(*this);
+    if (!parser.getLastError().empty()) {
+        throw std::runtime_error(path + ": " + parser.getLastError());
+    }
+}
+
+void LimitWhatIf::loadColumnar(const ColumnarReader& reader) {
+    const U4 base = static_cast<U4>(partFlags_.size());
+    const U4 outside = std::numeric_limits<U4>::max();
+
+    // PRRs first: they give the number of parts and their bins
+    if (reader.hasTable(RecordType::PRR)) {
+        for (size_t chunk = 0; chunk < reader.getChunkCount(RecordType::PRR); ++chunk) {
+            ColumnSpan<U4> parts = reader.column<U4>(RecordType::PRR, "part_index", chunk);
+            ColumnSpan<U2> bins = reader.column<U2>(RecordType::PRR, "hard_bin", chunk);
+            for (size_t row = 0; row < parts.size; ++row) {
+                if (parts[row] == outside) {
+                    continue;
+                }
+                size_t part = static_cast<size_t>(base) + parts[row];
+                if (part >= partFlags_.size()) {
+                    partFlags_.resize(part + 1, 0);
+                }
+                partFlags_[part] |= PART_DONE;
+                if (passBins_.count(bins[row])) {
+                    partFlags_[part] |= PART_BIN_PASS;
+                }
+            }
+        }
+    }
+
+    if (reader.hasTable(RecordType::FTR)) {
+        for (size_t chunk = 0; chunk < reader.getChunkCount(RecordType::FTR); ++chunk) {
+            ColumnSpan<U4> parts = reader.column<U4>(RecordType::FTR, "part_index", chunk);
+            ColumnSpan<U1> flags = reader.column<U1>(RecordType::FTR, "test_flg", chunk);
+            for (size_t row = 0; row < parts.size; ++row) {
+                size_t part = static_cast<size_t>(base) + parts[row];
+                if (parts[row] != outside && part < partFlags_.size() &&
+                    !(flags[row] & PTR_FLG_NOT_EXECUTED) && (flags[row] & PTR_FLG_FAILED)) {
+                    partFlags_[part] |= PART_FLAGGED | PART_FTR_FAIL;
+                }
+            }
+        }
+    }
+
+    if (reader.hasTable(RecordType::PTR)) {
+        const std::vector<std::string>& names = reader.getDictionary(RecordType::PTR, "test_txt");
+        for (size_t chunk = 0; chunk < reader.getChunkCount(RecordType::PTR); ++chunk) {
+            ColumnSpan<U4> parts = reader.column<U4>(RecordType::PTR, "part_index", chunk);
+            ColumnSpan<U4> testNums = reader.column<U4>(RecordType::PTR, "test_num", chunk);
+            ColumnSpan<U1> flags = reader.column<U1>(RecordType::PTR, "test_flg", chunk);
+            ColumnSpan<float> results = reader.column<float>(RecordType::PTR, "result", chunk);
+            ColumnSpan<U4> texts = reader.column<U4>(RecordType::PTR, "test_txt", chunk);
+            for (size_t row = 0; row < parts.size; ++row) {
+                size_t part = static_cast<size_t>(base) + parts[row];
+                if (parts[row] == outside || part >= partFlags_.size()) {
+                    continue;
+                }
+                TestColumn& test = column(testNums[row]);
+                if (test.testText.empty() && texts[row] < names.size()) {
+                    test.testText = names[texts[row]];
+                }
+                addResult(test, static_cast<U4>(part), flags[row], results[row]);
+            }
+        }
+    }
+}
+
+uint64_t LimitWhatIf::getResultCount() const {
+    uint64_t count = 0;
+    for (const TestColumn& test : tests_) {
+        count += test.results.size();
+    }
+    return count;
+}
+
+WhatIfResult LimitWhatIf::evaluate(const LimitSet& limits, LimitKernel kernel) const {
+    WhatIfResult result;
+    std::vector<uint8_t> failing(partFlags_.size(), 0);
+    std::vector<uint64_t> mask;
+
+    for (const TestColumn& test : tests_) {
+        const uint64_t* bits = test.failedMask.data();
+        auto limit = limits.find(test.testNum);
+        if (limit != limits.end()) {
+            TestWhatIf row;
+            row.testNum = test.testNum;
+            row.testText = test.testText;
+            row.results = test.results.size();
+            row.oldLimits = test.limits;
+            row.newLimits = limit->second;
+            row.oldFails = test.failed;
+            mask.assign(test.failedMask.size(), 0);
+            row.newFails = markLimitFailures(test.results.data(), test.results.size(), limit->second,
+                                             mask.data(), kernel);
+            result.tests.push_back(row);
+            bits = mask.data();
+        }
+
+        // Failures are rare, so walk the set bits rather than every result
+        for (size_t word = 0; word < test.failedMask.size(); ++word) {
+            for (uint64_t set = bits[word]; set; set &= set - 1) {
+                failing[test.parts[word * 64 + static_cast<size_t>(lowestBit(set))]] = 1;
+            }
+        }
+    }
+
+    // Tests in the limit set that never ran still get a row
+    for (const auto& limit : limits) {
+        if (!testIndex_.count(limit.first)) {
+            TestWhatIf row;
+            row.testNum = limit.first;
+            row.newLimits = limit.second;
+            result.tests.push_back(row);
+        }
+    }
+    std::sort(result.tests.begin(), result.tests.end(), [](const TestWhatIf& a, const TestWhatIf& b) {
+        return a.testNum < b.testNum;
+    });
+
+    for (size_t part = 0; part < partFlags_.size(); ++part) {
+        uint8_t flags = partFlags_[part];
+        if (!(flags & PART_DONE)) {
+            continue;
+        }
+        bool binPass = (flags & PART_BIN_PASS) != 0;
+        bool newPass = !failing[part] && !(flags & PART_FTR_FAIL) && (binPass || (flags & PART_FLAGGED));
+        result.parts++;
+        result.binPassed += binPass;
+        result.newPassed += newPass;
+        result.newlyFailing += binPass && !newPass;
+        result.newlyPassing += !binPass && newPass;
+    }
+    return result;
+}
+
+void LimitWhatIf::writeReport(std::ostream& out, const WhatIfResult& result) {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    auto limit = [&out](bool present, float value) {
+        if (present) {
+            out << std::setw(13) << value;
+        } else {
+            out << std::setw(13) << "-";
+        }
+    };
+
+    out << std::fixed << std::setprecision(2)
+        << "Parts:           " << result.parts << "\n"
+        << "Yield (tested):  " << result.oldYield() * 100.0 << "% (" << result.binPassed << " passed)\n"
+        << "Yield (what-if): " << result.newYield() * 100.0 << "% (" << result.newPassed << " passed)\n"
+        << "Yield delta:     " << std::showpos << (result.newYield() - result.oldYield()) * 100.0
+        << std::noshowpos << "%\n"
+        << "Newly failing:   " << result.newlyFailing << "\n"
+        << "Newly passing:   " << result.newlyPassing << "\n\n";
+
+    out.unsetf(std::ios::floatfield);
+    out << std::setprecision(6);
+    out << std::left << std::setw(10) << "TEST" << std::right << std::setw(10) << "RESULTS"
+        << std::setw(13) << "OLD_LO" << std::setw(13) << "OLD_HI"
+        << std::setw(13) << "NEW_LO" << std::setw(13) << "NEW_HI"
+        << std::setw(10) << "OLD_FAILS" << std::setw(10) << "NEW_FAILS" << std::setw(10) << "DELTA"
+        << "  NAME\n";
+    for (const TestWhatIf& test : result.tests) {
+        out << std::left << std::setw(10) << test.testNum << std::right << std::setw(10) << test.results;
+        limit(test.oldLimits.hasLo, test.oldLimits.lo);
+        limit(test.oldLimits.hasHi, test.oldLimits.hi);
+        limit(test.newLimits.hasLo, test.newLimits.lo);
+        limit(test.newLimits.hasHi, test.newLimits.hi);
+        long long delta = static_cast<long long>(test.newFails) - static_cast<long long>(test.oldFails);
+        out << std::setw(10) << test.oldFails << std::setw(10) << test.newFails
+            << std::setw(10) << (delta > 0 ? "+" + std::to_string(delta) : std::to_string(delta))
+            << "  " << test.testText << "\n";
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+} // namespace STDF
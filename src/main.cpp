@@ -20,21 +20,77 @@
 
 #include "stdf_parser.h"
 #include "database.h"
+#include "batch_ingest.h"
+#include "columnar_file.h"
+#include "record_export.h"
+#include "test_stats.h"
+#include "quantile_sketch.h"
+#include "wafer_map.h"
+#include "site_yield.h"
+#include "limit_whatif.h"
 #include "logger.h"
-#include <iostream>
+#include <algorithm>
+#include <cctype>
 #include <chrono>
+#include <iostream>
+#include <filesystem>
 #include <iomanip>
+#include <sstream>
+#include <unordered_set>
 
 void printUsage(const std::string& programName) {
     // Usage information should still go to stdout for help command
-    std::cout << "Usage: " << programName << " [options] <stdf_file>\n";
+    std::cout << "Usage: " << programName << " [options] <stdf_file|directory|glob>...\n";
+    std::cout << "       " << programName << " -d <database> --build-indexes\n";
     std::cout << "\nOptions:\n";
     std::cout << "  -h, --help      Show this help message\n";
     std::cout << "  -d, --database  Specify database file (default: stdf_data.db)\n";
     std::cout << "  -v, --verbose   Enable verbose output\n";
     std::cout << "  -s, --stats     Show statistics after parsing\n";
+    std::cout << "  -m, --mmap      Memory-map the input file instead of stream reads\n";
+    std::cout << "  -j, --jobs <N>  Parse files on N worker threads (default: 1)\n";
+    std::cout << "                  With fewer files than threads, each file is split across them\n";
+    std::cout << "  -t, --types <L> Only load these record types, e.g. PRR,HBR,SBR (default: all)\n";
+    std::cout << "  -p, --pipeline  Parse and write to the database on separate threads (with -j 1)\n";
+    std::cout << "  --profile <P>   SQLite settings: default, bulk (fastest, not crash-safe)\n";
+    std::cout << "                  or production (WAL, readers can query during the load)\n";
+    std::cout << "  --in-memory     Build the database in memory, then write it out in one pass\n";
+    std::cout << "  --defer-indexes Drop the reporting indexes during the load and build them at the end\n";
+    std::cout << "                  (default with --profile bulk)\n";
+    std::cout << "  --build-indexes Drop and rebuild the reporting indexes; works without input files\n";
+    std::cout << "  --schema <S>    Layout for a new database: wide (default) or normalized\n";
+    std::cout << "                  (PTR text and limits stored once per test in test_defs)\n";
+    std::cout << "  -c, --columnar <F> Write PRR/PTR/FTR/HBR/SBR columns to a .stdfc file instead of\n";
+    std::cout << "                  the database\n";
+    std::cout << "  -e, --export <F> Write records as csv or jsonl instead of loading the database\n";
+    std::cout << "  -o, --output <P> Export destination (default: - for stdout); for csv without a\n";
+    std::cout << "                  single -t type, a directory that gets one <type>.csv per record type\n";
+    std::cout << "  --test-stats    Print per-test mean, sigma, min/max, fails and Cp/Cpk per site to\n";
+    std::cout << "                  stdout in one pass over the inputs, without a database\n";
+    std::cout << "  --quantiles     Print P1/P50/P99 of every test's results (bounded-memory sketches,\n";
+    std::cout << "                  scaled by RES_SCAL); .stdfq inputs are merged in as saved sketches\n";
+    std::cout << "  --histogram <N> With --quantiles, add an N-bin histogram per test\n";
+    std::cout << "  --save-sketches <F> With --quantiles, also write the merged sketches to F (.stdfq)\n";
+    std::cout << "  --wafer-maps <D> Write a PPM bin map, a PGM pass/fail map and a .wmap grid per\n";
+    std::cout << "                  wafer (WIR/WRR) into directory D\n";
+    std::cout << "  --pass-bins <L> Hard bins that count as passing, e.g. 1,2 (default: 1)\n";
+    std::cout << "  --site-yield    Print yield, bins and test time per head/site and flag sites whose\n";
+    std::cout << "                  yield or test means stand out from the other sites\n";
+    std::cout << "  --shift-sigma <X> With --site-yield, flag test means at least X sigma from all\n";
+    std::cout << "                  sites (default: 0.5)\n";
+    std::cout << "  --what-if <F>   Re-judge PTR results against the limits in F (TEST_NUM LO HI per line)\n";
+    std::cout << "                  and print the yield delta; inputs may be STDF or .stdfc files\n";
+    std::cout << "\n-c, -e, --test-stats, --quantiles, --wafer-maps, --site-yield and --what-if each\n";
+    std::cout << "replace the database load and cannot be combined.\n";
+    std::cout << "\nDirectories are searched recursively for *.stdf files; quoted globs are expanded.\n";
     std::cout << "\nExample:\n";
     std::cout << "  " << programName << " -d test.db -v -s data/sample.stdf\n";
+    std::cout << "  " << programName << " -e csv -t PTR lot.stdf | gzip > lot_ptr.csv.gz\n";
+    std::cout << "  " << programName << " --site-yield --pass-bins 1,2 -j 4 /data/tester/ft\n";
+    std::cout << "  " << programName << " --what-if new_limits.txt lot.stdfc\n";
+    std::cout << "  " << programName << " --wafer-maps maps --pass-bins 1,2 lot.stdf\n";
+    std::cout << "  " << programName << " -c lot.stdfc /data/tester/2025-07-31\n";
+    std::cout << "  " << programName << " -d lot.db -j 8 /data/tester/2025-07-31 'extra/*.stdf'\n";
 }
 
 void printStatistics(const STDF::Database& db) {
@@ -77,10 +133,32 @@ void printStatistics(const STDF::Database& db) {
 }
 
 int main(int argc, char* argv[]) {
-    std::string stdfFile;
+    std::vector<std::string> inputs;
     std::string dbFile = "stdf_data.db";
     bool verbose = false;
     bool showStats = false;
+    STDF::InputMode inputMode = STDF::InputMode::Stream;
+    size_t jobs = 1;
+    std::vector<STDF::RecordType> recordTypes;
+    bool pipelined = false;
+    STDF::LoadProfile loadProfile = STDF::LoadProfile::Default;
+    bool stageInMemory = false;
+    STDF::SchemaMode schemaMode = STDF::SchemaMode::Wide;
+    bool deferIndexes = false;
+    bool buildIndexes = false;
+    std::string columnarFile;
+    bool exportRecords = false;
+    STDF::ExportFormat exportFormat = STDF::ExportFormat::Csv;
+    std::string exportOutput = "-";
+    bool testStats = false;
+    bool quantiles = false;
+    size_t histogramBins = 0;
+    std::string sketchFile;
+    std::string waferMapDir;
+    std::unordered_set<STDF::U2> passBins = {1};
+    bool siteYield = false;
+    STDF::SiteComparisonOptions siteOptions;
+    std::string limitsFile;
     
     // Initialize logging
     STDF::Logger::init("stdf_parser");
@@ -105,42 +183,523 @@ int main(int argc, char* argv[]) {
             verbose = true;
         } else if (arg == "-s" || arg == "--stats") {
             showStats = true;
+        } else if (arg == "-m" || arg == "--mmap") {
+            inputMode = STDF::InputMode::MemoryMapped;
+        } else if (arg == "-j" || arg == "--jobs") {
+            if (i + 1 < argc) {
+                try {
+                    int value = std::stoi(argv[++i]);
+                    if (value <= 0) {
+                        throw std::invalid_argument("not positive");
+                    }
+                    jobs = static_cast<size_t>(value);
+                } catch (const std::exception&) {
+                    STDF_LOG_ERROR << "Error: Invalid job count: " << argv[i];
+                    STDF::Logger::cleanup();
+                    return 1;
+                }
+            } else {
+                STDF_LOG_ERROR << "Error: --jobs requires a number";
+                STDF::Logger::cleanup();
+                return 1;
+            }
+        } else if (arg == "-p" || arg == "--pipeline") {
+            pipelined = true;
+        } else if (arg == "--profile") {
+            if (i + 1 < argc) {
+                if (!STDF::loadProfileFromName(argv[++i], loadProfile)) {
+                    STDF_LOG_ERROR << "Error: Unknown profile: " << argv[i];
+                    STDF::Logger::cleanup();
+                    return 1;
+                }
+            } else {
+                STDF_LOG_ERROR << "Error: --profile requires default, bulk or production";
+                STDF::Logger::cleanup();
+                return 1;
+            }
+        } else if (arg == "--in-memory") {
+            stageInMemory = true;
+        } else if (arg == "--defer-indexes") {
+            deferIndexes = true;
+        } else if (arg == "--build-indexes") {
+            buildIndexes = true;
+        } else if (arg == "--schema") {
+            if (i + 1 < argc) {
+                if (!STDF::schemaModeFromName(argv[++i], schemaMode)) {
+                    STDF_LOG_ERROR << "Error: Unknown schema: " << argv[i];
+                    STDF::Logger::cleanup();
+                    return 1;
+                }
+            } else {
+                STDF_LOG_ERROR << "Error: --schema requires wide or normalized";
+                STDF::Logger::cleanup();
+                return 1;
+            }
+        } else if (arg == "-c" || arg == "--columnar") {
+            if (i + 1 < argc) {
+                columnarFile = argv[++i];
+            } else {
+                STDF_LOG_ERROR << "Error: --columnar requires a filename";
+                STDF::Logger::cleanup();
+                return 1;
+            }
+        } else if (arg == "-e" || arg == "--export") {
+            if (i + 1 < argc) {
+                if (!STDF::exportFormatFromName(argv[++i], exportFormat)) {
+                    STDF_LOG_ERROR << "Error: Unknown export format: " << argv[i];
+                    STDF::Logger::cleanup();
+                    return 1;
+                }
+                exportRecords = true;
+            } else {
+                STDF_LOG_ERROR << "Error: --export requires csv or jsonl";
+                STDF::Logger::cleanup();
+                return 1;
+            }
+        } else if (arg == "-o" || arg == "--output") {
+            if (i + 1 < argc) {
+                exportOutput = argv[++i];
+            } else {
+                STDF_LOG_ERROR << "Error: --output requires a path";
+                STDF::Logger::cleanup();
+                return 1;
+            }
+        } else if (arg == "--test-stats") {
+            testStats = true;
+        } else if (arg == "--quantiles") {
+            quantiles = true;
+        } else if (arg == "--histogram") {
+            if (i + 1 < argc) {
+                try {
+                    int value = std::stoi(argv[++i]);
+                    if (value < 1) {
+                        throw std::invalid_argument("histogram bins");
+                    }
+                    histogramBins = static_cast<size_t>(value);
+                } catch (const std::exception&) {
+                    STDF_LOG_ERROR << "Error: Invalid bin count: " << argv[i];
+                    STDF::Logger::cleanup();
+                    return 1;
+                }
+            } else {
+                STDF_LOG_ERROR << "Error: --histogram requires a number of bins";
+                STDF::Logger::cleanup();
+                return 1;
+            }
+        } else if (arg == "--save-sketches") {
+            if (i + 1 < argc) {
+                sketchFile = argv[++i];
+            } else {
+                STDF_LOG_ERROR << "Error: --save-sketches requires a filename";
+                STDF::Logger::cleanup();
+                return 1;
+            }
+        } else if (arg == "--wafer-maps") {
+            if (i + 1 < argc) {
+                waferMapDir = argv[++i];
+            } else {
+                STDF_LOG_ERROR << "Error: --wafer-maps requires a directory";
+                STDF::Logger::cleanup();
+                return 1;
+            }
+        } else if (arg == "--pass-bins") {
+            if (i + 1 < argc) {
+                std::stringstream list(argv[++i]);
+                std::string bin;
+                passBins.clear();
+                while (std::getline(list, bin, ',')) {
+                    try {
+                        int value = std::stoi(bin);
+                        if (value < 0 || value > 65535) {
+                            throw std::out_of_range("bin");
+                        }
+                        passBins.insert(static_cast<STDF::U2>(value));
+                    } catch (const std::exception&) {
+                        STDF_LOG_ERROR << "Error: Invalid bin number: " << bin;
+                        STDF::Logger::cleanup();
+                        return 1;
+                    }
+                }
+            } else {
+                STDF_LOG_ERROR << "Error: --pass-bins requires a list of bin numbers";
+                STDF::Logger::cleanup();
+                return 1;
+            }
+        } else if (arg == "--site-yield") {
+            siteYield = true;
+        } else if (arg == "--shift-sigma") {
+            if (i + 1 < argc) {
+                try {
+                    siteOptions.meanShiftSigma = std::stod(argv[++i]);
+                    if (!(siteOptions.meanShiftSigma >= 0.0)) {
+                        throw std::invalid_argument("shift sigma");
+                    }
+                } catch (const std::exception&) {
+                    STDF_LOG_ERROR << "Error: Invalid sigma threshold: " << argv[i];
+                    STDF::Logger::cleanup();
+                    return 1;
+                }
+            } else {
+                STDF_LOG_ERROR << "Error: --shift-sigma requires a number";
+                STDF::Logger::cleanup();
+                return 1;
+            }
+        } else if (arg == "--what-if") {
+            if (i + 1 < argc) {
+                limitsFile = argv[++i];
+            } else {
+                STDF_LOG_ERROR << "Error: --what-if requires a limits file";
+                STDF::Logger::cleanup();
+                return 1;
+            }
+        } else if (arg == "-t" || arg == "--types") {
+            if (i + 1 < argc) {
+                std::stringstream list(argv[++i]);
+                std::string name;
+                while (std::getline(list, name, ',')) {
+                    STDF::RecordType type;
+                    if (!STDF::recordTypeFromName(name, type)) {
+                        STDF_LOG_ERROR << "Error: Unknown record type: " << name;
+                        STDF::Logger::cleanup();
+                        return 1;
+                    }
+                    recordTypes.push_back(type);
+                }
+            } else {
+                STDF_LOG_ERROR << "Error: --types requires a list of record types";
+                STDF::Logger::cleanup();
+                return 1;
+            }
         } else if (arg[0] == '-') {
             STDF_LOG_ERROR << "Unknown option: " << arg;
             STDF::Logger::cleanup();
             printUsage(argv[0]);
             return 1;
         } else {
-            if (stdfFile.empty()) {
-                stdfFile = arg;
-            } else {
-                STDF_LOG_ERROR << "Error: Multiple STDF files specified";
-                STDF::Logger::cleanup();
-                return 1;
-            }
+            inputs.push_back(arg);
+        }
+    }
+    
+    // The modes below each run on their own instead of the database load
+    int modes = testStats + quantiles + siteYield + exportRecords + !limitsFile.empty() +
+                !waferMapDir.empty() + !columnarFile.empty();
+    if (modes > 1) {
+        STDF_LOG_ERROR << "Error: Only one of -c, -e, --test-stats, --quantiles, --wafer-maps, "
+                       << "--site-yield and --what-if can be given";
+        STDF::Logger::cleanup();
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    if (inputs.empty() && buildIndexes) {
+        STDF::Database database(dbFile);
+        auto start = std::chrono::steady_clock::now();
+        bool built = database.open() && database.createTables() &&
+                     database.dropIndexes() && database.createIndexes();
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+        if (!built) {
+            STDF_LOG_ERROR << "Error: Failed to build indexes: " << database.getLastError();
+            STDF::Logger::cleanup();
+            return 1;
         }
+        STDF_LOG_INFO << "Rebuilt indexes on " << dbFile << " in "
+                      << static_cast<long>(elapsed.count() * 1000.0) << " ms";
+        STDF::Logger::cleanup();
+        return 0;
     }
     
-    if (stdfFile.empty()) {
+    if (inputs.empty()) {
         STDF_LOG_ERROR << "Error: No STDF file specified";
         STDF::Logger::cleanup();
         printUsage(argv[0]);
         return 1;
     }
     
+    std::vector<std::string> stdfFiles = STDF::expandInputPaths(inputs);
+    if (stdfFiles.empty()) {
+        STDF_LOG_ERROR << "Error: No STDF files found";
+        STDF::Logger::cleanup();
+        return 1;
+    }
+    
     STDF_LOG_INFO << "STDF Parser v1.0 starting";
-    STDF_LOG_INFO << "Input file: " << stdfFile;
+    if (stdfFiles.size() == 1) {
+        STDF_LOG_INFO << "Input file: " << stdfFiles.front();
+    } else {
+        STDF_LOG_INFO << "Input files: " << stdfFiles.size();
+    }
     STDF_LOG_INFO << "Database: " << dbFile;
+    STDF_LOG_INFO << "Load profile: " << STDF::loadProfileName(loadProfile)
+                  << (stageInMemory ? " (staged in memory)" : "");
     STDF_LOG_INFO << "Verbose: " << (verbose ? "Yes" : "No");
+    STDF_LOG_INFO << "Input mode: " << (inputMode == STDF::InputMode::MemoryMapped ? "mmap" : "stream");
+    STDF_LOG_INFO << "Worker threads: " << jobs;
+    if (pipelined && jobs > 1) {
+        STDF_LOG_WARNING << "--pipeline only applies with a single worker; ignoring it";
+        pipelined = false;
+    }
+    STDF_LOG_INFO << "Pipelined: " << (pipelined ? "Yes" : "No");
+    if (!recordTypes.empty()) {
+        std::string typeList;
+        for (auto type : recordTypes) {
+            typeList += (typeList.empty() ? "" : ",") + std::string(STDF::recordTypeName(type));
+        }
+        STDF_LOG_INFO << "Record types: " << typeList;
+    }
+    
+    if (testStats) {
+        try {
+            auto start = std::chrono::steady_clock::now();
+            STDF::TestStatsAccumulator stats = STDF::collectRecords<STDF::TestStatsAccumulator>(stdfFiles, jobs, inputMode,
+                                                                                   {STDF::RecordType::PTR});
+            STDF::TestStatsAccumulator::writeReport(std::cout, stats.getResults());
+            std::cout.flush();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            STDF_LOG_INFO << "Test statistics for " << stats.size() << " test/site pairs from "
+                          << stdfFiles.size() << " files in " << static_cast<long>(seconds * 1000.0) << " ms";
+        } catch (const std::exception& e) {
+            STDF_LOG_ERROR << "Error: " << e.what();
+            STDF::Logger::cleanup();
+            return 1;
+        }
+        STDF::Logger::cleanup();
+        return 0;
+    }
+    
+    if (!limitsFile.empty()) {
+        try {
+            auto start = std::chrono::steady_clock::now();
+            STDF::LimitSet limits = STDF::loadLimitsFile(limitsFile);
+            STDF::LimitWhatIf engine(passBins);
+            for (const std::string& file : stdfFiles) {
+                engine.loadFile(file, inputMode);
+            }
+            auto loaded = std::chrono::steady_clock::now();
+            STDF::WhatIfResult result = engine.evaluate(limits);
+            auto evaluated = std::chrono::steady_clock::now();
+            STDF::LimitWhatIf::writeReport(std::cout, result);
+            std::cout.flush();
+            STDF_LOG_INFO << "What-if over " << engine.getPartCount() << " parts and " << engine.getResultCount()
+                          << " results: loaded in "
+                          << std::chrono::duration_cast<std::chrono::milliseconds>(loaded - start).count()
+                          << " ms, evaluated " << limits.size() << " limits in "
+                          << std::chrono::duration_cast<std::chrono::microseconds>(evaluated - loaded).count()
+                          << " us (" << (STDF::avx2Available() ? "AVX2" : "scalar") << ")";
+        } catch (const std::exception& e) {
+            STDF_LOG_ERROR << "Error: " << e.what();
+            STDF::Logger::cleanup();
+            return 1;
+        }
+        STDF::Logger::cleanup();
+        return 0;
+    }
+    
+    if (siteYield) {
+        try {
+            auto start = std::chrono::steady_clock::now();
+            STDF::SiteYieldAccumulator sites = STDF::collectRecords<STDF::SiteYieldAccumulator>(
+                stdfFiles, jobs, inputMode, {STDF::RecordType::PRR, STDF::RecordType::PTR},
+                STDF::SiteYieldAccumulator(passBins));
+            sites.writeReport(std::cout, siteOptions);
+            std::cout.flush();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            STDF_LOG_INFO << "Site yield for " << sites.getSites().size() << " sites and "
+                          << sites.totalParts() << " parts from " << stdfFiles.size() << " files in "
+                          << static_cast<long>(seconds * 1000.0) << " ms";
+        } catch (const std::exception& e) {
+            STDF_LOG_ERROR << "Error: " << e.what();
+            STDF::Logger::cleanup();
+            return 1;
+        }
+        STDF::Logger::cleanup();
+        return 0;
+    }
+    
+    if (quantiles) {
+        try {
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::string> stdfInputs;
+            std::vector<std::string> sketchInputs;
+            for (const std::string& file : stdfFiles) {
+                bool saved = std::filesystem::path(file).extension() == ".stdfq";
+                (saved ? sketchInputs : stdfInputs).push_back(file);
+            }
+            STDF::TestQuantiles sketches = STDF::collectRecords<STDF::TestQuantiles>(stdfInputs, jobs, inputMode,
+                                                                                   {STDF::RecordType::PTR});
+            for (const std::string& file : sketchInputs) {
+                sketches.merge(STDF::TestQuantiles::load(file));
+            }
+            if (!sketchFile.empty()) {
+                sketches.save(sketchFile);
+            }
+            STDF::TestQuantiles::writeReport(std::cout, sketches.getResults(), histogramBins);
+            std::cout.flush();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            STDF_LOG_INFO << "Quantiles for " << sketches.size() << " tests from " << stdfInputs.size()
+                          << " STDF files and " << sketchInputs.size() << " sketch files in "
+                          << static_cast<long>(seconds * 1000.0) << " ms";
+        } catch (const std::exception& e) {
+            STDF_LOG_ERROR << "Error: " << e.what();
+            STDF::Logger::cleanup();
+            return 1;
+        }
+        STDF::Logger::cleanup();
+        return 0;
+    }
+    
+    if (!waferMapDir.empty()) {
+        try {
+            auto start = std::chrono::steady_clock::now();
+            std::filesystem::create_directories(waferMapDir);
+            std::unordered_set<std::string> names;
+            size_t wafers = 0;
+            size_t skipped = 0;
+            for (const std::string& file : stdfFiles) {
+                std::vector<STDF::WaferMap> maps;
+                try {
+                    maps = STDF::loadWaferMaps(file, inputMode);
+                } catch (const std::exception& e) {
+                    STDF_LOG_ERROR << e.what() << " (skipped)";
+                    skipped++;
+                    continue;
+                }
+                for (const STDF::WaferMap& map : maps) {
+                    // File names from the wafer ID, made unique across inputs
+                    std::string name = map.waferId;
+                    std::replace_if(name.begin(), name.end(), [](char c) {
+                        return !std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_' && c != '.';
+                    }, '_');
+                    if (name.empty()) {
+                        name = "wafer";
+                    }
+                    std::string unique = name;
+                    for (size_t n = 2; !names.insert(unique).second; ++n) {
+                        unique = name + "_" + std::to_string(n);
+                    }
+                    std::string base = (std::filesystem::path(waferMapDir) / unique).string();
+                    map.writePPM(base + ".ppm", passBins);
+                    map.writePGM(base + ".pgm", passBins);
+                    map.save(base + ".wmap");
+                    if (verbose) {
+                        STDF_LOG_DEBUG << file << ": wafer '" << map.waferId << "' " << map.width << "x"
+                                       << map.height << ", " << map.dieCount << " dies";
+                    }
+                    wafers++;
+                }
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            STDF_LOG_INFO << "Wrote maps of " << wafers << " wafers to " << waferMapDir << " in "
+                          << static_cast<long>(seconds * 1000.0) << " ms";
+            if (skipped > 0) {
+                STDF_LOG_ERROR << skipped << " of " << stdfFiles.size() << " files skipped after parse errors";
+                STDF::Logger::cleanup();
+                return 1;
+            }
+        } catch (const std::exception& e) {
+            STDF_LOG_ERROR << "Error: " << e.what();
+            STDF::Logger::cleanup();
+            return 1;
+        }
+        STDF::Logger::cleanup();
+        return 0;
+    }
     
+    if (exportRecords) {
+        bool toStdout = exportOutput == "-";
+        if (exportFormat == STDF::ExportFormat::Csv && toStdout && recordTypes.size() != 1) {
+            STDF_LOG_ERROR << "Error: CSV export to stdout needs exactly one record type (-t); "
+                           << "use -o <directory> for all types";
+            STDF::Logger::cleanup();
+            return 1;
+        }
+        try {
+            auto start = std::chrono::steady_clock::now();
+            std::unique_ptr<STDF::RecordExporter> exporter;
+            if (exportFormat == STDF::ExportFormat::Csv) {
+                exporter = toStdout ? std::make_unique<STDF::CsvExporter>(stdout, recordTypes.front())
+                                    : std::make_unique<STDF::CsvExporter>(exportOutput);
+            } else {
+                exporter = toStdout ? std::make_unique<STDF::JsonLinesExporter>(stdout)
+                                    : std::make_unique<STDF::JsonLinesExporter>(exportOutput);
+            }
+            for (const std::string& file : stdfFiles) {
+                STDF::STDFParser parser(file, inputMode);
+                if (!recordTypes.empty()) {
+                    parser.setRecordFilter(recordTypes);
+                }
+                parser.parse(*exporter);
+                if (!parser.getLastError().empty()) {
+                    throw std::runtime_error(file + ": " + parser.getLastError());
+                }
+            }
+            exporter->finish();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            STDF_LOG_INFO << "Exported " << exporter->getRowCount() << " records ("
+                          << exporter->getBytesWritten() << " bytes) as "
+                          << STDF::exportFormatName(exportFormat) << " in "
+                          << static_cast<long>(seconds * 1000.0) << " ms";
+        } catch (const std::exception& e) {
+            STDF_LOG_ERROR << "Error: " << e.what();
+            STDF::Logger::cleanup();
+            return 1;
+        }
+        STDF::Logger::cleanup();
+        return 0;
+    }
+    
+    if (!columnarFile.empty()) {
+        try {
+            auto start = std::chrono::steady_clock::now();
+            STDF::ColumnarWriter writer(columnarFile);
+            for (const std::string& file : stdfFiles) {
+                writer.beginFile();
+                STDF::STDFParser parser(file, inputMode);
+                parser.setRecordFilter({STDF::RecordType::PIR, STDF::RecordType::PRR, STDF::RecordType::PTR,
+                                        STDF::RecordType::FTR, STDF::RecordType::HBR, STDF::RecordType::SBR});
+                size_t records = parser.parse(writer);
+                if (!parser.getLastError().empty()) {
+                    throw std::runtime_error(file + ": " + parser.getLastError());
+                }
+                if (verbose) {
+                    STDF_LOG_DEBUG << file << ": " << records << " records";
+                }
+            }
+            writer.finish();
+            auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+            STDF_LOG_INFO << "Wrote " << writer.getRowCount(STDF::RecordType::PTR) << " PTR and "
+                          << writer.getRowCount(STDF::RecordType::PRR) << " PRR rows to " << columnarFile
+                          << " in " << static_cast<long>(elapsed.count() * 1000.0) << " ms";
+        } catch (const std::exception& e) {
+            STDF_LOG_ERROR << "Error: " << e.what();
+            // A partial file would read back as a complete lot
+            std::error_code ec;
+            std::filesystem::remove(columnarFile, ec);
+            STDF::Logger::cleanup();
+            return 1;
+        }
+        STDF::Logger::cleanup();
+        return 0;
+    }
+    
+    int exitCode = 0;
     try {
         // Initialize database
-        STDF::Database database(dbFile);
+        STDF::Database database(dbFile, loadProfile);
+        database.setInMemoryStaging(stageInMemory);
+        database.setSchemaMode(schemaMode);
+        if (deferIndexes || buildIndexes) {
+            database.setDeferIndexes(true);
+        }
         if (!database.open()) {
             STDF_LOG_ERROR << "Error: Failed to open database: " << database.getLastError();
             STDF::Logger::cleanup();
             return 1;
         }
+        if (database.getSchemaMode() != schemaMode) {
+            STDF_LOG_WARNING << "Existing database uses the " << STDF::schemaModeName(database.getSchemaMode())
+                             << " schema; keeping it";
+        }
+        STDF_LOG_INFO << "Schema: " << STDF::schemaModeName(database.getSchemaMode());
         
         if (!database.createTables()) {
             STDF_LOG_ERROR << "Error: Failed to create database tables: " << database.getLastError();
@@ -152,75 +711,71 @@ int main(int argc, char* argv[]) {
             STDF_LOG_DEBUG << "Database initialized successfully";
         }
         
-        // Initialize parser
-        STDF::STDFParser parser(stdfFile);
-        
-        if (verbose) {
-            STDF_LOG_DEBUG << "File size: " << parser.getFileSize() << " bytes";
-            STDF_LOG_DEBUG << "Starting to parse...";
-        }
-        
-        // Start timing
-        auto startTime = std::chrono::high_resolution_clock::now();
-        
-        // Begin database transaction for better performance
-        if (!database.beginTransaction()) {
-            STDF_LOG_WARNING << "Warning: Failed to begin transaction: " << database.getLastError();
+        STDF::BatchIngest ingest(database, jobs, inputMode);
+        ingest.setVerbose(verbose);
+        ingest.setPipelined(pipelined);
+        if (!recordTypes.empty()) {
+            ingest.setRecordFilter(recordTypes);
         }
         
-        // Parse records and insert into database
-        size_t recordCount = 0;
-        size_t insertedCount = 0;
+        auto summary = ingest.run(stdfFiles);
         
-        while (!parser.isEndOfFile()) {
-            auto record = parser.parseNextRecord();
-            if (record) {
-                recordCount++;
-                
-                if (verbose && recordCount % 1000 == 0) {
-                    STDF_LOG_DEBUG << "Processed " << recordCount << " records...";
-                }
-                
-                if (database.insertRecord(*record)) {
-                    insertedCount++;
-                } else {
-                    if (verbose) {
-                        STDF_LOG_WARNING << "Warning: Failed to insert record " << recordCount 
-                                  << ": " << database.getLastError();
-                    }
-                }
-                
-                // Optional: log record details in verbose mode
-                if (verbose && recordCount <= 10) {
-                    STDF_LOG_DEBUG << "Record " << recordCount << ": " << record->toString();
-                }
+        if (database.isDeferringIndexes()) {
+            auto indexStart = std::chrono::steady_clock::now();
+            if (!database.createIndexes()) {
+                STDF_LOG_ERROR << "Error: Failed to build indexes: " << database.getLastError();
+                STDF::Logger::cleanup();
+                return 1;
             }
+            auto indexTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - indexStart);
+            STDF_LOG_INFO << "Built indexes in " << static_cast<long>(indexTime.count() * 1000.0) << " ms";
         }
         
-        // Commit transaction
-        if (!database.commitTransaction()) {
-            STDF_LOG_WARNING << "Warning: Failed to commit transaction: " << database.getLastError();
+        if (stageInMemory) {
+            auto flushStart = std::chrono::steady_clock::now();
+            if (!database.flush()) {
+                STDF_LOG_ERROR << "Error: " << database.getLastError();
+                STDF::Logger::cleanup();
+                return 1;
+            }
+            auto flushTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - flushStart);
+            STDF_LOG_INFO << "Wrote staged database in " << static_cast<long>(flushTime.count() * 1000.0) << " ms";
         }
         
-        // End timing
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-        
         STDF_LOG_INFO << "=== Parsing Complete ===";
-        STDF_LOG_INFO << "Total records parsed: " << recordCount;
-        STDF_LOG_INFO << "Records inserted: " << insertedCount;
-        STDF_LOG_INFO << "Processing time: " << duration.count() << " ms";
+        STDF_LOG_INFO << "Files loaded: " << (summary.files.size() - summary.filesFailed)
+                      << " of " << summary.files.size();
+        STDF_LOG_INFO << "Total records parsed: " << summary.totalRecords;
+        STDF_LOG_INFO << "Records inserted: " << summary.totalInserted;
+        STDF_LOG_INFO << "Processing time: " << static_cast<long>(summary.elapsedSeconds * 1000.0) << " ms";
         
-        if (recordCount > 0) {
-            double recordsPerSecond = (recordCount * 1000.0) / duration.count();
+        if (summary.totalRecords > 0) {
             STDF_LOG_INFO << "Processing rate: " << std::fixed << std::setprecision(1) 
-                      << recordsPerSecond << " records/second";
+                      << summary.recordsPerSecond() << " records/second, "
+                      << summary.megabytesPerSecond() << " MB/second";
+        }
+        
+        if (pipelined) {
+            const auto& stages = summary.pipeline;
+            STDF_LOG_INFO << "Pipeline batches: " << stages.batches;
+            STDF_LOG_INFO << "Parse stage: " << std::fixed << std::setprecision(3)
+                          << stages.parseBusySeconds << " s busy, " << stages.parseIdleSeconds << " s idle";
+            STDF_LOG_INFO << "Write stage: " << std::fixed << std::setprecision(3)
+                          << stages.writeBusySeconds << " s busy, " << stages.writeIdleSeconds << " s idle";
+        }
+        
+        for (const auto& result : summary.files) {
+            if (!result.committed) {
+                STDF_LOG_ERROR << "Failed: " << result.filename << ": " << result.error;
+            }
         }
         
         if (showStats) {
             printStatistics(database);
         }
         
+        exitCode = summary.filesFailed > 0 ? 1 : 0;
+        
     } catch (const std::exception& e) {
         STDF_LOG_ERROR << "Error: " << e.what();
         STDF::Logger::cleanup();
@@ -228,5 +783,5 @@ int main(int argc, char* argv[]) {
     }
     
     STDF::Logger::cleanup();
-    return 0;
+    return exitCode;
 }
\ No newline at end of file
@@ -0,0 +1,518 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: KLL sketch compaction, merge, serialization and the quantile report
+ *              Level capacities shrink geometrically (2/3) below the top level
+ */
+
+#include "quantile_sketch.h"
+#include "test_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+namespace STDF {
+
+namespace {
+
+const char QUANTILES_MAGIC[8] = {'S', 'T', 'D', 'F', 'Q', 'N', 'T', '1'};
+
+// Smallest capacity of any level
+const size_t MIN_LEVEL_CAPACITY = 8;
+
+// Little-endian writers and a bounds-checked reader for the serialized form
+void putU(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void putFloat(std::vector<uint8_t>& out, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putU(out, bits, 4);
+}
+
+void putString(std::vector<uint8_t>& out, const std::string& value) {
+    size_t length = std::min<size_t>(value.size(), UINT16_MAX);
+    putU(out, length, 2);
+    out.insert(out.end(), value.begin(), value.begin() + static_cast<std::ptrdiff_t>(length));
+}
+
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : data_(data), size_(size), pos_(0) {}
+
+    uint64_t u(int bytes) {
+        require(static_cast<size_t>(bytes));
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(data_[pos_++]) << (8 * i);
+        }
+        return value;
+    }
+
+    float f32() {
+        uint32_t bits = static_cast<uint32_t>(u(4));
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string string() {
+        size_t length = static_cast<size_t>(u(2));
+        require(length);
+        std::string value(reinterpret_cast<const char*>(data_ + pos_), length);
+        pos_ += length;
+        return value;
+    }
+
+    size_t position() const { return pos_; }
+    const uint8_t* current() const { return data_ + pos_; }
+    size_t remaining() const { return size_ - pos_; }
+
+    void skip(size_t bytes) {
+        require(bytes);
+        pos_ += bytes;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_;
+
+    void require(size_t bytes) const {
+        if (bytes > size_ - pos_) {
+            throw std::runtime_error("Corrupt quantile sketch: data is truncated");
+        }
+    }
+};
+
+} // namespace
+
+// === KllSketch ===
+
+KllSketch::KllSketch(uint16_t k)
+    : k_(std::max<uint16_t>(k, MIN_LEVEL_CAPACITY)), n_(0),
+      min_(std::numeric_limits<float>::quiet_NaN()), max_(std::numeric_limits<float>::quiet_NaN()),
+      levels_(1), retained_(0), random_(0x9E3779B97F4A7C15ull) {
+    limit_ = totalCapacity();
+}
+
+size_t KllSketch::capacity(size_t level) const {
+    size_t depth = levels_.size() - 1 - level;
+    double capacity = std::ceil(k_ * std::pow(2.0 / 3.0, static_cast<double>(depth)));
+    return std::max(MIN_LEVEL_CAPACITY, static_cast<size_t>(capacity));
+}
+
+size_t KllSketch::totalCapacity() const {
+    size_t total = 0;
+    for (size_t level = 0; level < levels_.size(); ++level) {
+        total += capacity(level);
+    }
+    return total;
+}
+
+void KllSketch::add(float value) {
+    if (n_ == 0) {
+        min_ = max_ = value;
+    } else {
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+    n_++;
+    levels_[0].push_back(value);
+    if (++retained_ > limit_) {
+        compress();
+    }
+}
+
+void KllSketch::compress() {
+    while (retained_ > limit_) {
+        // Compact the lowest level that is at capacity
+        size_t level = 0;
+        while (levels_[level].size() < capacity(level)) {
+            level++;
+        }
+        if (level + 1 == levels_.size()) {
+            levels_.emplace_back();
+            limit_ = totalCapacity();
+        }
+
+        std::vector<float>& items = levels_[level];
+        std::vector<float>& above = levels_[level + 1];
+        std::sort(items.begin(), items.end());
+
+        // An odd item out stays behind at this level
+        bool odd = items.size() % 2 != 0;
+        float leftover = odd ? items.back() : 0.0f;
+        if (odd) {
+            items.pop_back();
+        }
+
+        random_ ^= random_ << 13;
+        random_ ^= random_ >> 7;
+        random_ ^= random_ << 17;
+        for (size_t i = random_ & 1; i < items.size(); i += 2) {
+            above.push_back(items[i]);
+        }
+        retained_ -= items.size() / 2;
+        items.clear();
+        if (odd) {
+            items.push_back(leftover);
+        }
+    }
+}
+
+void KllSketch::merge(const KllSketch& other) {
+    if (other.n_ == 0) {
+        return;
+    }
+    if (n_ == 0) {
+        min_ = other.min_;
+        max_ = other.max_;
+    } else {
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+    n_ += other.n_;
+
+    if (other.levels_.size() > levels_.size()) {
+        levels_.resize(other.levels_.size());
+        limit_ = totalCapacity();
+    }
+    for (size_t level = 0; level < other.levels_.size(); ++level) {
+        levels_[level].insert(levels_[level].end(), other.levels_[level].begin(), other.levels_[level].end());
+        retained_ += other.levels_[level].size();
+    }
+    compress();
+}
+
+std::vector<std::pair<float, uint64_t>> KllSketch::weightedItems() const {
+    std::vector<std::pair<float, uint64_t>> items;
+    items.reserve(retained_);
+    for (size_t level = 0; level < levels_.size(); ++level) {
+        for (float value : levels_[level]) {
+            items.emplace_back(value, uint64_t{1} << level);
+        }
+    }
+    std::sort(items.begin(), items.end(),
+              [](const std::pair<float, uint64_t>& a, const std::pair<float, uint64_t>& b) {
+                  return a.first < b.first;
+              });
+    return items;
+}
+
+double KllSketch::quantile(double q) const {
+    return quantiles({q}).front();
+}
+
+std::vector<double> KllSketch::quantiles(const std::vector<double>& ranks) const {
+    std::vector<double> values;
+    values.reserve(ranks.size());
+    if (n_ == 0) {
+        values.assign(ranks.size(), std::numeric_limits<double>::quiet_NaN());
+        return values;
+    }
+
+    std::vector<std::pair<float, uint64_t>> items = weightedItems();
+    std::vector<uint64_t> cumulative(items.size());
+    uint64_t total = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+        total += items[i].second;
+        cumulative[i] = total;
+    }
+
+    for (double q : ranks) {
+        if (q <= 0.0) {
+            values.push_back(min_);
+        } else if (q >= 1.0) {
+            values.push_back(max_);
+        } else {
+            // First item whose cumulative weight reaches q * n
+            double target = std::ceil(q * static_cast<double>(total));
+            auto it = std::lower_bound(cumulative.begin(), cumulative.end(), static_cast<uint64_t>(target));
+            size_t index = std::min(static_cast<size_t>(it - cumulative.begin()), items.size() - 1);
+            values.push_back(items[index].first);
+        }
+    }
+    return values;
+}
+
+std::vector<uint64_t> KllSketch::histogram(double lo, double hi, size_t bins) const {
+    std::vector<uint64_t> counts(bins, 0);
+    if (bins == 0 || !(hi >= lo)) {
+        return counts;
+    }
+    double width = (hi - lo) / static_cast<double>(bins);
+    for (size_t level = 0; level < levels_.size(); ++level) {
+        uint64_t weight = uint64_t{1} << level;
+        for (float value : levels_[level]) {
+            if (!(value >= lo && value <= hi)) {
+                continue;
+            }
+            size_t bin = width > 0.0 ? static_cast<size_t>((value - lo) / width) : 0;
+            counts[std::min(bin, bins - 1)] += weight;
+        }
+    }
+    return counts;
+}
+
+void KllSketch::serialize(std::vector<uint8_t>& out) const {
+    putU(out, k_, 2);
+    putU(out, n_, 8);
+    putFloat(out, min_);
+    putFloat(out, max_);
+    putU(out, levels_.size(), 1);
+    for (const std::vector<float>& items : levels_) {
+        putU(out, items.size(), 4);
+        for (float value : items) {
+            putFloat(out, value);
+        }
+    }
+}
+
+KllSketch KllSketch::deserialize(const uint8_t* data, size_t size, size_t& consumed) {
+    ByteReader in(data, size);
+    KllSketch sketch(static_cast<uint16_t>(in.u(2)));
+    sketch.n_ = in.u(8);
+    sketch.min_ = in.f32();
+    sketch.max_ = in.f32();
+
+    size_t levelCount = static_cast<size_t>(in.u(1));
+    if (levelCount == 0 || levelCount > 64) {
+        throw std::runtime_error("Corrupt quantile sketch: bad level count");
+    }
+    sketch.levels_.assign(levelCount, {});
+    uint64_t weight = 0;
+    for (size_t level = 0; level < levelCount; ++level) {
+        size_t items = static_cast<size_t>(in.u(4));
+        if (items > size) {
+            throw std::runtime_error("Corrupt quantile sketch: bad level size");
+        }
+        sketch.levels_[level].reserve(items);
+        for (size_t i = 0; i < items; ++i) {
+            sketch.levels_[level].push_back(in.f32());
+        }
+        sketch.retained_ += items;
+        weight += static_cast<uint64_t>(items) << level;
+    }
+    // Compaction preserves total weight exactly
+    if (weight != sketch.n_) {
+        throw std::runtime_error("Corrupt quantile sketch: item weights do not match the count");
+    }
+    sketch.limit_ = sketch.totalCapacity();
+    consumed = in.position();
+    return sketch;
+}
+
+// === TestDistribution ===
+
+double TestDistribution::scale() const {
+    return hasResScale ? std::pow(10.0, resScale) : 1.0;
+}
+
+std::string TestDistribution::scaledUnits() const {
+    if (!hasResScale || units.empty()) {
+        return units;
+    }
+    // Prefixes for the RES_SCAL values defined by STDF
+    switch (resScale) {
+        case 15: return "f" + units;
+        case 12: return "p" + units;
+        case 9: return "n" + units;
+        case 6: return "u" + units;
+        case 3: return "m" + units;
+        case 2: return "%" + units;
+        case 0: return units;
+        case -3: return "K" + units;
+        case -6: return "M" + units;
+        case -9: return "G" + units;
+        case -12: return "T" + units;
+        default: return units + "e" + std::to_string(-resScale);
+    }
+}
+
+// === TestQuantiles ===
+
+TestDistribution& TestQuantiles::entry(U4 testNum) {
+    auto it = tests_.find(testNum);
+    if (it == tests_.end()) {
+        TestDistribution test;
+        test.testNum = testNum;
+        test.sketch = KllSketch(k_);
+        it = tests_.emplace(testNum, std::move(test)).first;
+    }
+    return it->second;
+}
+
+void TestQuantiles::onPTR(const PTRRecord& record) {
+    if ((record.TEST_FLG & (PTR_FLG_NOT_EXECUTED | PTR_FLG_RESULT_INVALID)) || std::isnan(record.RESULT)) {
+        return;
+    }
+    TestDistribution& test = entry(record.TEST_NUM);
+    if (!test.hasResScale && (record.OPT_FLAG & PTR_OPT_RES_SCAL)) {
+        test.hasResScale = true;
+        test.resScale = record.RES_SCAL;
+    }
+    if (test.testText.empty() && !record.TEST_TXT.empty()) {
+        test.testText = record.TEST_TXT;
+    }
+    if (test.units.empty() && !record.UNITS.empty()) {
+        test.units = record.UNITS;
+    }
+    test.sketch.add(record.RESULT);
+}
+
+void TestQuantiles::merge(const TestQuantiles& other) {
+    for (const auto& item : other.tests_) {
+        const TestDistribution& source = item.second;
+        TestDistribution& test = entry(source.testNum);
+        if (!test.hasResScale && source.hasResScale) {
+            test.hasResScale = true;
+            test.resScale = source.resScale;
+        }
+        if (test.testText.empty()) test.testText = source.testText;
+        if (test.units.empty()) test.units = source.units;
+        test.sketch.merge(source.sketch);
+    }
+}
+
+std::vector<const TestDistribution*> TestQuantiles::getResults() const {
+    std::vector<const TestDistribution*> results;
+    results.reserve(tests_.size());
+    for (const auto& item : tests_) {
+        results.push_back(&item.second);
+    }
+    std::sort(results.begin(), results.end(), [](const TestDistribution* a, const TestDistribution* b) {
+        return a->testNum < b->testNum;
+    });
+    return results;
+}
+
+const TestDistribution* TestQuantiles::find(U4 testNum) const {
+    auto it = tests_.find(testNum);
+    return it != tests_.end() ? &it->second : nullptr;
+}
+
+std::vector<uint8_t> TestQuantiles::serialize() const {
+    std::vector<uint8_t> out(QUANTILES_MAGIC, QUANTILES_MAGIC + sizeof(QUANTILES_MAGIC));
+    putU(out, k_, 2);
+    putU(out, tests_.size(), 4);
+    for (const TestDistribution* test : getResults()) {
+        putU(out, test->testNum, 4);
+        putU(out, test->hasResScale ? 1 : 0, 1);
+        putU(out, static_cast<uint8_t>(test->resScale), 1);
+        putString(out, test->testText);
+        putString(out, test->units);
+        test->sketch.serialize(out);
+    }
+    return out;
+}
+
+TestQuantiles TestQuantiles::deserialize(const std::vector<uint8_t>& data) {
+    if (data.size() < sizeof(QUANTILES_MAGIC) ||
+        std::memcmp(data.data(), QUANTILES_MAGIC, sizeof(QUANTILES_MAGIC)) != 0) {
+        throw std::runtime_error("Not a quantile sketch file");
+    }
+    ByteReader in(data.data() + sizeof(QUANTILES_MAGIC), data.size() - sizeof(QUANTILES_MAGIC));
+    TestQuantiles quantiles(static_cast<uint16_t>(in.u(2)));
+    size_t count = static_cast<size_t>(in.u(4));
+    for (size_t i = 0; i < count; ++i) {
+        TestDistribution test;
+        test.testNum = static_cast<U4>(in.u(4));
+        test.hasResScale = in.u(1) != 0;
+        test.resScale = static_cast<I1>(static_cast<uint8_t>(in.u(1)));
+        test.testText = in.string();
+        test.units = in.string();
+
+        size_t consumed = 0;
+        test.sketch = KllSketch::deserialize(in.current(), in.remaining(), consumed);
+        in.skip(consumed);
+        quantiles.tests_[test.testNum] = std::move(test);
+    }
+    if (in.remaining() != 0) {
+        throw std::runtime_error("Corrupt quantile sketch: trailing data");
+    }
+    return quantiles;
+}
+
+void TestQuantiles::save(const std::string& path) const {
+    std::vector<uint8_t> data = serialize();
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed to write quantile sketch file: " + path);
+    }
+}
+
+TestQuantiles TestQuantiles::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return deserialize(data);
+}
+
+void TestQuantiles::writeReport(std::ostream& out, const std::vector<const TestDistribution*>& results,
+                                size_t histogramBins) {
+    static const size_t BAR_WIDTH = 40;
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    out << std::left << std::setw(10) << "TEST" << std::right
+        << std::setw(12) << "COUNT" << std::setw(13) << "MIN"
+        << std::setw(13) << "P1" << std::setw(13) << "P50"
+        << std::setw(13) << "P99" << std::setw(13) << "MAX"
+        << "  UNITS  NAME\n";
+
+    out << std::setprecision(6);
+    for (const TestDistribution* test : results) {
+        const KllSketch& sketch = test->sketch;
+        double scale = test->scale();
+        std::vector<double> p = sketch.quantiles({0.01, 0.5, 0.99});
+        out << std::left << std::setw(10) << test->testNum << std::right
+            << std::setw(12) << sketch.count()
+            << std::setw(13) << sketch.min() * scale
+            << std::setw(13) << p[0] * scale << std::setw(13) << p[1] * scale
+            << std::setw(13) << p[2] * scale << std::setw(13) << sketch.max() * scale
+            << "  " << test->scaledUnits() << "  " << test->testText << "\n";
+
+        if (histogramBins == 0 || sketch.empty()) {
+            continue;
+        }
+        std::vector<uint64_t> counts = sketch.histogram(sketch.min(), sketch.max(), histogramBins);
+        uint64_t peak = *std::max_element(counts.begin(), counts.end());
+        double width = (static_cast<double>(sketch.max()) - sketch.min()) / static_cast<double>(histogramBins);
+        for (size_t bin = 0; bin < counts.size(); ++bin) {
+            double lo = (sketch.min() + width * static_cast<double>(bin)) * scale;
+            size_t bar = peak > 0 ? static_cast<size_t>(counts[bin] * BAR_WIDTH / peak) : 0;
+            out << std::setw(23) << lo << std::setw(12) << counts[bin] << "  "
+                << std::string(bar, '#') << "\n";
+        }
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+} // namespace STDF
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Bump allocator for whole-file record loads
+ *              Block management for RecordArena
+ */
+
+#include "record_arena.h"
+
+namespace STDF {
+
+RecordArena::RecordArena(size_t blockSize)
+    : blockSize_(blockSize > 0 ? blockSize : DEFAULT_BLOCK_SIZE), current_(nullptr),
+      used_(0), capacity_(0), bytesUsed_(0), bytesReserved_(0) {
+}
+
+RecordArena::RecordArena(RecordArena&& other) noexcept
+    : blockSize_(other.blockSize_), blocks_(std::move(other.blocks_)), current_(other.current_),
+      used_(other.used_), capacity_(other.capacity_), bytesUsed_(other.bytesUsed_),
+      bytesReserved_(other.bytesReserved_) {
+    other.blocks_.clear();
+    other.current_ = nullptr;
+    other.used_ = other.capacity_ = 0;
+    other.bytesUsed_ = other.bytesReserved_ = 0;
+}
+
+RecordArena& RecordArena::operator=(RecordArena&& other) noexcept {
+    if (this != &other) {
+        blockSize_ = other.blockSize_;
+        blocks_ = std::move(other.blocks_);
+        current_ = other.current_;
+        used_ = other.used_;
+        capacity_ = other.capacity_;
+        bytesUsed_ = other.bytesUsed_;
+        bytesReserved_ = other.bytesReserved_;
+
+        other.blocks_.clear();
+        other.current_ = nullptr;
+        other.used_ = other.capacity_ = 0;
+        other.bytesUsed_ = other.bytesReserved_ = 0;
+    }
+    return *this;
+}
+
+void* RecordArena::allocateSlow(size_t size, size_t align) {
+    // Block starts are aligned for any fundamental type, so a fresh block
+    // needs no padding
+    (void)align;
+
+    if (size > blockSize_) {
+        // Oversized request: a block of its own, leaving the current one open
+        blocks_.push_back({std::unique_ptr<U1[]>(new U1[size]), size});
+        bytesUsed_ += size;
+        bytesReserved_ += size;
+        return blocks_.back().data.get();
+    }
+
+    blocks_.push_back({std::unique_ptr<U1[]>(new U1[blockSize_]), blockSize_});
+    bytesUsed_ += used_;
+    bytesReserved_ += blockSize_;
+
+    current_ = blocks_.back().data.get();
+    capacity_ = blockSize_;
+    used_ = size;
+    return current_;
+}
+
+void RecordArena::reset() {
+    if (blocks_.size() > 1) {
+        blocks_.resize(1);
+    }
+    current_ = blocks_.empty() ? nullptr : blocks_.front().data.get();
+    capacity_ = blocks_.empty() ? 0 : blocks_.front().size;
+    used_ = 0;
+    bytesUsed_ = 0;
+    bytesReserved_ = capacity_;
+}
+
+} // namespace STDF
@@ -0,0 +1,490 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: CSV and JSON Lines exporter implementation
+ *              Per-type field lists shared by both formats
+ */
+
+#include "record_export.h"
+#include "logger.h"
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+#include <stdexcept>
+
+namespace STDF {
+
+namespace {
+
+// Field lists, shared by the CSV header, CSV rows and JSON objects. Names
+// match the database columns.
+template <typename Row> void visitFields(const FARRecord& r, Row& row) {
+    row("cpu_typ", r.CPU_TYP);
+    row("stdf_ver", r.STDF_VER);
+}
+
+template <typename Row> void visitFields(const MIRRecord& r, Row& row) {
+    row("setup_t", r.SETUP_T);
+    row("start_t", r.START_T);
+    row("stat_num", r.STAT_NUM);
+    row("mode_cod", r.MODE_COD);
+    row("rtst_cod", r.RTST_COD);
+    row("prot_cod", r.PROT_COD);
+    row("burn_tim", r.BURN_TIM);
+    row("cmod_cod", r.CMOD_COD);
+    row("lot_id", r.LOT_ID);
+    row("part_typ", r.PART_TYP);
+    row("node_nam", r.NODE_NAM);
+    row("tstr_typ", r.TSTR_TYP);
+    row("job_nam", r.JOB_NAM);
+    row("job_rev", r.JOB_REV);
+    row("sblot_id", r.SBLOT_ID);
+    row("oper_nam", r.OPER_NAM);
+    row("exec_typ", r.EXEC_TYP);
+    row("exec_ver", r.EXEC_VER);
+    row("test_cod", r.TEST_COD);
+    row("tst_temp", r.TST_TEMP);
+    row("user_txt", r.USER_TXT);
+    row("aux_file", r.AUX_FILE);
+    row("pkg_typ", r.PKG_TYP);
+    row("famly_id", r.FAMLY_ID);
+    row("date_cod", r.DATE_COD);
+    row("facil_id", r.FACIL_ID);
+    row("floor_id", r.FLOOR_ID);
+    row("proc_id", r.PROC_ID);
+    row("oper_frq", r.OPER_FRQ);
+    row("spec_nam", r.SPEC_NAM);
+    row("spec_ver", r.SPEC_VER);
+    row("flow_id", r.FLOW_ID);
+    row("setup_id", r.SETUP_ID);
+    row("dsgn_rev", r.DSGN_REV);
+    row("eng_id", r.ENG_ID);
+    row("rom_cod", r.ROM_COD);
+    row("serl_num", r.SERL_NUM);
+    row("supr_nam", r.SUPR_NAM);
+}
+
+template <typename Row> void visitFields(const PIRRecord& r, Row& row) {
+    row("head_num", r.HEAD_NUM);
+    row("site_num", r.SITE_NUM);
+}
+
+template <typename Row> void visitFields(const PRRRecord& r, Row& row) {
+    row("head_num", r.HEAD_NUM);
+    row("site_num", r.SITE_NUM);
+    row("part_flg", r.PART_FLG);
+    row("num_test", r.NUM_TEST);
+    row("hard_bin", r.HARD_BIN);
+    row("soft_bin", r.SOFT_BIN);
+    row("x_coord", r.X_COORD);
+    row("y_coord", r.Y_COORD);
+    row("test_t", r.TEST_T);
+    row("part_id", r.PART_ID);
+    row("part_txt", r.PART_TXT);
+}
+
+template <typename Row> void visitFields(const PTRRecord& r, Row& row) {
+    row("test_num", r.TEST_NUM);
+    row("head_num", r.HEAD_NUM);
+    row("site_num", r.SITE_NUM);
+    row("test_flg", r.TEST_FLG);
+    row("parm_flg", r.PARM_FLG);
+    row("result", r.RESULT);
+    row("test_txt", r.TEST_TXT);
+    row("alarm_id", r.ALARM_ID);
+    row("opt_flag", r.OPT_FLAG);
+    row("res_scal", r.RES_SCAL);
+    row("llm_scal", r.LLM_SCAL);
+    row("hlm_scal", r.HLM_SCAL);
+    row("lo_limit", r.LO_LIMIT);
+    row("hi_limit", r.HI_LIMIT);
+    row("units", r.UNITS);
+}
+
+template <typename Row> void visitFields(const FTRRecord& r, Row& row) {
+    row("test_num", r.TEST_NUM);
+    row("head_num", r.HEAD_NUM);
+    row("site_num", r.SITE_NUM);
+    row("test_flg", r.TEST_FLG);
+    row("opt_flag", r.OPT_FLAG);
+    row("cycl_cnt", r.CYCL_CNT);
+    row("rel_vadr", r.REL_VADR);
+    row("rept_cnt", r.REPT_CNT);
+    row("num_fail", r.NUM_FAIL);
+    row("xfail_ad", r.XFAIL_AD);
+    row("yfail_ad", r.YFAIL_AD);
+    row("vect_off", r.VECT_OFF);
+    row("vect_nam", r.VECT_NAM);
+    row("time_set", r.TIME_SET);
+    row("op_code", r.OP_CODE);
+    row("test_txt", r.TEST_TXT);
+    row("alarm_id", r.ALARM_ID);
+    row("prog_txt", r.PROG_TXT);
+    row("rslt_txt", r.RSLT_TXT);
+    row("patg_num", r.PATG_NUM);
+}
+
+template <typename Row> void visitFields(const HBRRecord& r, Row& row) {
+    row("head_num", r.HEAD_NUM);
+    row("site_num", r.SITE_NUM);
+    row("hbin_num", r.HBIN_NUM);
+    row("hbin_cnt", r.HBIN_CNT);
+    row("hbin_pf", r.HBIN_PF);
+    row("hbin_nam", r.HBIN_NAM);
+}
+
+template <typename Row> void visitFields(const SBRRecord& r, Row& row) {
+    row("head_num", r.HEAD_NUM);
+    row("site_num", r.SITE_NUM);
+    row("sbin_num", r.SBIN_NUM);
+    row("sbin_cnt", r.SBIN_CNT);
+    row("sbin_pf", r.SBIN_PF);
+    row("sbin_nam", r.SBIN_NAM);
+}
+
+template <typename Row> void visitFields(const WIRRecord& r, Row& row) {
+    row("head_num", r.HEAD_NUM);
+    row("site_grp", r.SITE_GRP);
+    row("start_t", r.START_T);
+    row("wafer_id", r.WAFER_ID);
+}
+
+template <typename Row> void visitFields(const WRRRecord& r, Row& row) {
+    row("head_num", r.HEAD_NUM);
+    row("site_grp", r.SITE_GRP);
+    row("finish_t", r.FINISH_T);
+    row("part_cnt", r.PART_CNT);
+    row("rtst_cnt", r.RTST_CNT);
+    row("abrt_cnt", r.ABRT_CNT);
+    row("good_cnt", r.GOOD_CNT);
+    row("func_cnt", r.FUNC_CNT);
+    row("wafer_id", r.WAFER_ID);
+    row("fabwf_id", r.FABWF_ID);
+    row("frame_id", r.FRAME_ID);
+    row("mask_id", r.MASK_ID);
+    row("usr_desc", r.USR_DESC);
+    row("exc_desc", r.EXC_DESC);
+}
+
+// Comma-separated field names
+struct CsvHeader {
+    ExportBuffer& out;
+    bool first = true;
+
+    template <size_t N, typename T>
+    void operator()(const char (&name)[N], const T&) {
+        if (!first) out.append(',');
+        first = false;
+        out.append(name, N - 1);
+    }
+};
+
+// Comma-separated values. Text is quoted only when it contains a comma,
+// quote or line break, with quotes doubled (RFC 4180).
+struct CsvRow {
+    ExportBuffer& out;
+    bool first = true;
+
+    template <size_t N, typename T>
+    void operator()(const char (&)[N], const T& value) {
+        if (!first) out.append(',');
+        first = false;
+        put(value);
+    }
+
+    template <typename T>
+    void put(T value) { out.appendNumber(value); }
+
+    void put(char value) {
+        if (value != '\0') put(std::string(1, value));
+    }
+
+    void put(const std::string& value) {
+        if (value.find_first_of(",\"\r\n") == std::string::npos) {
+            out.append(value.data(), value.size());
+            return;
+        }
+        out.append('"');
+        for (char c : value) {
+            if (c == '"') out.append('"');
+            out.append(c);
+        }
+        out.append('"');
+    }
+};
+
+// Members of a JSON object after the leading "type" member
+struct JsonRow {
+    ExportBuffer& out;
+
+    template <size_t N, typename T>
+    void operator()(const char (&name)[N], const T& value) {
+        out.append(",\"", 2);
+        out.append(name, N - 1);
+        out.append("\":", 2);
+        put(value);
+    }
+
+    template <typename T>
+    void put(T value) { out.appendNumber(value); }
+
+    void put(float value) {
+        if (std::isfinite(value)) {
+            out.appendNumber(value);
+        } else {
+            out.append("null", 4);
+        }
+    }
+
+    void put(char value) {
+        put(value != '\0' ? std::string(1, value) : std::string());
+    }
+
+    void put(const std::string& value) {
+        static const char hex[] = "0123456789abcdef";
+        out.append('"');
+        size_t plain = 0; // Start of the run not yet copied
+        for (size_t i = 0; i < value.size(); ++i) {
+            unsigned char c = static_cast<unsigned char>(value[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            out.append(value.data() + plain, i - plain);
+            plain = i + 1;
+            switch (c) {
+                case '"': out.append("\\\"", 2); break;
+                case '\\': out.append("\\\\", 2); break;
+                case '\n': out.append("\\n", 2); break;
+                case '\r': out.append("\\r", 2); break;
+                case '\t': out.append("\\t", 2); break;
+                default: {
+                    char escape[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                    out.append(escape, sizeof(escape));
+                }
+            }
+        }
+        out.append(value.data() + plain, value.size() - plain);
+        out.append('"');
+    }
+};
+
+FILE* openOutput(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("Failed to create export file: " + path);
+    }
+    return file;
+}
+
+void closeOutput(FILE* file, bool owned) {
+    if (owned) {
+        if (std::fclose(file) != 0) {
+            throw std::runtime_error("Failed to close export file");
+        }
+    } else if (std::fflush(file) != 0) {
+        throw std::runtime_error("Failed to flush export output");
+    }
+}
+
+} // namespace
+
+const char* exportFormatName(ExportFormat format) {
+    return format == ExportFormat::Csv ? "csv" : "jsonl";
+}
+
+bool exportFormatFromName(const std::string& name, ExportFormat& format) {
+    if (name == "csv") {
+        format = ExportFormat::Csv;
+    } else if (name == "jsonl" || name == "json") {
+        format = ExportFormat::JsonLines;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// === ExportBuffer ===
+
+ExportBuffer::ExportBuffer(FILE* out, size_t capacity)
+    : out_(out), data_(capacity > MAX_NUMBER_CHARS ? capacity : MAX_NUMBER_CHARS),
+      size_(0), written_(0) {}
+
+ExportBuffer::~ExportBuffer() {
+    try {
+        flush();
+    } catch (const std::exception& e) {
+        STDF_LOG_ERROR << e.what();
+    }
+}
+
+void ExportBuffer::flush() {
+    if (size_ == 0) {
+        return;
+    }
+    size_t size = size_;
+    size_ = 0;
+    writeBlock(data_.data(), size);
+}
+
+void ExportBuffer::writeBlock(const char* data, size_t size) {
+    if (std::fwrite(data, 1, size, out_) != size) {
+        throw std::runtime_error("Failed to write export output");
+    }
+    written_ += size;
+}
+
+// === CsvExporter ===
+
+CsvExporter::CsvExporter(const std::string& directory)
+    : directory_(directory), singleType_(false), type_(RecordType::FAR), rows_(0) {
+    std::filesystem::create_directories(directory_);
+}
+
+CsvExporter::CsvExporter(FILE* out, RecordType type)
+    : singleType_(true), type_(type), rows_(0) {
+    Table& t = tables_[static_cast<size_t>(type)];
+    t.file = out;
+    t.buffer = std::make_unique<ExportBuffer>(out);
+}
+
+CsvExporter::~CsvExporter() {
+    try {
+        finish();
+    } catch (const std::exception& e) {
+        STDF_LOG_ERROR << "CSV export: " << e.what();
+    }
+}
+
+CsvExporter::Table* CsvExporter::table(RecordType type) {
+    Table& t = tables_[static_cast<size_t>(type)];
+    if (t.buffer || singleType_) {
+        return t.buffer ? &t : nullptr;
+    }
+
+    std::string name = recordTypeName(type);
+    for (char& c : name) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    t.file = openOutput((std::filesystem::path(directory_) / (name + ".csv")).string());
+    t.owned = true;
+    t.buffer = std::make_unique<ExportBuffer>(t.file);
+    return &t;
+}
+
+template <typename Record>
+void CsvExporter::exportRecord(const Record& record) {
+    Table* t = table(record.getRecordType());
+    if (!t) {
+        return;
+    }
+    ExportBuffer& out = *t->buffer;
+    if (!t->headerWritten) {
+        CsvHeader header{out};
+        visitFields(record, header);
+        out.append('\n');
+        t->headerWritten = true;
+    }
+    CsvRow row{out};
+    visitFields(record, row);
+    out.append('\n');
+    rows_++;
+}
+
+void CsvExporter::onFAR(const FARRecord& record) { exportRecord(record); }
+void CsvExporter::onMIR(const MIRRecord& record) { exportRecord(record); }
+void CsvExporter::onPIR(const PIRRecord& record) { exportRecord(record); }
+void CsvExporter::onPRR(const PRRRecord& record) { exportRecord(record); }
+void CsvExporter::onPTR(const PTRRecord& record) { exportRecord(record); }
+void CsvExporter::onFTR(const FTRRecord& record) { exportRecord(record); }
+void CsvExporter::onHBR(const HBRRecord& record) { exportRecord(record); }
+void CsvExporter::onSBR(const SBRRecord& record) { exportRecord(record); }
+void CsvExporter::onWIR(const WIRRecord& record) { exportRecord(record); }
+void CsvExporter::onWRR(const WRRRecord& record) { exportRecord(record); }
+
+void CsvExporter::finish() {
+    for (Table& t : tables_) {
+        if (!t.file) {
+            continue;
+        }
+        FILE* file = t.file;
+        t.file = nullptr;
+        t.buffer->flush();
+        closeOutput(file, t.owned);
+    }
+}
+
+uint64_t CsvExporter::getBytesWritten() const {
+    uint64_t bytes = 0;
+    for (const Table& t : tables_) {
+        if (t.buffer) {
+            bytes += t.buffer->getBytesWritten();
+        }
+    }
+    return bytes;
+}
+
+// === JsonLinesExporter ===
+
+JsonLinesExporter::JsonLinesExporter(const std::string& path)
+    : file_(openOutput(path)), owned_(true),
+      buffer_(std::make_unique<ExportBuffer>(file_)), rows_(0) {}
+
+JsonLinesExporter::JsonLinesExporter(FILE* out)
+    : file_(out), owned_(false), buffer_(std::make_unique<ExportBuffer>(out)), rows_(0) {}
+
+JsonLinesExporter::~JsonLinesExporter() {
+    try {
+        finish();
+    } catch (const std::exception& e) {
+        STDF_LOG_ERROR << "JSON Lines export: " << e.what();
+    }
+}
+
+template <typename Record>
+void JsonLinesExporter::exportRecord(const Record& record) {
+    ExportBuffer& out = *buffer_;
+    out.append("{\"type\":\"", 9);
+    const char* type = recordTypeName(record.getRecordType());
+    out.append(type, std::strlen(type));
+    out.append('"');
+    JsonRow row{out};
+    visitFields(record, row);
+    out.append("}\n", 2);
+    rows_++;
+}
+
+void JsonLinesExporter::onFAR(const FARRecord& record) { exportRecord(record); }
+void JsonLinesExporter::onMIR(const MIRRecord& record) { exportRecord(record); }
+void JsonLinesExporter::onPIR(const PIRRecord& record) { exportRecord(record); }
+void JsonLinesExporter::onPRR(const PRRRecord& record) { exportRecord(record); }
+void JsonLinesExporter::onPTR(const PTRRecord& record) { exportRecord(record); }
+void JsonLinesExporter::onFTR(const FTRRecord& record) { exportRecord(record); }
+void JsonLinesExporter::onHBR(const HBRRecord& record) { exportRecord(record); }
+void JsonLinesExporter::onSBR(const SBRRecord& record) { exportRecord(record); }
+void JsonLinesExporter::onWIR(const WIRRecord& record) { exportRecord(record); }
+void JsonLinesExporter::onWRR(const WRRRecord& record) { exportRecord(record); }
+
+void JsonLinesExporter::finish() {
+    if (!file_) {
+        return;
+    }
+    FILE* file = file_;
+    file_ = nullptr;
+    buffer_->flush();
+    closeOutput(file, owned_);
+}
+
+} // namespace STDF
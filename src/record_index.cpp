@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Persistent record index for random access into STDF files
+ *              Index construction and .stdfidx sidecar serialization
+ */
+
+#include "record_index.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace STDF {
+
+namespace {
+
+// Sidecar layout (host byte order; the index is a local cache, not an
+// interchange format):
+//   magic[8] version:u32 sourceSize:u64 sourceMtime:i64 bigEndian:u8
+//   count:u64 { offset:u64 type:u8 }...
+//   count:u64 { head:u8 idLen:u32 id first:u64 last:u64 begin:u64 end:u64 }...
+//   count:u64 { head:u8 site:u8 first:u64 last:u64 begin:u64 end:u64 }...
+const char INDEX_MAGIC[8] = {'S', 'T', 'D', 'F', 'I', 'D', 'X', '\0'};
+const uint32_t INDEX_VERSION = 1;
+
+// WAFER_ID is a Cn field, so a longer stored ID means a corrupt sidecar
+const uint32_t MAX_WAFER_ID_LENGTH = 255;
+
+bool sourceStamp(const std::string& file, uint64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    auto fileSize = std::filesystem::file_size(file, ec);
+    if (ec) {
+        return false;
+    }
+    auto writeTime = std::filesystem::last_write_time(file, ec);
+    if (ec) {
+        return false;
+    }
+    size = static_cast<uint64_t>(fileSize);
+    mtime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+template <typename T>
+void put(std::ofstream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool get(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+} // namespace
+
+RecordIndex::RecordIndex() : bigEndian_(false) {
+}
+
+void RecordIndex::addRecord(RecordType type, uint64_t offset, uint64_t endOffset,
+                            U1 headNum, U1 siteNum, const std::string& waferId) {
+    size_t ordinal = entries_.size();
+    entries_.push_back({offset, type});
+    byType_[static_cast<size_t>(type)].push_back(ordinal);
+
+    switch (type) {
+        case RecordType::WIR:
+            openWafers_.push_back(wafers_.size());
+            wafers_.push_back({headNum, waferId, ordinal, ordinal, offset, endOffset});
+            break;
+        case RecordType::WRR:
+            for (auto it = openWafers_.begin(); it != openWafers_.end(); ++it) {
+                WaferRange& wafer = wafers_[*it];
+                if (wafer.headNum == headNum) {
+                    wafer.lastRecord = ordinal;
+                    wafer.endOffset = endOffset;
+                    openWafers_.erase(it);
+                    break;
+                }
+            }
+            break;
+        case RecordType::PIR:
+            openParts_.push_back(parts_.size());
+            parts_.push_back({headNum, siteNum, ordinal, ordinal, offset, endOffset});
+            break;
+        case RecordType::PRR:
+            for (auto it = openParts_.begin(); it != openParts_.end(); ++it) {
+                PartRange& part = parts_[*it];
+                if (part.headNum == headNum && part.siteNum == siteNum) {
+                    part.lastRecord = ordinal;
+                    part.endOffset = endOffset;
+                    openParts_.erase(it);
+                    break;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void RecordIndex::clear() {
+    entries_.clear();
+    for (auto& list : byType_) {
+        list.clear();
+    }
+    wafers_.clear();
+    parts_.clear();
+    openParts_.clear();
+    openWafers_.clear();
+    bigEndian_ = false;
+}
+
+const std::vector<size_t>& RecordIndex::getRecordsOfType(RecordType type) const {
+    return byType_[static_cast<size_t>(type)];
+}
+
+std::string RecordIndex::sidecarPath(const std::string& stdfFile) {
+    return stdfFile + ".stdfidx";
+}
+
+bool RecordIndex::save(const std::string& stdfFile) const {
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    if (!sourceStamp(stdfFile, sourceSize, sourceMtime)) {
+        lastError_ = "Cannot stat " + stdfFile;
+        return false;
+    }
+
+    // Write to a temporary name and rename, so a concurrent reader never sees
+    // a half-written index
+    std::string path = sidecarPath(stdfFile);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            lastError_ = "Cannot create index file: " + tempPath;
+            return false;
+        }
+
+        out.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        put<uint32_t>(out, INDEX_VERSION);
+        put<uint64_t>(out, sourceSize);
+        put<int64_t>(out, sourceMtime);
+        put<uint8_t>(out, bigEndian_ ? 1 : 0);
+
+        put<uint64_t>(out, entries_.size());
+        for (const auto& entry : entries_) {
+            put<uint64_t>(out, entry.offset);
+            put<uint8_t>(out, static_cast<uint8_t>(entry.type));
+        }
+
+        put<uint64_t>(out, wafers_.size());
+        for (const auto& wafer : wafers_) {
+            put<uint8_t>(out, wafer.headNum);
+            put<uint32_t>(out, static_cast<uint32_t>(wafer.waferId.size()));
+            out.write(wafer.waferId.data(), wafer.waferId.size());
+            put<uint64_t>(out, wafer.firstRecord);
+            put<uint64_t>(out, wafer.lastRecord);
+            put<uint64_t>(out, wafer.beginOffset);
+            put<uint64_t>(out, wafer.endOffset);
+        }
+
+        put<uint64_t>(out, parts_.size());
+        for (const auto& part : parts_) {
+            put<uint8_t>(out, part.headNum);
+            put<uint8_t>(out, part.siteNum);
+            put<uint64_t>(out, part.firstRecord);
+            put<uint64_t>(out, part.lastRecord);
+            put<uint64_t>(out, part.beginOffset);
+            put<uint64_t>(out, part.endOffset);
+        }
+
+        if (!out.good()) {
+            lastError_ = "Failed to write index file: " + tempPath;
+            out.close();
+            std::filesystem::remove(tempPath);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        lastError_ = "Failed to rename index file: " + ec.message();
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool RecordIndex::load(const std::string& stdfFile) {
+    clear();
+
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    if (!sourceStamp(stdfFile, sourceSize, sourceMtime)) {
+        lastError_ = "Cannot stat " + stdfFile;
+        return false;
+    }
+
+    std::string path = sidecarPath(stdfFile);
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        lastError_ = "No index file: " + path;
+        return false;
+    }
+
+    char magic[sizeof(INDEX_MAGIC)];
+    uint32_t version = 0;
+    uint64_t indexedSize = 0;
+    int64_t indexedMtime = 0;
+    uint8_t bigEndian = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 ||
+        !get(in, version) || version != INDEX_VERSION) {
+        lastError_ = "Not a record index: " + path;
+        return false;
+    }
+    if (!get(in, indexedSize) || !get(in, indexedMtime) || !get(in, bigEndian)) {
+        lastError_ = "Truncated index file: " + path;
+        return false;
+    }
+    if (indexedSize != sourceSize || indexedMtime != sourceMtime) {
+        lastError_ = "Stale index file: " + path;
+        return false;
+    }
+
+    // Per-type lists are derived from the entries; ranges are read as stored
+    uint64_t count = 0;
+    bool ok = get(in, count);
+    for (uint64_t i = 0; ok && i < count; ++i) {
+        uint64_t offset;
+        uint8_t type;
+        ok = get(in, offset) && get(in, type) && type < byType_.size();
+        if (ok) {
+            size_t ordinal = entries_.size();
+            entries_.push_back({offset, static_cast<RecordType>(type)});
+            byType_[type].push_back(ordinal);
+        }
+    }
+
+    ok = ok && get(in, count);
+    for (uint64_t i = 0; ok && i < count; ++i) {
+        WaferRange wafer;
+        uint32_t idLength = 0;
+        uint64_t first, last;
+        ok = get(in, wafer.headNum) && get(in, idLength) && idLength <= MAX_WAFER_ID_LENGTH;
+        if (ok) {
+            wafer.waferId.resize(idLength);
+            ok = static_cast<bool>(in.read(&wafer.waferId[0], idLength)) &&
+                 get(in, first) && get(in, last) &&
+                 get(in, wafer.beginOffset) && get(in, wafer.endOffset);
+        }
+        if (ok) {
+            wafer.firstRecord = static_cast<size_t>(first);
+            wafer.lastRecord = static_cast<size_t>(last);
+            wafers_.push_back(std::move(wafer));
+        }
+    }
+
+    ok = ok && get(in, count);
+    for (uint64_t i = 0; ok && i < count; ++i) {
+        PartRange part;
+        uint64_t first, last;
+        ok = get(in, part.headNum) && get(in, part.siteNum) && get(in, first) && get(in, last) &&
+             get(in, part.beginOffset) && get(in, part.endOffset);
+        if (ok) {
+            part.firstRecord = static_cast<size_t>(first);
+            part.lastRecord = static_cast<size_t>(last);
+            parts_.push_back(part);
+        }
+    }
+
+    if (!ok) {
+        clear();
+        lastError_ = "Truncated index file: " + path;
+        return false;
+    }
+
+    bigEndian_ = bigEndian != 0;
+    return true;
+}
+
+} // namespace STDF
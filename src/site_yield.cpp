@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Per-site yield accumulation, merging and the site-to-site report
+ *              Site outliers are judged against the pooled results of all sites
+ */
+
+#include "site_yield.h"
+#include "test_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace STDF {
+
+namespace {
+
+// PRR PART_FLG bits 0 and 1 mark a retest of an earlier part
+const U1 PRR_FLG_RETEST = 0x03;
+
+// PRR SOFT_BIN value for "no soft bin"
+const U2 PRR_NO_SOFT_BIN = 65535;
+
+void addCounts(std::vector<uint64_t>& counts, size_t index, uint64_t count) {
+    if (index >= counts.size()) {
+        counts.resize(index + 1, 0);
+    }
+    counts[index] += count;
+}
+
+} // namespace
+
+// === SiteMoments ===
+
+void SiteMoments::merge(const SiteMoments& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    double n = static_cast<double>(count + other.count);
+    double delta = other.mean - mean;
+    mean += delta * static_cast<double>(other.count) / n;
+    m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / n;
+    count += other.count;
+}
+
+// === SiteYieldAccumulator ===
+
+SiteYieldAccumulator::SiteYieldAccumulator(std::unordered_set<U2> passBins)
+    : passBins_(std::move(passBins)), slots_(65536, NO_SLOT) {}
+
+size_t SiteYieldAccumulator::site(U1 headNum, U1 siteNum) {
+    uint32_t& slot = slots_[(static_cast<size_t>(headNum) << 8) | siteNum];
+    if (slot == NO_SLOT) {
+        slot = static_cast<uint32_t>(sites_.size());
+        sites_.emplace_back();
+        sites_.back().headNum = headNum;
+        sites_.back().siteNum = siteNum;
+        lastTest_.push_back(std::numeric_limits<uint32_t>::max());
+    }
+    return slot;
+}
+
+uint32_t SiteYieldAccumulator::test(U4 testNum, uint32_t hint) {
+    if (hint < testNums_.size() && testNums_[hint] == testNum) {
+        return hint;
+    }
+    auto inserted = testIndex_.emplace(testNum, static_cast<uint32_t>(testNums_.size()));
+    if (inserted.second) {
+        testNums_.push_back(testNum);
+        testTexts_.emplace_back();
+    }
+    return inserted.first->second;
+}
+
+void SiteYieldAccumulator::onPRR(const PRRRecord& record) {
+    SiteYield& yield = sites_[site(record.HEAD_NUM, record.SITE_NUM)];
+    yield.parts++;
+    if (passBins_.count(record.HARD_BIN)) {
+        yield.passed++;
+    }
+    if (record.PART_FLG & PRR_FLG_RETEST) {
+        yield.retests++;
+    }
+    if (record.TEST_T > 0) {
+        yield.timedParts++;
+        yield.totalTestTime += record.TEST_T;
+    }
+    addCounts(yield.hardBins, record.HARD_BIN, 1);
+    if (record.SOFT_BIN != PRR_NO_SOFT_BIN) {
+        addCounts(yield.softBins, record.SOFT_BIN, 1);
+    }
+}
+
+void SiteYieldAccumulator::onPTR(const PTRRecord& record) {
+    if ((record.TEST_FLG & (PTR_FLG_NOT_EXECUTED | PTR_FLG_RESULT_INVALID)) || std::isnan(record.RESULT)) {
+        return;
+    }
+    size_t index = site(record.HEAD_NUM, record.SITE_NUM);
+    // The test after this site's previous one is the likely next test
+    uint32_t testIndex = test(record.TEST_NUM, lastTest_[index] + 1);
+    lastTest_[index] = testIndex;
+
+    std::vector<SiteMoments>& tests = sites_[index].tests;
+    if (testIndex >= tests.size()) {
+        tests.resize(testIndex + 1);
+    }
+    tests[testIndex].add(record.RESULT);
+    if (testTexts_[testIndex].empty() && !record.TEST_TXT.empty()) {
+        testTexts_[testIndex] = record.TEST_TXT;
+    }
+}
+
+void SiteYieldAccumulator::merge(const SiteYieldAccumulator& other) {
+    // Map the other accumulator's test indices onto ours
+    std::vector<uint32_t> testMap(other.testNums_.size());
+    for (size_t i = 0; i < other.testNums_.size(); ++i) {
+        testMap[i] = test(other.testNums_[i], static_cast<uint32_t>(i));
+        if (testTexts_[testMap[i]].empty()) {
+            testTexts_[testMap[i]] = other.testTexts_[i];
+        }
+    }
+
+    for (const SiteYield& source : other.sites_) {
+        SiteYield& yield = sites_[site(source.headNum, source.siteNum)];
+        yield.parts += source.parts;
+        yield.passed += source.passed;
+        yield.retests += source.retests;
+        yield.timedParts += source.timedParts;
+        yield.totalTestTime += source.totalTestTime;
+        for (size_t bin = 0; bin < source.hardBins.size(); ++bin) {
+            if (source.hardBins[bin]) addCounts(yield.hardBins, bin, source.hardBins[bin]);
+        }
+        for (size_t bin = 0; bin < source.softBins.size(); ++bin) {
+            if (source.softBins[bin]) addCounts(yield.softBins, bin, source.softBins[bin]);
+        }
+        for (size_t i = 0; i < source.tests.size(); ++i) {
+            if (source.tests[i].count == 0) {
+                continue;
+            }
+            if (testMap[i] >= yield.tests.size()) {
+                yield.tests.resize(testMap[i] + 1);
+            }
+            yield.tests[testMap[i]].merge(source.tests[i]);
+        }
+    }
+}
+
+const SiteYield* SiteYieldAccumulator::find(U1 headNum, U1 siteNum) const {
+    uint32_t slot = slots_[(static_cast<size_t>(headNum) << 8) | siteNum];
+    return slot == NO_SLOT ? nullptr : &sites_[slot];
+}
+
+uint64_t SiteYieldAccumulator::totalParts() const {
+    uint64_t parts = 0;
+    for (const SiteYield& yield : sites_) parts += yield.parts;
+    return parts;
+}
+
+uint64_t SiteYieldAccumulator::totalPassed() const {
+    uint64_t passed = 0;
+    for (const SiteYield& yield : sites_) passed += yield.passed;
+    return passed;
+}
+
+double SiteYieldAccumulator::yield() const {
+    uint64_t parts = totalParts();
+    return parts > 0 ? static_cast<double>(totalPassed()) / static_cast<double>(parts) : 0.0;
+}
+
+double SiteYieldAccumulator::yieldZ(const SiteYield& site) const {
+    double p = yield();
+    if (site.parts == 0 || p <= 0.0 || p >= 1.0) {
+        return 0.0;
+    }
+    return (site.yield() - p) / std::sqrt(p * (1.0 - p) / static_cast<double>(site.parts));
+}
+
+std::vector<SiteTestDelta> SiteYieldAccumulator::compareTests() const {
+    std::vector<SiteTestDelta> deltas;
+    for (size_t t = 0; t < testNums_.size(); ++t) {
+        SiteMoments all;
+        for (const SiteYield& yield : sites_) {
+            if (t < yield.tests.size()) all.merge(yield.tests[t]);
+        }
+        double sigma = all.count > 1 ? std::sqrt(all.m2 / static_cast<double>(all.count - 1)) : 0.0;
+        for (const SiteYield& yield : sites_) {
+            if (t >= yield.tests.size() || yield.tests[t].count == 0) {
+                continue;
+            }
+            SiteTestDelta delta;
+            delta.testNum = testNums_[t];
+            delta.headNum = yield.headNum;
+            delta.siteNum = yield.siteNum;
+            delta.count = yield.tests[t].count;
+            delta.siteMean = yield.tests[t].mean;
+            delta.allMean = all.mean;
+            delta.sigma = sigma;
+            delta.delta = delta.siteMean - delta.allMean;
+            delta.deltaSigma = sigma > 0.0 ? delta.delta / sigma : 0.0;
+            deltas.push_back(delta);
+        }
+    }
+    std::sort(deltas.begin(), deltas.end(), [](const SiteTestDelta& a, const SiteTestDelta& b) {
+        if (a.testNum != b.testNum) return a.testNum < b.testNum;
+        if (a.headNum != b.headNum) return a.headNum < b.headNum;
+        return a.siteNum < b.siteNum;
+    });
+    return deltas;
+}
+
+void SiteYieldAccumulator::writeReport(std::ostream& out, const SiteComparisonOptions& options) const {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    std::vector<SiteTestDelta> deltas = compareTests();
+    std::vector<SiteTestDelta> shifts;
+    std::unordered_map<uint16_t, size_t> shiftsPerSite;
+    for (const SiteTestDelta& delta : deltas) {
+        if (std::fabs(delta.deltaSigma) >= options.meanShiftSigma) {
+            shifts.push_back(delta);
+            shiftsPerSite[static_cast<uint16_t>((delta.headNum << 8) | delta.siteNum)]++;
+        }
+    }
+    std::stable_sort(shifts.begin(), shifts.end(), [](const SiteTestDelta& a, const SiteTestDelta& b) {
+        return std::fabs(a.deltaSigma) > std::fabs(b.deltaSigma);
+    });
+
+    std::vector<const SiteYield*> sites;
+    for (const SiteYield& yield : sites_) {
+        sites.push_back(&yield);
+    }
+    std::sort(sites.begin(), sites.end(), [](const SiteYield* a, const SiteYield* b) {
+        return (a->headNum << 8 | a->siteNum) < (b->headNum << 8 | b->siteNum);
+    });
+
+    std::vector<U2> passBins(passBins_.begin(), passBins_.end());
+    std::sort(passBins.begin(), passBins.end());
+    out << "Pass bins:";
+    for (U2 bin : passBins) {
+        out << " " << bin;
+    }
+    out << "\n";
+
+    out << std::right << std::setw(5) << "HEAD" << std::setw(5) << "SITE"
+        << std::setw(10) << "PARTS" << std::setw(10) << "PASSED"
+        << std::setw(9) << "YIELD%" << std::setw(9) << "DELTA%" << std::setw(9) << "YIELD_Z"
+        << std::setw(12) << "AVG_TIME_MS" << std::setw(9) << "RETESTS"
+        << "  " << std::left << std::setw(24) << "TOP_FAIL_BINS" << "FLAGS\n" << std::right;
+
+    double totalYield = yield();
+    out << std::fixed;
+    for (const SiteYield* yield : sites) {
+        // Three most frequent failing hard bins as bin:count
+        std::vector<std::pair<uint64_t, size_t>> fails;
+        for (size_t bin = 0; bin < yield->hardBins.size(); ++bin) {
+            if (yield->hardBins[bin] && !passBins_.count(static_cast<U2>(bin))) {
+                fails.emplace_back(yield->hardBins[bin], bin);
+            }
+        }
+        std::sort(fails.begin(), fails.end(), [](const std::pair<uint64_t, size_t>& a,
+                                                 const std::pair<uint64_t, size_t>& b) {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        });
+        std::ostringstream topBins;
+        for (size_t i = 0; i < std::min<size_t>(3, fails.size()); ++i) {
+            topBins << (i ? " " : "") << fails[i].second << ":" << fails[i].first;
+        }
+
+        double z = yieldZ(*yield);
+        std::string flagText;
+        if (z <= -options.yieldZ) {
+            flagText = "LOW_YIELD";
+        }
+        auto shifted = shiftsPerSite.find(static_cast<uint16_t>((yield->headNum << 8) | yield->siteNum));
+        if (shifted != shiftsPerSite.end()) {
+            flagText += (flagText.empty() ? "" : " ") + std::string("MEAN_SHIFT(") +
+                        std::to_string(shifted->second) + ")";
+        }
+
+        out << std::setw(5) << static_cast<int>(yield->headNum) << std::setw(5) << static_cast<int>(yield->siteNum)
+            << std::setw(10) << yield->parts << std::setw(10) << yield->passed
+            << std::setprecision(2) << std::setw(9) << yield->yield() * 100.0
+            << std::setw(9) << (yield->yield() - totalYield) * 100.0
+            << std::setw(9) << z
+            << std::setprecision(1) << std::setw(12) << yield->meanTestTime()
+            << std::setw(9) << yield->retests
+            << "  " << std::left;
+        if (flagText.empty()) {
+            out << topBins.str() << "\n";
+        } else {
+            out << std::setw(24) << topBins.str() << flagText << "\n";
+        }
+        out << std::right;
+    }
+    out << std::setw(10) << "ALL" << std::setw(10) << totalParts() << std::setw(10) << totalPassed()
+        << std::setprecision(2) << std::setw(9) << totalYield * 100.0 << "\n";
+
+    out << "\nTest means shifted by at least " << std::setprecision(2) << options.meanShiftSigma
+        << " sigma from all sites (" << shifts.size() << " of " << deltas.size() << " test/site pairs):\n";
+    if (!shifts.empty()) {
+        out << std::left << std::setw(10) << "TEST" << std::right
+            << std::setw(5) << "HEAD" << std::setw(5) << "SITE" << std::setw(10) << "COUNT"
+            << std::setw(13) << "SITE_MEAN" << std::setw(13) << "ALL_MEAN"
+            << std::setw(13) << "DELTA" << std::setw(9) << "SIGMAS" << "  NAME\n";
+        out.unsetf(std::ios::floatfield);
+        for (const SiteTestDelta& delta : shifts) {
+            auto index = testIndex_.find(delta.testNum);
+            out << std::left << std::setw(10) << delta.testNum << std::right
+                << std::setw(5) << static_cast<int>(delta.headNum) << std::setw(5) << static_cast<int>(delta.siteNum)
+                << std::setw(10) << delta.count << std::setprecision(6)
+                << std::setw(13) << delta.siteMean << std::setw(13) << delta.allMean
+                << std::setw(13) << delta.delta << std::setprecision(3) << std::setw(9) << delta.deltaSigma
+                << "  " << testTexts_[index->second] << "\n";
+        }
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+} // namespace STDF
@@ -23,43 +23,112 @@
 #include <iostream>
 #include <stdexcept>
 #include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace STDF {
 
-STDFParser::STDFParser(const std::string& filename) 
-    : filename_(filename), fileSize_(0), endianSwap_(false) {
+namespace {
+
+// Stream skips of at least this many bytes seek; shorter ones read through
+// the buffer. A seek drops the stream buffer (8 KiB in libstdc++), so it only
+// pays off once a body spans more than one buffer refill; measured crossover
+// is between 8 and 16 KiB. REC_LEN is a U2, so this must stay below 64 KiB.
+const size_t SEEK_THRESHOLD = 16 * 1024;
+
+bool hostIsBigEndian() {
+    const U2 probe = 1;
+    U1 firstByte;
+    std::memcpy(&firstByte, &probe, 1);
+    return firstByte == 0;
+}
+
+} // namespace
+
+STDFParser::STDFParser(const std::string& filename, InputMode mode) 
+    : filename_(filename), fileSize_(0), endianSwap_(false), mode_(mode),
+      seekable_(true), recordFilter_(~0u), indexLoaded_(false), mapData_(nullptr), position_(0),
+      cursor_(nullptr), recordEnd_(nullptr) {
     
-    file_.open(filename, std::ios::binary);
-    if (!file_.is_open()) {
-        throw std::runtime_error("Failed to open file: " + filename);
+    if (mode_ == InputMode::MemoryMapped) {
+        openMapped();
+    } else {
+        openStream();
     }
-    
-    // Get file size
-    file_.seekg(0, std::ios::end);
-    fileSize_ = file_.tellg();
-    file_.seekg(0, std::ios::beg);
-    
-    // Detect endianness from first record (should be FAR)
-    detectEndianness();
 }
 
 STDFParser::~STDFParser() {
+    if (mapData_) {
+        munmap(const_cast<uint8_t*>(mapData_), fileSize_);
+        mapData_ = nullptr;
+    }
     if (file_.is_open()) {
         file_.close();
     }
 }
 
-void STDFParser::detectEndianness() {
-    // Save current position
-    auto pos = file_.tellg();
+void STDFParser::openStream() {
+    file_.open(filename_, std::ios::binary);
+    if (!file_.is_open()) {
+        throw std::runtime_error("Failed to open file: " + filename_);
+    }
     
-    // Read potential FAR record header
-    U2 length;
-    U1 recordType, recordSub;
+    // Get file size; pipes and other non-seekable inputs report no size and
+    // are read until the stream runs dry
+    file_.seekg(0, std::ios::end);
+    std::streampos end = file_.tellg();
+    if (end == std::streampos(-1)) {
+        file_.clear();
+        seekable_ = false;
+        fileSize_ = 0;
+    } else {
+        fileSize_ = static_cast<size_t>(end);
+        file_.seekg(0, std::ios::beg);
+    }
+}
+
+void STDFParser::openMapped() {
+    int fd = ::open(filename_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: " + filename_);
+    }
     
-    file_.read(reinterpret_cast<char*>(&length), sizeof(length));
-    file_.read(reinterpret_cast<char*>(&recordType), sizeof(recordType));
-    file_.read(reinterpret_cast<char*>(&recordSub), sizeof(recordSub));
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to stat file: " + filename_);
+    }
+    fileSize_ = static_cast<size_t>(st.st_size);
+    
+    // mmap() rejects zero-length mappings; an empty file simply has no records
+    if (fileSize_ > 0) {
+        void* addr = mmap(nullptr, fileSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Failed to memory-map file: " + filename_ +
+                                     " (" + std::strerror(errno) + ")");
+        }
+        // Records are decoded front to back, so let the kernel read ahead aggressively
+        madvise(addr, fileSize_, MADV_SEQUENTIAL);
+        mapData_ = static_cast<const uint8_t*>(addr);
+    }
+    
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+}
+
+void STDFParser::detectEndianness(const U1* rawHeader) {
+    // Inspect the first record header, which should be a FAR
+    U2 length;
+    std::memcpy(&length, rawHeader, sizeof(length));
+    U1 recordType = rawHeader[2];
+    U1 recordSub = rawHeader[3];
     
     // Check if this looks like a valid FAR record
     // FAR record: length=2, type=0, sub=10 (or 20 for V4)
@@ -71,19 +140,17 @@ void STDFParser::detectEndianness() {
         if (length == 2 && recordType == 0 && (recordSub == 10 || recordSub == 20)) {
             endianSwap_ = true;
         } else {
-            // Reset position and assume no swapping
+            // Assume no swapping
             endianSwap_ = false;
         }
     }
-    
-    // Restore position
-    file_.seekg(pos);
 }
 
 std::vector<std::unique_ptr<STDFRecord>> STDFParser::parseFile() {
     std::vector<std::unique_ptr<STDFRecord>> records;
     
-    file_.seekg(0, std::ios::beg);
+    rewind();
+    lastError_.clear();
     
     while (!isEndOfFile()) {
         try {
@@ -92,6 +159,7 @@ std::vector<std::unique_ptr<STDFRecord>> STDFParser::parseFile() {
                 records.push_back(std::move(record));
             }
         } catch (const std::exception& e) {
+            lastError_ = e.what();
             STDF_LOG_ERROR << "Error parsing record: " << e.what();
             break;
         }
@@ -100,6 +168,230 @@ std::vector<std::unique_ptr<STDFRecord>> STDFParser::parseFile() {
     return records;
 }
 
+size_t STDFParser::parse(RecordHandler& handler) {
+    if (!records_) {
+        records_ = std::make_unique<RecordSlots>();
+    }
+    RecordSlots& slots = *records_;
+    size_t delivered = 0;
+    
+    rewind();
+    lastError_.clear();
+    
+    while (!isEndOfFile()) {
+        RecordType type;
+        try {
+            auto header = readRecordHeader();
+            if (!lookupRecordType(header, type) || !isRecordTypeEnabled(type)) {
+                skipBytes(header.length);
+                continue;
+            }
+            
+            loadRecordBody(header.length);
+            
+            switch (type) {
+                case RecordType::FAR: decodeFAR(slots.far); break;
+                case RecordType::MIR: decodeMIR(slots.mir); break;
+                case RecordType::HBR: decodeHBR(slots.hbr); break;
+                case RecordType::SBR: decodeSBR(slots.sbr); break;
+                case RecordType::WIR: decodeWIR(slots.wir); break;
+                case RecordType::WRR: decodeWRR(slots.wrr); break;
+                case RecordType::PIR: decodePIR(slots.pir); break;
+                case RecordType::PRR: decodePRR(slots.prr); break;
+                case RecordType::PTR: decodePTR(slots.ptr); break;
+                case RecordType::FTR: decodeFTR(slots.ftr); break;
+                default:              continue;
+            }
+        } catch (const std::exception& e) {
+            lastError_ = e.what();
+            STDF_LOG_ERROR << "Error parsing record: " << e.what();
+            break;
+        }
+        
+        // Outside the try block: handler exceptions are the caller's
+        switch (type) {
+            case RecordType::FAR: handler.onFAR(slots.far); break;
+            case RecordType::MIR: handler.onMIR(slots.mir); break;
+            case RecordType::HBR: handler.onHBR(slots.hbr); break;
+            case RecordType::SBR: handler.onSBR(slots.sbr); break;
+            case RecordType::WIR: handler.onWIR(slots.wir); break;
+            case RecordType::WRR: handler.onWRR(slots.wrr); break;
+            case RecordType::PIR: handler.onPIR(slots.pir); break;
+            case RecordType::PRR: handler.onPRR(slots.prr); break;
+            case RecordType::PTR: handler.onPTR(slots.ptr); break;
+            case RecordType::FTR: handler.onFTR(slots.ftr); break;
+            default:              break;
+        }
+        ++delivered;
+    }
+    
+    return delivered;
+}
+
+template <typename View>
+const RecordView* STDFParser::createView(RecordArena& arena, void (STDFParser::*decode)(View&)) {
+    View* view = arena.create<View>();
+    (this->*decode)(*view);
+    return view;
+}
+
+std::vector<const RecordView*> STDFParser::parseFile(RecordArena& arena) {
+    std::vector<const RecordView*> views;
+    
+    rewind();
+    lastError_.clear();
+    
+    while (!isEndOfFile()) {
+        try {
+            auto header = readRecordHeader();
+            
+            RecordType type;
+            if (!lookupRecordType(header, type) || !isRecordTypeEnabled(type)) {
+                skipBytes(header.length);
+                continue;
+            }
+            
+            loadRecordBody(header.length, arena);
+            
+            switch (type) {
+                case RecordType::FAR: views.push_back(createView(arena, &STDFParser::decodeFARView)); break;
+                case RecordType::MIR: views.push_back(createView(arena, &STDFParser::decodeMIRView)); break;
+                case RecordType::HBR: views.push_back(createView(arena, &STDFParser::decodeHBRView)); break;
+                case RecordType::SBR: views.push_back(createView(arena, &STDFParser::decodeSBRView)); break;
+                case RecordType::WIR: views.push_back(createView(arena, &STDFParser::decodeWIRView)); break;
+                case RecordType::WRR: views.push_back(createView(arena, &STDFParser::decodeWRRView)); break;
+                case RecordType::PIR: views.push_back(createView(arena, &STDFParser::decodePIRView)); break;
+                case RecordType::PRR: views.push_back(createView(arena, &STDFParser::decodePRRView)); break;
+                case RecordType::PTR: views.push_back(createView(arena, &STDFParser::decodePTRView)); break;
+                case RecordType::FTR: views.push_back(createView(arena, &STDFParser::decodeFTRView)); break;
+                default: break;
+            }
+        } catch (const std::exception& e) {
+            lastError_ = e.what();
+            STDF_LOG_ERROR << "Error parsing record: " << e.what();
+            break;
+        }
+    }
+    
+    return views;
+}
+
+std::vector<STDFParser::RecordLocation> STDFParser::scanRecords() {
+    std::vector<RecordLocation> locations;
+    
+    rewind();
+    lastError_.clear();
+    
+    while (!isEndOfFile()) {
+        RecordLocation location;
+        location.offset = position_;
+        try {
+            location.header = readRecordHeader();
+        } catch (const std::exception& e) {
+            lastError_ = e.what();
+            break;
+        }
+        if (seekable_ && location.header.length > fileSize_ - position_) {
+            lastError_ = "Truncated record in " + filename_;
+            position_ = fileSize_;
+            break;
+        }
+        skipBytes(location.header.length);
+        locations.push_back(location);
+    }
+    
+    if (!lastError_.empty()) {
+        STDF_LOG_ERROR << "Error scanning records: " << lastError_;
+    }
+    return locations;
+}
+
+std::vector<std::unique_ptr<STDFRecord>> STDFParser::parseFileParallel(size_t threadCount) {
+    if (!seekable_) {
+        return parseFile();
+    }
+    
+    // Phase 1: find every record boundary
+    std::vector<RecordLocation> locations = scanRecords();
+    std::string scanError = lastError_;
+    
+    // Phase 2: split into contiguous chunks of roughly equal byte size. Using
+    // several chunks per thread keeps all threads busy when record sizes vary.
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    size_t chunkCount = std::min(locations.size(), threadCount * 4);
+    size_t bytesPerChunk = chunkCount > 0 ? fileSize_ / chunkCount + 1 : 0;
+    
+    std::vector<size_t> chunkStarts;
+    size_t nextBoundary = 0;
+    for (size_t i = 0; i < locations.size(); ++i) {
+        if (locations[i].offset >= nextBoundary) {
+            chunkStarts.push_back(i);
+            nextBoundary = locations[i].offset + bytesPerChunk;
+        }
+    }
+    chunkStarts.push_back(locations.size());
+    chunkCount = chunkStarts.size() - 1;
+    
+    struct ChunkResult {
+        std::vector<std::unique_ptr<STDFRecord>> records;
+        std::string error;
+    };
+    std::vector<ChunkResult> chunks(chunkCount);
+    std::atomic<size_t> nextChunk(0);
+    
+    auto worker = [&]() {
+        // Each thread decodes through its own parser (own stream or mapping)
+        std::unique_ptr<STDFParser> reader;
+        for (size_t c = nextChunk++; c < chunkCount; c = nextChunk++) {
+            ChunkResult& chunk = chunks[c];
+            try {
+                if (!reader) {
+                    reader = std::make_unique<STDFParser>(filename_, mode_);
+                    reader->endianSwap_ = endianSwap_;
+                    reader->recordFilter_ = recordFilter_;
+                }
+                reader->seekTo(locations[chunkStarts[c]].offset);
+                for (size_t i = chunkStarts[c]; i < chunkStarts[c + 1]; ++i) {
+                    auto record = reader->parseRecord();
+                    if (record) {
+                        chunk.records.push_back(std::move(record));
+                    }
+                }
+            } catch (const std::exception& e) {
+                chunk.error = e.what();
+            }
+        }
+    };
+    
+    size_t workers = std::min(threadCount, chunkCount);
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < workers; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    
+    // Merge in file order, stopping where a sequential parse would have stopped
+    std::vector<std::unique_ptr<STDFRecord>> records;
+    lastError_ = scanError;
+    for (auto& chunk : chunks) {
+        for (auto& record : chunk.records) {
+            records.push_back(std::move(record));
+        }
+        if (!chunk.error.empty()) {
+            lastError_ = chunk.error;
+            STDF_LOG_ERROR << "Error parsing record: " << chunk.error;
+            break;
+        }
+    }
+    
+    return records;
+}
+
 std::unique_ptr<STDFRecord> STDFParser::parseNextRecord() {
     if (isEndOfFile()) {
         return nullptr;
@@ -108,302 +400,760 @@ std::unique_ptr<STDFRecord> STDFParser::parseNextRecord() {
     return parseRecord();
 }
 
+const RecordView* STDFParser::parseNextView() {
+    if (isEndOfFile()) {
+        return nullptr;
+    }
+    
+    auto header = readRecordHeader();
+    
+    RecordType type;
+    if (!lookupRecordType(header, type) || !isRecordTypeEnabled(type)) {
+        skipBytes(header.length);
+        return nullptr;
+    }
+    
+    loadRecordBody(header.length);
+    
+    switch (type) {
+        case RecordType::FAR: decodeFARView(views_.far); return &views_.far;
+        case RecordType::MIR: decodeMIRView(views_.mir); return &views_.mir;
+        case RecordType::HBR: decodeHBRView(views_.hbr); return &views_.hbr;
+        case RecordType::SBR: decodeSBRView(views_.sbr); return &views_.sbr;
+        case RecordType::WIR: decodeWIRView(views_.wir); return &views_.wir;
+        case RecordType::WRR: decodeWRRView(views_.wrr); return &views_.wrr;
+        case RecordType::PIR: decodePIRView(views_.pir); return &views_.pir;
+        case RecordType::PRR: decodePRRView(views_.prr); return &views_.prr;
+        case RecordType::PTR: decodePTRView(views_.ptr); return &views_.ptr;
+        case RecordType::FTR: decodeFTRView(views_.ftr); return &views_.ftr;
+        default:              return nullptr;
+    }
+}
+
 bool STDFParser::isEndOfFile() {
-    return file_.eof() || file_.tellg() >= static_cast<std::streampos>(fileSize_);
+    if (!seekable_) {
+        return file_.peek() == std::ifstream::traits_type::eof();
+    }
+    return position_ >= fileSize_;
 }
 
 size_t STDFParser::getCurrentPosition() {
-    return static_cast<size_t>(file_.tellg());
+    return position_;
+}
+
+void STDFParser::rewind() {
+    if (position_ == 0) {
+        return;
+    }
+    if (!seekable_) {
+        throw std::runtime_error("Cannot rewind non-seekable input: " + filename_);
+    }
+    seekTo(0);
+}
+
+void STDFParser::setRecordFilter(const std::vector<RecordType>& types) {
+    recordFilter_ = 0;
+    for (RecordType type : types) {
+        recordFilter_ |= 1u << static_cast<unsigned>(type);
+    }
+}
+
+void STDFParser::clearRecordFilter() {
+    recordFilter_ = ~0u;
+}
+
+bool STDFParser::isRecordTypeEnabled(RecordType type) const {
+    return (recordFilter_ >> static_cast<unsigned>(type)) & 1u;
+}
+
+const RecordIndex& STDFParser::getIndex() {
+    if (indexLoaded_) {
+        return index_;
+    }
+    if (!seekable_) {
+        throw std::runtime_error("Cannot index non-seekable input: " + filename_);
+    }
+    
+    if (index_.load(filename_)) {
+        endianSwap_ = index_.isBigEndian() != hostIsBigEndian();
+    } else {
+        buildIndex();
+        if (!index_.save(filename_)) {
+            STDF_LOG_WARNING << "Record index not saved: " << index_.getLastError();
+        }
+    }
+    indexLoaded_ = true;
+    return index_;
+}
+
+void STDFParser::buildIndex() {
+    size_t savedPosition = position_;
+    index_.clear();
+    rewind();
+    
+    try {
+        while (!isEndOfFile()) {
+            size_t offset = position_;
+            auto header = readRecordHeader();
+            if (header.length > fileSize_ - position_) {
+                break; // Truncated record, parseFile() stops here too
+            }
+            
+            RecordType type;
+            if (!lookupRecordType(header, type)) {
+                skipBytes(header.length);
+                continue;
+            }
+            
+            // Only the records that delimit wafers and parts are decoded
+            switch (type) {
+                case RecordType::WIR:
+                    loadRecordBody(header.length);
+                    decodeWIRView(views_.wir);
+                    index_.addRecord(type, offset, position_, views_.wir.HEAD_NUM,
+                                     views_.wir.SITE_GRP, std::string(views_.wir.WAFER_ID));
+                    break;
+                case RecordType::WRR:
+                    loadRecordBody(header.length);
+                    decodeWRRView(views_.wrr);
+                    index_.addRecord(type, offset, position_, views_.wrr.HEAD_NUM, views_.wrr.SITE_GRP);
+                    break;
+                case RecordType::PIR:
+                    loadRecordBody(header.length);
+                    decodePIRView(views_.pir);
+                    index_.addRecord(type, offset, position_, views_.pir.HEAD_NUM, views_.pir.SITE_NUM);
+                    break;
+                case RecordType::PRR:
+                    loadRecordBody(header.length);
+                    decodePRRView(views_.prr);
+                    index_.addRecord(type, offset, position_, views_.prr.HEAD_NUM, views_.prr.SITE_NUM);
+                    break;
+                default:
+                    skipBytes(header.length);
+                    index_.addRecord(type, offset, position_);
+                    break;
+            }
+        }
+    } catch (const std::exception& e) {
+        STDF_LOG_ERROR << "Error indexing records: " << e.what();
+    }
+    
+    index_.setBigEndian(endianSwap_ != hostIsBigEndian());
+    seekTo(savedPosition);
+}
+
+bool STDFParser::seekToRecord(size_t ordinal) {
+    const RecordIndex& index = getIndex();
+    if (ordinal >= index.getRecordCount()) {
+        return false;
+    }
+    seekTo(index.getRecord(ordinal).offset);
+    return true;
+}
+
+bool STDFParser::seekToWafer(size_t waferIndex) {
+    const RecordIndex& index = getIndex();
+    if (waferIndex >= index.getWafers().size()) {
+        return false;
+    }
+    seekTo(index.getWafers()[waferIndex].beginOffset);
+    return true;
+}
+
+bool STDFParser::seekToWafer(const std::string& waferId) {
+    const auto& wafers = getIndex().getWafers();
+    for (size_t i = 0; i < wafers.size(); ++i) {
+        if (wafers[i].waferId == waferId) {
+            return seekToWafer(i);
+        }
+    }
+    return false;
+}
+
+bool STDFParser::seekToPart(size_t partIndex) {
+    const RecordIndex& index = getIndex();
+    if (partIndex >= index.getParts().size()) {
+        return false;
+    }
+    seekTo(index.getParts()[partIndex].beginOffset);
+    return true;
+}
+
+void STDFParser::seekTo(size_t offset) {
+    if (mode_ == InputMode::Stream) {
+        file_.clear();
+        file_.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    }
+    position_ = offset;
+    cursor_ = recordEnd_ = nullptr;
+}
+
+void STDFParser::fetch(void* dest, size_t count) {
+    if (mode_ == InputMode::MemoryMapped) {
+        if (count > fileSize_ - position_) {
+            position_ = fileSize_;
+            throw std::runtime_error("Truncated record in " + filename_);
+        }
+        std::memcpy(dest, mapData_ + position_, count);
+    } else {
+        file_.read(reinterpret_cast<char*>(dest), count);
+        if (static_cast<size_t>(file_.gcount()) != count) {
+            position_ = fileSize_;
+            throw std::runtime_error("Truncated record in " + filename_);
+        }
+    }
+    position_ += count;
+}
+
+void STDFParser::loadRecordBody(size_t length) {
+    if (mode_ == InputMode::MemoryMapped) {
+        // Decode in place from the mapping
+        if (length > fileSize_ - position_) {
+            position_ = fileSize_;
+            throw std::runtime_error("Truncated record in " + filename_);
+        }
+        cursor_ = mapData_ + position_;
+        position_ += length;
+    } else {
+        // One bulk read per record into a buffer whose capacity is reused
+        recordBuffer_.resize(length);
+        fetch(recordBuffer_.data(), length);
+        cursor_ = recordBuffer_.data();
+    }
+    recordEnd_ = cursor_ + length;
+}
+
+void STDFParser::loadRecordBody(size_t length, RecordArena& arena) {
+    // Read straight into the arena so the body outlives the next record
+    U1* body = static_cast<U1*>(arena.allocate(length, 1));
+    if (length > 0) {
+        fetch(body, length);
+    }
+    cursor_ = body;
+    recordEnd_ = body + length;
 }
 
 // Binary reading helpers
+//
+// All field reads decode from the current record body and never cross REC_LEN.
+// STDF allows trailing fields to be omitted from a record, so bytes past the
+// end of the body read as zero (empty strings and arrays).
+void STDFParser::readBytes(void* dest, size_t count) {
+    size_t available = static_cast<size_t>(recordEnd_ - cursor_);
+    if (count <= available) {
+        std::memcpy(dest, cursor_, count);
+        cursor_ += count;
+        return;
+    }
+    std::memcpy(dest, cursor_, available);
+    std::memset(static_cast<uint8_t*>(dest) + available, 0, count - available);
+    cursor_ = recordEnd_;
+}
+
 U1 STDFParser::readU1() {
     U1 value;
-    file_.read(reinterpret_cast<char*>(&value), sizeof(value));
+    readBytes(&value, sizeof(value));
     return value;
 }
 
 U2 STDFParser::readU2() {
     U2 value;
-    file_.read(reinterpret_cast<char*>(&value), sizeof(value));
+    readBytes(&value, sizeof(value));
     return endianSwap_ ? swapBytes(value) : value;
 }
 
 U4 STDFParser::readU4() {
     U4 value;
-    file_.read(reinterpret_cast<char*>(&value), sizeof(value));
+    readBytes(&value, sizeof(value));
     return endianSwap_ ? swapBytes(value) : value;
 }
 
 I1 STDFParser::readI1() {
     I1 value;
-    file_.read(reinterpret_cast<char*>(&value), sizeof(value));
+    readBytes(&value, sizeof(value));
     return value;
 }
 
 I2 STDFParser::readI2() {
     I2 value;
-    file_.read(reinterpret_cast<char*>(&value), sizeof(value));
+    readBytes(&value, sizeof(value));
     return endianSwap_ ? static_cast<I2>(swapBytes(static_cast<U2>(value))) : value;
 }
 
 I4 STDFParser::readI4() {
     I4 value;
-    file_.read(reinterpret_cast<char*>(&value), sizeof(value));
+    readBytes(&value, sizeof(value));
     return endianSwap_ ? static_cast<I4>(swapBytes(static_cast<U4>(value))) : value;
 }
 
 R4 STDFParser::readR4() {
+    U4 bits = readU4();
     R4 value;
-    file_.read(reinterpret_cast<char*>(&value), sizeof(value));
-    if (endianSwap_) {
-        U4 temp = swapBytes(*reinterpret_cast<U4*>(&value));
-        value = *reinterpret_cast<R4*>(&temp);
-    }
+    std::memcpy(&value, &bits, sizeof(value));
     return value;
 }
 
 R8 STDFParser::readR8() {
     R8 value;
-    file_.read(reinterpret_cast<char*>(&value), sizeof(value));
+    readBytes(&value, sizeof(value));
     // Note: R8 byte swapping would need special handling for cross-platform
     return value;
 }
 
 C1 STDFParser::readC1() {
     C1 value;
-    file_.read(&value, sizeof(value));
+    readBytes(&value, sizeof(value));
     return value;
 }
 
-Cn STDFParser::readCn() {
+// Cn/Bn are assigned into the caller's object so a reused record keeps its
+// string and vector capacity
+void STDFParser::readCn(Cn& out) {
     U1 length = readU1();
-    if (length == 0) {
-        return "";
-    }
+    size_t available = static_cast<size_t>(recordEnd_ - cursor_);
+    size_t count = length < available ? length : available;
+    
+    out.assign(reinterpret_cast<const char*>(cursor_), count);
+    cursor_ += count;
+}
+
+void STDFParser::readBn(Bn& out) {
+    U2 length = readU2();
+    size_t available = static_cast<size_t>(recordEnd_ - cursor_);
+    size_t count = length < available ? length : available;
     
-    std::string result(length, '\0');
-    file_.read(&result[0], length);
+    out.assign(cursor_, cursor_ + count);
+    cursor_ += count;
+}
+
+CnView STDFParser::readCnView() {
+    U1 length = readU1();
+    size_t available = static_cast<size_t>(recordEnd_ - cursor_);
+    size_t count = length < available ? length : available;
+    
+    CnView result(reinterpret_cast<const char*>(cursor_), count);
+    cursor_ += count;
     return result;
 }
 
-Bn STDFParser::readBn() {
+BnView STDFParser::readBnView() {
     U2 length = readU2();
-    if (length == 0) {
-        return {};
-    }
+    size_t available = static_cast<size_t>(recordEnd_ - cursor_);
     
-    std::vector<uint8_t> result(length);
-    file_.read(reinterpret_cast<char*>(result.data()), length);
+    BnView result;
+    result.data = cursor_;
+    result.size = length < available ? length : available;
+    cursor_ += result.size;
+    return result;
+}
+
+BnView STDFParser::readRemainingView() {
+    BnView result;
+    result.data = cursor_;
+    result.size = static_cast<size_t>(recordEnd_ - cursor_);
+    cursor_ = recordEnd_;
     return result;
 }
 
 STDFParser::RecordHeader STDFParser::readRecordHeader() {
+    U1 raw[4];
+    bool firstRecord = (position_ == 0);
+    fetch(raw, sizeof(raw));
+    if (firstRecord) {
+        detectEndianness(raw);
+    }
+    
     RecordHeader header;
-    header.length = readU2();
-    header.recordType = readU1();
-    header.recordSub = readU1();
+    std::memcpy(&header.length, raw, sizeof(header.length));
+    if (endianSwap_) {
+        header.length = swapBytes(header.length);
+    }
+    header.recordType = raw[2];
+    header.recordSub = raw[3];
     return header;
 }
 
+bool STDFParser::lookupRecordType(const RecordHeader& header, RecordType& type) {
+    // Determine record type based on recordType and recordSub
+    switch ((header.recordType << 8) | header.recordSub) {
+        case (0 << 8) | 10:  type = RecordType::FAR; return true;
+        case (1 << 8) | 10:  type = RecordType::MIR; return true;
+        case (1 << 8) | 40:  type = RecordType::HBR; return true;
+        case (1 << 8) | 50:  type = RecordType::SBR; return true;
+        case (2 << 8) | 10:  type = RecordType::WIR; return true;
+        case (2 << 8) | 20:  type = RecordType::WRR; return true;
+        case (5 << 8) | 10:  type = RecordType::PIR; return true;
+        case (5 << 8) | 20:  type = RecordType::PRR; return true;
+        case (15 << 8) | 10: type = RecordType::PTR; return true;
+        case (15 << 8) | 20: type = RecordType::FTR; return true;
+        default:             return false;
+    }
+}
+
 std::unique_ptr<STDFRecord> STDFParser::parseRecord() {
     auto header = readRecordHeader();
     
-    // Determine record type based on recordType and recordSub
-    if (header.recordType == 0 && header.recordSub == 10) {
-        return parseFAR();
-    } else if (header.recordType == 1 && header.recordSub == 10) {
-        return parseMIR();
-    } else if (header.recordType == 1 && header.recordSub == 40) {
-        return parseHBR();
-    } else if (header.recordType == 1 && header.recordSub == 50) {
-        return parseSBR();
-    } else if (header.recordType == 2 && header.recordSub == 10) {
-        return parseWIR();
-    } else if (header.recordType == 2 && header.recordSub == 20) {
-        return parseWRR();
-    } else if (header.recordType == 5 && header.recordSub == 10) {
-        return parsePIR();
-    } else if (header.recordType == 5 && header.recordSub == 20) {
-        return parsePRR();
-    } else if (header.recordType == 15 && header.recordSub == 10) {
-        return parsePTR();
-    } else if (header.recordType == 15 && header.recordSub == 20) {
-        return parseFTR();
-    } else {
-        // Skip unknown record
+    RecordType type;
+    if (!lookupRecordType(header, type) || !isRecordTypeEnabled(type)) {
+        // Skip unknown or filtered record
         skipBytes(header.length);
         return nullptr;
     }
+    
+    loadRecordBody(header.length);
+    
+    switch (type) {
+        case RecordType::FAR: return parseFAR();
+        case RecordType::MIR: return parseMIR();
+        case RecordType::HBR: return parseHBR();
+        case RecordType::SBR: return parseSBR();
+        case RecordType::WIR: return parseWIR();
+        case RecordType::WRR: return parseWRR();
+        case RecordType::PIR: return parsePIR();
+        case RecordType::PRR: return parsePRR();
+        case RecordType::PTR: return parsePTR();
+        case RecordType::FTR: return parseFTR();
+        default:              return nullptr;
+    }
 }
 
 std::unique_ptr<FARRecord> STDFParser::parseFAR() {
     auto record = std::make_unique<FARRecord>();
-    record->CPU_TYP = readU1();
-    record->STDF_VER = readU1();
+    decodeFAR(*record);
     return record;
 }
 
+void STDFParser::decodeFAR(FARRecord& record) {
+    record.CPU_TYP = readU1();
+    record.STDF_VER = readU1();
+}
+
 std::unique_ptr<MIRRecord> STDFParser::parseMIR() {
     auto record = std::make_unique<MIRRecord>();
-    
-    record->SETUP_T = readU4();
-    record->START_T = readU4();
-    record->STAT_NUM = readU1();
-    record->MODE_COD = readC1();
-    record->RTST_COD = readC1();
-    record->PROT_COD = readC1();
-    record->BURN_TIM = readU2();
-    record->CMOD_COD = readC1();
-    record->LOT_ID = readCn();
-    record->PART_TYP = readCn();
-    record->NODE_NAM = readCn();
-    record->TSTR_TYP = readCn();
-    record->JOB_NAM = readCn();
-    record->JOB_REV = readCn();
-    record->SBLOT_ID = readCn();
-    record->OPER_NAM = readCn();
-    record->EXEC_TYP = readCn();
-    record->EXEC_VER = readCn();
-    record->TEST_COD = readCn();
-    record->TST_TEMP = readCn();
-    record->USER_TXT = readCn();
-    record->AUX_FILE = readCn();
-    record->PKG_TYP = readCn();
-    record->FAMLY_ID = readCn();
-    record->DATE_COD = readCn();
-    record->FACIL_ID = readCn();
-    record->FLOOR_ID = readCn();
-    record->PROC_ID = readCn();
-    record->OPER_FRQ = readCn();
-    record->SPEC_NAM = readCn();
-    record->SPEC_VER = readCn();
-    record->FLOW_ID = readCn();
-    record->SETUP_ID = readCn();
-    record->DSGN_REV = readCn();
-    record->ENG_ID = readCn();
-    record->ROM_COD = readCn();
-    record->SERL_NUM = readCn();
-    record->SUPR_NAM = readCn();
-    
+    decodeMIR(*record);
     return record;
 }
 
+void STDFParser::decodeMIR(MIRRecord& record) {
+    record.SETUP_T = readU4();
+    record.START_T = readU4();
+    record.STAT_NUM = readU1();
+    record.MODE_COD = readC1();
+    record.RTST_COD = readC1();
+    record.PROT_COD = readC1();
+    record.BURN_TIM = readU2();
+    record.CMOD_COD = readC1();
+    readCn(record.LOT_ID);
+    readCn(record.PART_TYP);
+    readCn(record.NODE_NAM);
+    readCn(record.TSTR_TYP);
+    readCn(record.JOB_NAM);
+    readCn(record.JOB_REV);
+    readCn(record.SBLOT_ID);
+    readCn(record.OPER_NAM);
+    readCn(record.EXEC_TYP);
+    readCn(record.EXEC_VER);
+    readCn(record.TEST_COD);
+    readCn(record.TST_TEMP);
+    readCn(record.USER_TXT);
+    readCn(record.AUX_FILE);
+    readCn(record.PKG_TYP);
+    readCn(record.FAMLY_ID);
+    readCn(record.DATE_COD);
+    readCn(record.FACIL_ID);
+    readCn(record.FLOOR_ID);
+    readCn(record.PROC_ID);
+    readCn(record.OPER_FRQ);
+    readCn(record.SPEC_NAM);
+    readCn(record.SPEC_VER);
+    readCn(record.FLOW_ID);
+    readCn(record.SETUP_ID);
+    readCn(record.DSGN_REV);
+    readCn(record.ENG_ID);
+    readCn(record.ROM_COD);
+    readCn(record.SERL_NUM);
+    readCn(record.SUPR_NAM);
+}
+
 std::unique_ptr<PIRRecord> STDFParser::parsePIR() {
     auto record = std::make_unique<PIRRecord>();
-    record->HEAD_NUM = readU1();
-    record->SITE_NUM = readU1();
+    decodePIR(*record);
     return record;
 }
 
+void STDFParser::decodePIR(PIRRecord& record) {
+    record.HEAD_NUM = readU1();
+    record.SITE_NUM = readU1();
+}
+
 std::unique_ptr<PRRRecord> STDFParser::parsePRR() {
     auto record = std::make_unique<PRRRecord>();
-    
-    record->HEAD_NUM = readU1();
-    record->SITE_NUM = readU1();
-    record->PART_FLG = readU1();
-    record->NUM_TEST = readU2();
-    record->HARD_BIN = readU2();
-    record->SOFT_BIN = readU2();
-    record->X_COORD = readI2();
-    record->Y_COORD = readI2();
-    record->TEST_T = readU4();
-    record->PART_ID = readCn();
-    record->PART_TXT = readCn();
-    record->PART_FIX = readBn();
-    
+    decodePRR(*record);
     return record;
 }
 
+void STDFParser::decodePRR(PRRRecord& record) {
+    record.HEAD_NUM = readU1();
+    record.SITE_NUM = readU1();
+    record.PART_FLG = readU1();
+    record.NUM_TEST = readU2();
+    record.HARD_BIN = readU2();
+    record.SOFT_BIN = readU2();
+    record.X_COORD = readI2();
+    record.Y_COORD = readI2();
+    record.TEST_T = readU4();
+    readCn(record.PART_ID);
+    readCn(record.PART_TXT);
+    readBn(record.PART_FIX);
+}
+
 std::unique_ptr<PTRRecord> STDFParser::parsePTR() {
     auto record = std::make_unique<PTRRecord>();
+    decodePTR(*record);
+    return record;
+}
+
+void STDFParser::decodePTR(PTRRecord& record) {
+    record.TEST_NUM = readU4();
+    record.HEAD_NUM = readU1();
+    record.SITE_NUM = readU1();
+    record.TEST_FLG = readU1();
+    record.PARM_FLG = readU1();
+    record.RESULT = readR4();
+    readCn(record.TEST_TXT);
+    readCn(record.ALARM_ID);
+    record.OPT_FLAG = readU1();
     
-    record->TEST_NUM = readU4();
-    record->HEAD_NUM = readU1();
-    record->SITE_NUM = readU1();
-    record->TEST_FLG = readU1();
-    record->PARM_FLG = readU1();
-    record->RESULT = readR4();
-    record->TEST_TXT = readCn();
-    record->ALARM_ID = readCn();
-    record->OPT_FLAG = readU1();
-    
-    // Optional fields based on OPT_FLAG
-    if (record->OPT_FLAG & 0x01) {
-        record->RES_SCAL = readI1();
-    }
-    if (record->OPT_FLAG & 0x06) {
-        record->LLM_SCAL = readI1();
-        record->LO_LIMIT = readR4();
+    // Optional fields based on OPT_FLAG; absent ones are reset so a reused
+    // record does not carry values over from the previous one
+    record.RES_SCAL = (record.OPT_FLAG & PTR_OPT_RES_SCAL) ? readI1() : 0;
+    if (record.OPT_FLAG & PTR_OPT_LO_LIMIT) {
+        record.LLM_SCAL = readI1();
+        record.LO_LIMIT = readR4();
+    } else {
+        record.LLM_SCAL = 0;
+        record.LO_LIMIT = 0.0f;
     }
-    if (record->OPT_FLAG & 0x18) {
-        record->HLM_SCAL = readI1();
-        record->HI_LIMIT = readR4();
+    if (record.OPT_FLAG & PTR_OPT_HI_LIMIT) {
+        record.HLM_SCAL = readI1();
+        record.HI_LIMIT = readR4();
+    } else {
+        record.HLM_SCAL = 0;
+        record.HI_LIMIT = 0.0f;
     }
-    if (record->OPT_FLAG & 0x20) {
-        record->UNITS = readCn();
+    if (record.OPT_FLAG & PTR_OPT_UNITS) {
+        readCn(record.UNITS);
+    } else {
+        record.UNITS.clear();
     }
-    if (record->OPT_FLAG & 0x40) {
-        record->C_RESFMT = readCn();
+    if (record.OPT_FLAG & PTR_OPT_RES_FMT) {
+        readCn(record.C_RESFMT);
+    } else {
+        record.C_RESFMT.clear();
     }
-    if (record->OPT_FLAG & 0x80) {
-        record->C_LLMFMT = readCn();
-        record->C_HLMFMT = readCn();
+    if (record.OPT_FLAG & PTR_OPT_LIM_FMT) {
+        readCn(record.C_LLMFMT);
+        readCn(record.C_HLMFMT);
+    } else {
+        record.C_LLMFMT.clear();
+        record.C_HLMFMT.clear();
     }
-    
-    return record;
 }
 
 std::unique_ptr<FTRRecord> STDFParser::parseFTR() {
     auto record = std::make_unique<FTRRecord>();
-    
-    record->TEST_NUM = readU4();
-    record->HEAD_NUM = readU1();
-    record->SITE_NUM = readU1();
-    record->TEST_FLG = readU1();
-    record->OPT_FLAG = readU1();
-    record->CYCL_CNT = readU4();
-    record->REL_VADR = readU4();
-    record->REPT_CNT = readU4();
-    record->NUM_FAIL = readU4();
-    record->XFAIL_AD = readI4();
-    record->YFAIL_AD = readI4();
-    record->VECT_OFF = readI2();
-    record->RTN_ICNT = readU2();
-    record->PGM_ICNT = readU2();
+    decodeFTR(*record);
+    return record;
+}
+
+void STDFParser::decodeFTR(FTRRecord& record) {
+    record.TEST_NUM = readU4();
+    record.HEAD_NUM = readU1();
+    record.SITE_NUM = readU1();
+    record.TEST_FLG = readU1();
+    record.OPT_FLAG = readU1();
+    record.CYCL_CNT = readU4();
+    record.REL_VADR = readU4();
+    record.REPT_CNT = readU4();
+    record.NUM_FAIL = readU4();
+    record.XFAIL_AD = readI4();
+    record.YFAIL_AD = readI4();
+    record.VECT_OFF = readI2();
+    record.RTN_ICNT = readU2();
+    record.PGM_ICNT = readU2();
     
     // Read return arrays
-    record->RTN_INDX.resize(record->RTN_ICNT);
-    record->RTN_STAT.resize(record->RTN_ICNT);
-    for (U2 i = 0; i < record->RTN_ICNT; ++i) {
-        record->RTN_INDX[i] = readU2();
+    record.RTN_INDX.resize(record.RTN_ICNT);
+    record.RTN_STAT.resize(record.RTN_ICNT);
+    for (U2 i = 0; i < record.RTN_ICNT; ++i) {
+        record.RTN_INDX[i] = readU2();
     }
-    for (U2 i = 0; i < record->RTN_ICNT; ++i) {
-        record->RTN_STAT[i] = readU2();
+    for (U2 i = 0; i < record.RTN_ICNT; ++i) {
+        record.RTN_STAT[i] = readU2();
     }
     
     // Read program arrays
-    record->PGM_INDX.resize(record->PGM_ICNT);
-    record->PGM_STAT.resize(record->PGM_ICNT);
-    for (U2 i = 0; i < record->PGM_ICNT; ++i) {
-        record->PGM_INDX[i] = readU2();
-    }
-    for (U2 i = 0; i < record->PGM_ICNT; ++i) {
-        record->PGM_STAT[i] = readU2();
-    }
-    
-    record->FAIL_PIN = readBn();
-    record->VECT_NAM = readCn();
-    record->TIME_SET = readCn();
-    record->OP_CODE = readCn();
-    record->TEST_TXT = readCn();
-    record->ALARM_ID = readCn();
-    record->PROG_TXT = readCn();
-    record->RSLT_TXT = readCn();
-    record->PATG_NUM = readU1();
-    record->SPIN_MAP = readBn();
+    record.PGM_INDX.resize(record.PGM_ICNT);
+    record.PGM_STAT.resize(record.PGM_ICNT);
+    for (U2 i = 0; i < record.PGM_ICNT; ++i) {
+        record.PGM_INDX[i] = readU2();
+    }
+    for (U2 i = 0; i < record.PGM_ICNT; ++i) {
+        record.PGM_STAT[i] = readU2();
+    }
     
-    return record;
+    readBn(record.FAIL_PIN);
+    readCn(record.VECT_NAM);
+    readCn(record.TIME_SET);
+    readCn(record.OP_CODE);
+    readCn(record.TEST_TXT);
+    readCn(record.ALARM_ID);
+    readCn(record.PROG_TXT);
+    readCn(record.RSLT_TXT);
+    record.PATG_NUM = readU1();
+    readBn(record.SPIN_MAP);
+}
+
+// View decoding methods
+void STDFParser::decodeFARView(FARView& view) {
+    view.CPU_TYP = readU1();
+    view.STDF_VER = readU1();
+}
+
+void STDFParser::decodeMIRView(MIRView& view) {
+    view.SETUP_T = readU4();
+    view.START_T = readU4();
+    view.STAT_NUM = readU1();
+    view.MODE_COD = readC1();
+    view.RTST_COD = readC1();
+    view.PROT_COD = readC1();
+    view.BURN_TIM = readU2();
+    view.CMOD_COD = readC1();
+    view.LOT_ID = readCnView();
+    view.PART_TYP = readCnView();
+    view.NODE_NAM = readCnView();
+    view.TSTR_TYP = readCnView();
+    view.JOB_NAM = readCnView();
+    view.JOB_REV = readCnView();
+    view.SBLOT_ID = readCnView();
+    view.OPER_NAM = readCnView();
+    view.EXEC_TYP = readCnView();
+    view.EXEC_VER = readCnView();
+    view.TEST_COD = readCnView();
+    view.TST_TEMP = readCnView();
+    view.USER_TXT = readCnView();
+    view.AUX_FILE = readCnView();
+    view.PKG_TYP = readCnView();
+    view.FAMLY_ID = readCnView();
+    view.DATE_COD = readCnView();
+    view.FACIL_ID = readCnView();
+    view.FLOOR_ID = readCnView();
+    view.PROC_ID = readCnView();
+    view.OPER_FRQ = readCnView();
+    view.SPEC_NAM = readCnView();
+    view.SPEC_VER = readCnView();
+    view.FLOW_ID = readCnView();
+    view.SETUP_ID = readCnView();
+    view.DSGN_REV = readCnView();
+    view.ENG_ID = readCnView();
+    view.ROM_COD = readCnView();
+    view.SERL_NUM = readCnView();
+    view.SUPR_NAM = readCnView();
+}
+
+void STDFParser::decodePIRView(PIRView& view) {
+    view.HEAD_NUM = readU1();
+    view.SITE_NUM = readU1();
+}
+
+void STDFParser::decodePRRView(PRRView& view) {
+    view.HEAD_NUM = readU1();
+    view.SITE_NUM = readU1();
+    view.PART_FLG = readU1();
+    view.NUM_TEST = readU2();
+    view.HARD_BIN = readU2();
+    view.SOFT_BIN = readU2();
+    view.X_COORD = readI2();
+    view.Y_COORD = readI2();
+    view.TEST_T = readU4();
+    view.PART_ID = readCnView();
+    view.PART_TXT = readCnView();
+    view.PART_FIX = readBnView();
+}
+
+void STDFParser::decodePTRView(PTRView& view) {
+    view.TEST_NUM = readU4();
+    view.HEAD_NUM = readU1();
+    view.SITE_NUM = readU1();
+    view.TEST_FLG = readU1();
+    view.PARM_FLG = readU1();
+    view.RESULT = readR4();
+    view.TEST_TXT = readCnView();
+    view.ALARM_ID = readCnView();
+    view.OPT_FLAG = readU1();
+    view.optionalData = readRemainingView();
+    view.swap = endianSwap_;
+}
+
+void STDFParser::decodeFTRView(FTRView& view) {
+    view.TEST_NUM = readU4();
+    view.HEAD_NUM = readU1();
+    view.SITE_NUM = readU1();
+    view.TEST_FLG = readU1();
+    view.OPT_FLAG = readU1();
+    view.CYCL_CNT = readU4();
+    view.REL_VADR = readU4();
+    view.REPT_CNT = readU4();
+    view.NUM_FAIL = readU4();
+    view.XFAIL_AD = readI4();
+    view.YFAIL_AD = readI4();
+    view.VECT_OFF = readI2();
+    view.RTN_ICNT = readU2();
+    view.PGM_ICNT = readU2();
+    view.variableData = readRemainingView();
+    view.swap = endianSwap_;
+}
+
+void STDFParser::decodeHBRView(HBRView& view) {
+    view.HEAD_NUM = readU1();
+    view.SITE_NUM = readU1();
+    view.HBIN_NUM = readU2();
+    view.HBIN_CNT = readU4();
+    view.HBIN_PF = readC1();
+    view.HBIN_NAM = readCnView();
+}
+
+void STDFParser::decodeSBRView(SBRView& view) {
+    view.HEAD_NUM = readU1();
+    view.SITE_NUM = readU1();
+    view.SBIN_NUM = readU2();
+    view.SBIN_CNT = readU4();
+    view.SBIN_PF = readC1();
+    view.SBIN_NAM = readCnView();
+}
+
+void STDFParser::decodeWIRView(WIRView& view) {
+    view.HEAD_NUM = readU1();
+    view.SITE_GRP = readU1();
+    view.START_T = readU4();
+    view.WAFER_ID = readCnView();
+}
+
+void STDFParser::decodeWRRView(WRRView& view) {
+    view.HEAD_NUM = readU1();
+    view.SITE_GRP = readU1();
+    view.FINISH_T = readU4();
+    view.PART_CNT = readU4();
+    view.RTST_CNT = readU4();
+    view.ABRT_CNT = readU4();
+    view.GOOD_CNT = readU4();
+    view.FUNC_CNT = readU4();
+    view.WAFER_ID = readCnView();
+    view.FABWF_ID = readCnView();
+    view.FRAME_ID = readCnView();
+    view.MASK_ID = readCnView();
+    view.USR_DESC = readCnView();
+    view.EXC_DESC = readCnView();
 }
 
 // Utility methods
@@ -419,57 +1169,93 @@ U4 STDFParser::swapBytes(U4 value) {
 }
 
 void STDFParser::skipBytes(size_t count) {
-    file_.seekg(count, std::ios::cur);
+    size_t skipped = count;
+    if (seekable_ && skipped > fileSize_ - position_) {
+        skipped = fileSize_ - position_;
+    }
+    if (mode_ == InputMode::Stream) {
+        if (seekable_ && skipped >= SEEK_THRESHOLD) {
+            file_.seekg(static_cast<std::streamoff>(skipped), std::ios::cur);
+        } else {
+            // A seek throws away the stream buffer, so short skips (and all
+            // skips on pipes, where seekg() fails) read through it instead
+            file_.ignore(static_cast<std::streamsize>(skipped));
+            skipped = static_cast<size_t>(file_.gcount());
+        }
+    }
+    position_ += skipped;
+    cursor_ = recordEnd_ = nullptr;
+    if (skipped != count) {
+        // A skipped body is as truncated as a decoded one
+        position_ = fileSize_;
+        throw std::runtime_error("Truncated record in " + filename_);
+    }
 }
 
 std::unique_ptr<HBRRecord> STDFParser::parseHBR() {
     auto record = std::make_unique<HBRRecord>();
-    record->HEAD_NUM = readU1();
-    record->SITE_NUM = readU1();
-    record->HBIN_NUM = readU2();
-    record->HBIN_CNT = readU4();
-    record->HBIN_PF = readC1();
-    record->HBIN_NAM = readCn();
+    decodeHBR(*record);
     return record;
 }
 
+void STDFParser::decodeHBR(HBRRecord& record) {
+    record.HEAD_NUM = readU1();
+    record.SITE_NUM = readU1();
+    record.HBIN_NUM = readU2();
+    record.HBIN_CNT = readU4();
+    record.HBIN_PF = readC1();
+    readCn(record.HBIN_NAM);
+}
+
 std::unique_ptr<SBRRecord> STDFParser::parseSBR() {
     auto record = std::make_unique<SBRRecord>();
-    record->HEAD_NUM = readU1();
-    record->SITE_NUM = readU1();
-    record->SBIN_NUM = readU2();
-    record->SBIN_CNT = readU4();
-    record->SBIN_PF = readC1();
-    record->SBIN_NAM = readCn();
+    decodeSBR(*record);
     return record;
 }
 
+void STDFParser::decodeSBR(SBRRecord& record) {
+    record.HEAD_NUM = readU1();
+    record.SITE_NUM = readU1();
+    record.SBIN_NUM = readU2();
+    record.SBIN_CNT = readU4();
+    record.SBIN_PF = readC1();
+    readCn(record.SBIN_NAM);
+}
+
 std::unique_ptr<WIRRecord> STDFParser::parseWIR() {
     auto record = std::make_unique<WIRRecord>();
-    record->HEAD_NUM = readU1();
-    record->SITE_GRP = readU1();
-    record->START_T = readU4();
-    record->WAFER_ID = readCn();
+    decodeWIR(*record);
     return record;
 }
 
+void STDFParser::decodeWIR(WIRRecord& record) {
+    record.HEAD_NUM = readU1();
+    record.SITE_GRP = readU1();
+    record.START_T = readU4();
+    readCn(record.WAFER_ID);
+}
+
 std::unique_ptr<WRRRecord> STDFParser::parseWRR() {
     auto record = std::make_unique<WRRRecord>();
-    record->HEAD_NUM = readU1();
-    record->SITE_GRP = readU1();
-    record->FINISH_T = readU4();
-    record->PART_CNT = readU4();
-    record->RTST_CNT = readU4();
-    record->ABRT_CNT = readU4();
-    record->GOOD_CNT = readU4();
-    record->FUNC_CNT = readU4();
-    record->WAFER_ID = readCn();
-    record->FABWF_ID = readCn();
-    record->FRAME_ID = readCn();
-    record->MASK_ID = readCn();
-    record->USR_DESC = readCn();
-    record->EXC_DESC = readCn();
+    decodeWRR(*record);
     return record;
 }
 
+void STDFParser::decodeWRR(WRRRecord& record) {
+    record.HEAD_NUM = readU1();
+    record.SITE_GRP = readU1();
+    record.FINISH_T = readU4();
+    record.PART_CNT = readU4();
+    record.RTST_CNT = readU4();
+    record.ABRT_CNT = readU4();
+    record.GOOD_CNT = readU4();
+    record.FUNC_CNT = readU4();
+    readCn(record.WAFER_ID);
+    readCn(record.FABWF_ID);
+    readCn(record.FRAME_ID);
+    readCn(record.MASK_ID);
+    readCn(record.USR_DESC);
+    readCn(record.EXC_DESC);
+}
+
 } // namespace STDF
\ No newline at end of file
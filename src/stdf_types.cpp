@@ -21,9 +21,35 @@
 #include "stdf_types.h"
 #include <sstream>
 #include <iomanip>
+#include <strings.h>
 
 namespace STDF {
 
+namespace {
+
+// Mnemonics in RecordType order
+const char* const RECORD_TYPE_NAMES[RECORD_TYPE_COUNT] = {
+    "FAR", "ATR", "MIR", "MRR", "PCR", "HBR", "SBR", "PMR", "PGR", "PLR", "RDR", "SDR", "WIR",
+    "WRR", "WCR", "PIR", "PRR", "TSR", "PTR", "MPR", "FTR", "BPS", "EPS", "GDR", "DTR"
+};
+
+} // namespace
+
+const char* recordTypeName(RecordType type) {
+    size_t index = static_cast<size_t>(type);
+    return index < RECORD_TYPE_COUNT ? RECORD_TYPE_NAMES[index] : "UNKNOWN";
+}
+
+bool recordTypeFromName(const std::string& name, RecordType& type) {
+    for (size_t i = 0; i < RECORD_TYPE_COUNT; ++i) {
+        if (strcasecmp(name.c_str(), RECORD_TYPE_NAMES[i]) == 0) {
+            type = static_cast<RecordType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
 // FARRecord implementation
 std::string FARRecord::toString() const {
     std::ostringstream oss;
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Zero-copy STDF record views
+ *              On-demand decoding of the optional PTR fields and the FTR arrays and strings
+ */
+
+#include "stdf_views.h"
+
+namespace STDF {
+
+// PTRView implementation
+FieldReader PTRView::optionalFieldsAfter(U1 skip) const {
+    FieldReader reader(optionalData.data, optionalData.data + optionalData.size, swap);
+    if (skip & OPT_FLAG & PTR_OPT_RES_SCAL) {
+        reader.skip(1);
+    }
+    if (skip & OPT_FLAG & PTR_OPT_LO_LIMIT) {
+        reader.skip(5);
+    }
+    if (skip & OPT_FLAG & PTR_OPT_HI_LIMIT) {
+        reader.skip(5);
+    }
+    if (skip & OPT_FLAG & PTR_OPT_UNITS) {
+        reader.cn();
+    }
+    if (skip & OPT_FLAG & PTR_OPT_RES_FMT) {
+        reader.cn();
+    }
+    return reader;
+}
+
+I1 PTRView::resScale() const {
+    return (OPT_FLAG & PTR_OPT_RES_SCAL) ? optionalFieldsAfter(0).i1() : 0;
+}
+
+PTRLimits PTRView::limits() const {
+    PTRLimits result;
+    FieldReader reader = optionalFieldsAfter(PTR_OPT_RES_SCAL);
+    if (OPT_FLAG & PTR_OPT_LO_LIMIT) {
+        result.hasLow = true;
+        result.LLM_SCAL = reader.i1();
+        result.LO_LIMIT = reader.r4();
+    }
+    if (OPT_FLAG & PTR_OPT_HI_LIMIT) {
+        result.hasHigh = true;
+        result.HLM_SCAL = reader.i1();
+        result.HI_LIMIT = reader.r4();
+    }
+    return result;
+}
+
+CnView PTRView::units() const {
+    if (!(OPT_FLAG & PTR_OPT_UNITS)) {
+        return CnView();
+    }
+    return optionalFieldsAfter(PTR_OPT_RES_SCAL | PTR_OPT_LO_LIMIT | PTR_OPT_HI_LIMIT).cn();
+}
+
+CnView PTRView::resultFormat() const {
+    if (!(OPT_FLAG & PTR_OPT_RES_FMT)) {
+        return CnView();
+    }
+    return optionalFieldsAfter(PTR_OPT_RES_SCAL | PTR_OPT_LO_LIMIT | PTR_OPT_HI_LIMIT |
+                               PTR_OPT_UNITS).cn();
+}
+
+CnView PTRView::lowLimitFormat() const {
+    if (!(OPT_FLAG & PTR_OPT_LIM_FMT)) {
+        return CnView();
+    }
+    return optionalFieldsAfter(static_cast<U1>(~PTR_OPT_LIM_FMT)).cn();
+}
+
+CnView PTRView::highLimitFormat() const {
+    if (!(OPT_FLAG & PTR_OPT_LIM_FMT)) {
+        return CnView();
+    }
+    FieldReader reader = optionalFieldsAfter(static_cast<U1>(~PTR_OPT_LIM_FMT));
+    reader.cn();
+    return reader.cn();
+}
+
+// FTRView implementation
+FieldReader FTRView::afterArrays(int field) const {
+    FieldReader reader(variableData.data, variableData.data + variableData.size, swap);
+    reader.skip((static_cast<size_t>(RTN_ICNT) + PGM_ICNT) * 2 * sizeof(U2));
+    // FAIL_PIN, then the seven strings in file order
+    for (int i = 0; i < field; ++i) {
+        if (i == 0) {
+            reader.bn();
+        } else {
+            reader.cn();
+        }
+    }
+    return reader;
+}
+
+U2ArrayView FTRView::rtnIndex() const {
+    FieldReader reader(variableData.data, variableData.data + variableData.size, swap);
+    return reader.u2Array(RTN_ICNT);
+}
+
+U2ArrayView FTRView::rtnStat() const {
+    FieldReader reader(variableData.data, variableData.data + variableData.size, swap);
+    reader.skip(RTN_ICNT * sizeof(U2));
+    return reader.u2Array(RTN_ICNT);
+}
+
+U2ArrayView FTRView::pgmIndex() const {
+    FieldReader reader(variableData.data, variableData.data + variableData.size, swap);
+    reader.skip(RTN_ICNT * 2 * sizeof(U2));
+    return reader.u2Array(PGM_ICNT);
+}
+
+U2ArrayView FTRView::pgmStat() const {
+    FieldReader reader(variableData.data, variableData.data + variableData.size, swap);
+    reader.skip((RTN_ICNT * 2 + PGM_ICNT) * sizeof(U2));
+    return reader.u2Array(PGM_ICNT);
+}
+
+BnView FTRView::failPin() const { return afterArrays(0).bn(); }
+CnView FTRView::vectName() const { return afterArrays(1).cn(); }
+CnView FTRView::timeSet() const { return afterArrays(2).cn(); }
+CnView FTRView::opCode() const { return afterArrays(3).cn(); }
+CnView FTRView::testText() const { return afterArrays(4).cn(); }
+CnView FTRView::alarmId() const { return afterArrays(5).cn(); }
+CnView FTRView::progText() const { return afterArrays(6).cn(); }
+CnView FTRView::resultText() const { return afterArrays(7).cn(); }
+U1 FTRView::patternNumber() const { return afterArrays(8).u1(); }
+
+BnView FTRView::spinMap() const {
+    FieldReader reader = afterArrays(8);
+    reader.u1(); // PATG_NUM
+    return reader.bn();
+}
+
+} // namespace STDF
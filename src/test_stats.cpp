@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Streaming per-test parametric statistics implementation
+ *              Parallel-merge formulas follow Chan et al. for the second moment
+ */
+
+#include "test_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+namespace STDF {
+
+// === TestStats ===
+
+void TestStats::merge(const TestStats& other) {
+    if (other.count > 0) {
+        if (count == 0) {
+            mean = other.mean;
+            m2 = other.m2;
+            min = other.min;
+            max = other.max;
+        } else {
+            double n = static_cast<double>(count + other.count);
+            double delta = other.mean - mean;
+            mean += delta * static_cast<double>(other.count) / n;
+            m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / n;
+            min = std::min(min, other.min);
+            max = std::max(max, other.max);
+        }
+        count += other.count;
+    }
+    passed += other.passed;
+    failed += other.failed;
+    invalid += other.invalid;
+
+    if (!hasLoLimit && other.hasLoLimit) {
+        hasLoLimit = true;
+        loLimit = other.loLimit;
+    }
+    if (!hasHiLimit && other.hasHiLimit) {
+        hasHiLimit = true;
+        hiLimit = other.hiLimit;
+    }
+    if (testText.empty()) testText = other.testText;
+    if (units.empty()) units = other.units;
+}
+
+double TestStats::stddev() const {
+    return std::sqrt(variance());
+}
+
+double TestStats::cp() const {
+    double sigma = stddev();
+    if (!hasLoLimit || !hasHiLimit || !(sigma > 0.0)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return (hiLimit - loLimit) / (6.0 * sigma);
+}
+
+double TestStats::cpk() const {
+    double sigma = stddev();
+    if ((!hasLoLimit && !hasHiLimit) || !(sigma > 0.0)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    double cpk = std::numeric_limits<double>::infinity();
+    if (hasHiLimit) cpk = std::min(cpk, (hiLimit - mean) / (3.0 * sigma));
+    if (hasLoLimit) cpk = std::min(cpk, (mean - loLimit) / (3.0 * sigma));
+    return cpk;
+}
+
+// === TestStatsAccumulator ===
+
+TestStats& TestStatsAccumulator::entry(U4 testNum, U1 headNum, U1 siteNum) {
+    auto inserted = index_.emplace(key(testNum, headNum, siteNum), stats_.size());
+    if (!inserted.second) {
+        return stats_[inserted.first->second];
+    }
+
+    stats_.emplace_back();
+    TestStats& stats = stats_.back();
+    stats.testNum = testNum;
+    stats.headNum = headNum;
+    stats.siteNum = siteNum;
+    auto limits = limits_.find(testNum);
+    if (limits != limits_.end()) {
+        stats.hasLoLimit = limits->second.hasLo;
+        stats.hasHiLimit = limits->second.hasHi;
+        stats.loLimit = limits->second.lo;
+        stats.hiLimit = limits->second.hi;
+    }
+    return stats;
+}
+
+void TestStatsAccumulator::add(const PTRRecord& record) {
+    // Limits are only present when OPT_FLAG says so (see decodePTR)
+    bool hasLo = (record.OPT_FLAG & PTR_OPT_LO_LIMIT) != 0;
+    bool hasHi = (record.OPT_FLAG & PTR_OPT_HI_LIMIT) != 0;
+    if (hasLo || hasHi) {
+        Limits& limits = limits_[record.TEST_NUM];
+        if (hasLo) {
+            limits.hasLo = true;
+            limits.lo = record.LO_LIMIT;
+        }
+        if (hasHi) {
+            limits.hasHi = true;
+            limits.hi = record.HI_LIMIT;
+        }
+    }
+
+    TestStats& stats = entry(record.TEST_NUM, record.HEAD_NUM, record.SITE_NUM);
+    if (hasLo) {
+        stats.hasLoLimit = true;
+        stats.loLimit = record.LO_LIMIT;
+    }
+    if (hasHi) {
+        stats.hasHiLimit = true;
+        stats.hiLimit = record.HI_LIMIT;
+    }
+    if (stats.testText.empty() && !record.TEST_TXT.empty()) {
+        stats.testText = record.TEST_TXT;
+    }
+    if (stats.units.empty() && !record.UNITS.empty()) {
+        stats.units = record.UNITS;
+    }
+
+    if (record.TEST_FLG & PTR_FLG_NOT_EXECUTED) {
+        stats.invalid++;
+        return;
+    }
+    if (record.TEST_FLG & PTR_FLG_FAILED) {
+        stats.failed++;
+    } else if (!(record.TEST_FLG & PTR_FLG_NO_PASS_FAIL)) {
+        stats.passed++;
+    }
+    if ((record.TEST_FLG & PTR_FLG_RESULT_INVALID) || std::isnan(record.RESULT)) {
+        stats.invalid++;
+    } else {
+        stats.add(record.RESULT);
+    }
+}
+
+void TestStatsAccumulator::merge(const TestStatsAccumulator& other) {
+    for (const auto& limits : other.limits_) {
+        limits_.emplace(limits.first, limits.second);
+    }
+    for (const TestStats& stats : other.stats_) {
+        entry(stats.testNum, stats.headNum, stats.siteNum).merge(stats);
+    }
+}
+
+std::vector<TestStats> TestStatsAccumulator::getResults() const {
+    std::vector<TestStats> results = stats_;
+    std::sort(results.begin(), results.end(), [](const TestStats& a, const TestStats& b) {
+        return key(a.testNum, a.headNum, a.siteNum) < key(b.testNum, b.headNum, b.siteNum);
+    });
+    return results;
+}
+
+void TestStatsAccumulator::clear() {
+    stats_.clear();
+    index_.clear();
+    limits_.clear();
+}
+
+void TestStatsAccumulator::writeReport(std::ostream& out, const std::vector<TestStats>& results) {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    // Missing limits and undefined capabilities print as "-"
+    auto number = [&out](bool present, double value) {
+        if (present && std::isfinite(value)) {
+            out << std::setw(13) << value;
+        } else {
+            out << std::setw(13) << "-";
+        }
+    };
+
+    out << std::left << std::setw(10) << "TEST" << std::right
+        << std::setw(5) << "HEAD" << std::setw(5) << "SITE"
+        << std::setw(10) << "COUNT" << std::setw(8) << "FAIL"
+        << std::setw(13) << "MEAN" << std::setw(13) << "STDDEV"
+        << std::setw(13) << "MIN" << std::setw(13) << "MAX"
+        << std::setw(13) << "LO_LIMIT" << std::setw(13) << "HI_LIMIT"
+        << std::setw(13) << "CP" << std::setw(13) << "CPK"
+        << "  NAME\n";
+
+    out << std::setprecision(6);
+    for (const TestStats& stats : results) {
+        out << std::left << std::setw(10) << stats.testNum << std::right
+            << std::setw(5) << static_cast<int>(stats.headNum)
+            << std::setw(5) << static_cast<int>(stats.siteNum)
+            << std::setw(10) << stats.count << std::setw(8) << stats.failed;
+        number(stats.count > 0, stats.mean);
+        number(stats.count > 1, stats.stddev());
+        number(stats.count > 0, stats.min);
+        number(stats.count > 0, stats.max);
+        number(stats.hasLoLimit, stats.loLimit);
+        number(stats.hasHiLimit, stats.hiLimit);
+        number(true, stats.cp());
+        number(true, stats.cpk());
+        out << "  " << stats.testText;
+        if (!stats.units.empty()) {
+            out << " [" << stats.units << "]";
+        }
+        out << "\n";
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+} // namespace STDF
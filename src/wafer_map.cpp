@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2025 ComputingStudios
+ *
+ * Project Director: Sushanth Sivaram
+ * Author: AI Assistant (Claude-4-Sonnet) with Cursor IDE
+ * Generated: July 2025
+ *
+ * This file is part of the STDF Parser project, a high-performance C++ library
+ * for parsing Standard Test Data Format files used in semiconductor testing.
+ *
+ * This software was generated using Cursor IDE with Claude-4-Sonnet AI assistance,
+ * under the direction of Sushanth Sivaram, providing advanced code generation
+ * and optimization capabilities.
+ *
+ * Licensed under the MIT License. See LICENSE file for details.
+ *
+ * Description: Wafer map building, image rendering and binary serialization
+ *              Dies are buffered per open wafer and scattered into the grid at WRR
+ */
+
+#include "wafer_map.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace STDF {
+
+namespace {
+
+const char WAFER_MAP_MAGIC[8] = {'S', 'T', 'D', 'F', 'W', 'M', 'P', '1'};
+
+// PRR coordinate value meaning "no coordinates"
+const I2 NO_COORD = -32768;
+
+struct Rgb {
+    uint8_t r, g, b;
+};
+
+const Rgb PASS_COLOR = {0, 190, 0};
+const Rgb NO_DIE_COLOR = {40, 40, 40};
+
+// Failing bins cycle through these by bin number
+const Rgb FAIL_PALETTE[] = {
+    {220, 30, 30},   {240, 140, 0},  {240, 220, 0},   {30, 90, 230},
+    {160, 40, 200},  {0, 190, 200},  {230, 90, 160},  {140, 90, 40},
+    {250, 250, 250}, {120, 120, 120}, {120, 0, 0},    {0, 0, 130},
+};
+
+void putU(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : data_(data), size_(size), pos_(0) {}
+
+    uint64_t u(int bytes) {
+        require(static_cast<size_t>(bytes));
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(data_[pos_++]) << (8 * i);
+        }
+        return value;
+    }
+
+    std::string string() {
+        size_t length = static_cast<size_t>(u(2));
+        require(length);
+        std::string value(reinterpret_cast<const char*>(data_ + pos_), length);
+        pos_ += length;
+        return value;
+    }
+
+    size_t remaining() const { return size_ - pos_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_;
+
+    void require(size_t bytes) const {
+        if (bytes > size_ - pos_) {
+            throw std::runtime_error("Corrupt wafer map: data is truncated");
+        }
+    }
+};
+
+// Writes a binary PNM image whose pixels come from pixel(x, y) per die,
+// each die drawn as a scale x scale block
+template <typename PixelFn>
+void writePNM(const std::string& path, const char* magic, size_t channels, const WaferMap& map,
+              unsigned scale, PixelFn pixel) {
+    scale = std::max(scale, 1u);
+    size_t width = static_cast<size_t>(map.width) * scale;
+    size_t height = static_cast<size_t>(map.height) * scale;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open file for writing: " + path);
+    }
+    out << magic << "\n" << width << " " << height << "\n255\n";
+
+    std::vector<uint8_t> row(width * channels);
+    for (size_t y = 0; y < map.height; ++y) {
+        for (size_t x = 0; x < map.width; ++x) {
+            uint8_t* die = &row[x * scale * channels];
+            pixel(y * map.width + x, die);
+            for (size_t i = 1; i < scale; ++i) {
+                std::memcpy(die + i * channels, die, channels);
+            }
+        }
+        for (unsigned i = 0; i < scale; ++i) {
+            out.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+        }
+    }
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed to write wafer map image: " + path);
+    }
+}
+
+} // namespace
+
+// === WaferMap ===
+
+void WaferMap::writePGM(const std::string& path, const std::unordered_set<U2>& passBins,
+                        bool softBin, unsigned scale) const {
+    const std::vector<U2>& bins = softBin ? softBins : hardBins;
+    writePNM(path, "P5", 1, *this, scale, [&](size_t cell, uint8_t* pixel) {
+        U2 bin = bins[cell];
+        pixel[0] = bin == NO_DIE ? 0 : passBins.count(bin) ? 255 : 128;
+    });
+}
+
+void WaferMap::writePPM(const std::string& path, const std::unordered_set<U2>& passBins,
+                        bool softBin, unsigned scale) const {
+    const std::vector<U2>& bins = softBin ? softBins : hardBins;
+    const size_t paletteSize = sizeof(FAIL_PALETTE) / sizeof(FAIL_PALETTE[0]);
+    writePNM(path, "P6", 3, *this, scale, [&](size_t cell, uint8_t* pixel) {
+        U2 bin = bins[cell];
+        const Rgb& color = bin == NO_DIE ? NO_DIE_COLOR
+                         : passBins.count(bin) ? PASS_COLOR
+                         : FAIL_PALETTE[bin % paletteSize];
+        pixel[0] = color.r;
+        pixel[1] = color.g;
+        pixel[2] = color.b;
+    });
+}
+
+std::vector<uint8_t> WaferMap::serialize() const {
+    std::vector<uint8_t> out(WAFER_MAP_MAGIC, WAFER_MAP_MAGIC + sizeof(WAFER_MAP_MAGIC));
+    out.reserve(out.size() + 32 + waferId.size() + hardBins.size() * 4);
+    putU(out, headNum, 1);
+    size_t idLength = std::min<size_t>(waferId.size(), UINT16_MAX);
+    putU(out, idLength, 2);
+    out.insert(out.end(), waferId.begin(), waferId.begin() + static_cast<std::ptrdiff_t>(idLength));
+    putU(out, static_cast<U2>(minX), 2);
+    putU(out, static_cast<U2>(minY), 2);
+    putU(out, width, 2);
+    putU(out, height, 2);
+    putU(out, dieCount, 4);
+    for (U2 bin : hardBins) putU(out, bin, 2);
+    for (U2 bin : softBins) putU(out, bin, 2);
+    return out;
+}
+
+WaferMap WaferMap::deserialize(const std::vector<uint8_t>& data) {
+    if (data.size() < sizeof(WAFER_MAP_MAGIC) ||
+        std::memcmp(data.data(), WAFER_MAP_MAGIC, sizeof(WAFER_MAP_MAGIC)) != 0) {
+        throw std::runtime_error("Not a wafer map file");
+    }
+    ByteReader in(data.data() + sizeof(WAFER_MAP_MAGIC), data.size() - sizeof(WAFER_MAP_MAGIC));
+    WaferMap map;
+    map.headNum = static_cast<U1>(in.u(1));
+    map.waferId = in.string();
+    map.minX = static_cast<I2>(static_cast<U2>(in.u(2)));
+    map.minY = static_cast<I2>(static_cast<U2>(in.u(2)));
+    map.width = static_cast<U2>(in.u(2));
+    map.height = static_cast<U2>(in.u(2));
+    map.dieCount = static_cast<U4>(in.u(4));
+
+    size_t cells = static_cast<size_t>(map.width) * map.height;
+    if (in.remaining() != cells * 4) {
+        throw std::runtime_error("Corrupt wafer map: grid size does not match the data");
+    }
+    map.hardBins.resize(cells);
+    map.softBins.resize(cells);
+    for (U2& bin : map.hardBins) bin = static_cast<U2>(in.u(2));
+    for (U2& bin : map.softBins) bin = static_cast<U2>(in.u(2));
+    return map;
+}
+
+void WaferMap::save(const std::string& path) const {
+    std::vector<uint8_t> data = serialize();
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed to write wafer map file: " + path);
+    }
+}
+
+WaferMap WaferMap::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return deserialize(data);
+}
+
+// === WaferMapBuilder ===
+
+void WaferMapBuilder::onWIR(const WIRRecord& record) {
+    auto it = open_.find(record.HEAD_NUM);
+    if (it != open_.end()) {
+        // A new WIR without a WRR closes the previous wafer on this head
+        build(record.HEAD_NUM, it->second);
+    }
+    OpenWafer& wafer = open_[record.HEAD_NUM];
+    wafer.waferId = record.WAFER_ID;
+    wafer.dies.clear();
+}
+
+void WaferMapBuilder::onPRR(const PRRRecord& record) {
+    if (record.X_COORD == NO_COORD || record.Y_COORD == NO_COORD) {
+        return;
+    }
+    open_[record.HEAD_NUM].dies.push_back({record.X_COORD, record.Y_COORD, record.HARD_BIN, record.SOFT_BIN});
+}
+
+void WaferMapBuilder::onWRR(const WRRRecord& record) {
+    auto it = open_.find(record.HEAD_NUM);
+    if (it == open_.end()) {
+        return;
+    }
+    if (it->second.waferId.empty()) {
+        it->second.waferId = record.WAFER_ID;
+    }
+    build(record.HEAD_NUM, it->second);
+    open_.erase(it);
+}
+
+void WaferMapBuilder::finish() {
+    // Build in head order so the result does not depend on hashing
+    std::vector<U1> heads;
+    for (const auto& item : open_) {
+        heads.push_back(item.first);
+    }
+    std::sort(heads.begin(), heads.end());
+    for (U1 head : heads) {
+        build(head, open_[head]);
+    }
+    open_.clear();
+}
+
+std::vector<WaferMap> WaferMapBuilder::takeMaps() {
+    std::vector<WaferMap> maps;
+    maps.swap(maps_);
+    return maps;
+}
+
+void WaferMapBuilder::build(U1 headNum, OpenWafer& wafer) {
+    if (wafer.dies.empty()) {
+        return;
+    }
+
+    I2 minX = wafer.dies.front().x, maxX = minX;
+    I2 minY = wafer.dies.front().y, maxY = minY;
+    for (const Die& die : wafer.dies) {
+        minX = std::min(minX, die.x);
+        maxX = std::max(maxX, die.x);
+        minY = std::min(minY, die.y);
+        maxY = std::max(maxY, die.y);
+    }
+    size_t width = static_cast<size_t>(maxX - minX) + 1;
+    size_t height = static_cast<size_t>(maxY - minY) + 1;
+    if (width > UINT16_MAX || height > UINT16_MAX || width * height > MAX_CELLS) {
+        STDF_LOG_WARNING << "Skipping wafer map for wafer '" << wafer.waferId << "': coordinate range "
+                         << width << "x" << height << " is too large";
+        wafer.dies.clear();
+        return;
+    }
+
+    WaferMap map;
+    map.waferId = wafer.waferId;
+    map.headNum = headNum;
+    map.minX = minX;
+    map.minY = minY;
+    map.width = static_cast<U2>(width);
+    map.height = static_cast<U2>(height);
+    map.hardBins.assign(width * height, WaferMap::NO_DIE);
+    map.softBins.assign(width * height, WaferMap::NO_DIE);
+    for (const Die& die : wafer.dies) {
+        size_t cell = map.cell(die.x, die.y);
+        if (map.hardBins[cell] == WaferMap::NO_DIE) {
+            map.dieCount++;
+        }
+        map.hardBins[cell] = die.hardBin;
+        map.softBins[cell] = die.softBin;
+    }
+    maps_.push_back(std::move(map));
+    wafer.dies.clear();
+}
+
+std::vector<WaferMap> loadWaferMaps(const std::string& path, InputMode mode) {
+    WaferMapBuilder builder;
+    STDFParser parser(path, mode);
+    parser.setRecordFilter({RecordType::WIR, RecordType::PRR, RecordType::WRR});
+    parser.parse(builder);
+    if (!parser.getLastError().empty()) {
+        throw std::runtime_error(path + ": " + parser.getLastError());
+    }
+    builder.finish();
+    return builder.takeMaps();
+}
+
+} // namespace STDF
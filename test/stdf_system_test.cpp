@@ -10,9 +10,24 @@
 #include "stdf_types.h"
 #include "stdf_parser.h"
 #include "database.h"
+#include "batch_ingest.h"
+#include "spsc_ring.h"
+#include "columnar_file.h"
+#include "record_export.h"
+#include "test_stats.h"
+#include "quantile_sketch.h"
+#include "wafer_map.h"
+#include "site_yield.h"
+#include "limit_whatif.h"
 #include "logger.h"
+#include <algorithm>
 #include <fstream>
 #include <filesystem>
+#include <cstring>
+#include <sstream>
+#include <cmath>
+#include <set>
+#include <thread>
 
 using namespace STDF;
 
@@ -22,6 +37,75 @@ auto temp_db_path = []() {
     return path;
 };
 
+// Helper: Assemble hand-crafted STDF records and write them to a temporary file
+class StdfBytes {
+public:
+    explicit StdfBytes(bool bigEndian = false) : bigEndian_(bigEndian) {}
+
+    StdfBytes& u1(uint8_t v) { body_.push_back(v); return *this; }
+    StdfBytes& u2(uint16_t v) { return put(v, 2); }
+    StdfBytes& u4(uint32_t v) { return put(v, 4); }
+    StdfBytes& r4(float v) { uint32_t bits; std::memcpy(&bits, &v, 4); return put(bits, 4); }
+    StdfBytes& cn(const std::string& v) {
+        u1(static_cast<uint8_t>(v.size()));
+        body_.insert(body_.end(), v.begin(), v.end());
+        return *this;
+    }
+
+    // Close the current body as a record with the given type/subtype
+    StdfBytes& record(uint8_t type, uint8_t sub) {
+        std::vector<uint8_t> body;
+        body.swap(body_);
+        put(static_cast<uint16_t>(body.size()), 2);
+        u1(type);
+        u1(sub);
+        bytes_.insert(bytes_.end(), body_.begin(), body_.end());
+        bytes_.insert(bytes_.end(), body.begin(), body.end());
+        body_.clear();
+        return *this;
+    }
+
+    StdfBytes& far() { return u1(bigEndian_ ? 1 : 2).u1(4).record(0, 10); }
+    StdfBytes& pir(uint8_t head, uint8_t site) { return u1(head).u1(site).record(5, 10); }
+    StdfBytes& ptr(uint32_t testNum, uint8_t site, float result) {
+        return u4(testNum).u1(1).u1(site).u1(0).u1(0).r4(result)
+               .cn("TEST_" + std::to_string(testNum)).cn("").u1(0).record(15, 10);
+    }
+    StdfBytes& prr(uint8_t site, uint16_t hardBin, int16_t x, int16_t y) {
+        return u1(1).u1(site).u1(0).u2(1).u2(hardBin).u2(hardBin)
+               .u2(static_cast<uint16_t>(x)).u2(static_cast<uint16_t>(y)).u4(100)
+               .cn("PART").cn("").u2(0).record(5, 20);
+    }
+
+    const std::vector<uint8_t>& bytes() const { return bytes_; }
+
+    std::string write(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(bytes_.data()), bytes_.size());
+        return path;
+    }
+
+    // Write all but the last dropBytes bytes, like a copy cut off mid-record
+    std::string writeTruncated(const std::string& path, size_t dropBytes) const {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(bytes_.data()), bytes_.size() - dropBytes);
+        return path;
+    }
+
+private:
+    StdfBytes& put(uint32_t v, int width) {
+        for (int i = 0; i < width; ++i) {
+            int shift = bigEndian_ ? (width - 1 - i) * 8 : i * 8;
+            body_.push_back(static_cast<uint8_t>(v >> shift));
+        }
+        return *this;
+    }
+
+    bool bigEndian_;
+    std::vector<uint8_t> body_;
+    std::vector<uint8_t> bytes_;
+};
+
 // === STDFRecord Type Tests ===
 TEST(STDFRecordTest, FARRecordToStringAndSize) {
     FARRecord rec;
@@ -278,7 +362,373 @@ TEST(DatabaseTest, GetTestStatistics) {
     std::filesystem::remove(dbPath);
 }
 
+TEST(DatabaseTest, LoadProfilesAndInMemoryStaging) {
+    LoadProfile profile;
+    ASSERT_TRUE(loadProfileFromName("bulk", profile));
+    EXPECT_EQ(profile, LoadProfile::BulkLoad);
+    EXPECT_FALSE(loadProfileFromName("fast", profile));
+
+    std::string dbPath = temp_db_path();
+    {
+        Database db(dbPath, LoadProfile::Production);
+        ASSERT_TRUE(db.open());
+        EXPECT_EQ(db.queryPragma("journal_mode"), "wal");
+        EXPECT_EQ(db.queryPragma("synchronous"), "1");
+        ASSERT_TRUE(db.createTables());
+        PRRRecord prr{};
+        ASSERT_TRUE(db.insertPRR(prr));
+        db.close();
+    }
+    {
+        // Staged loads start from the existing rows and reach disk on flush
+        Database db(dbPath, LoadProfile::BulkLoad);
+        db.setInMemoryStaging(true);
+        ASSERT_TRUE(db.open());
+        EXPECT_EQ(db.queryPragma("synchronous"), "0");
+        ASSERT_TRUE(db.createTables());
+        EXPECT_EQ(db.getRecordCount("prr_records"), 1);
+        PRRRecord prr{};
+        ASSERT_TRUE(db.beginTransaction());
+        for (int i = 0; i < 10; ++i) {
+            ASSERT_TRUE(db.insertPRR(prr));
+        }
+        ASSERT_TRUE(db.commitTransaction());
+        ASSERT_TRUE(db.flush());
+        ASSERT_TRUE(db.insertPRR(prr)); // Written by close()
+    }
+    Database reopened(dbPath);
+    ASSERT_TRUE(reopened.open());
+    EXPECT_EQ(reopened.getRecordCount("prr_records"), 12);
+    reopened.close();
+    std::filesystem::remove(dbPath);
+    std::filesystem::remove(dbPath + "-wal");
+    std::filesystem::remove(dbPath + "-shm");
+}
+
+TEST(DatabaseTest, NormalizedSchemaStoresTestDefsOnce) {
+    std::string dbPath = temp_db_path();
+    {
+        Database db(dbPath);
+        db.setSchemaMode(SchemaMode::Normalized);
+        ASSERT_TRUE(db.open());
+        ASSERT_TRUE(db.createTables());
+
+        for (const char* file : {"lot1.stdf", "lot2.stdf"}) {
+            ASSERT_TRUE(db.beginTransaction());
+            ASSERT_GT(db.beginFile(file), 0);
+            std::vector<PTRRecord> ptrs;
+            for (int part = 0; part < 3; ++part) {
+                for (U4 test = 1; test <= 4; ++test) {
+                    PTRRecord ptr{};
+                    ptr.TEST_NUM = test;
+                    ptr.RESULT = static_cast<R4>(part);
+                    // Only the first execution carries the text and limits
+                    if (part == 0) {
+                        ptr.TEST_TXT = "Test " + std::to_string(test);
+                        ptr.UNITS = "V";
+                        ptr.HI_LIMIT = 1.5f;
+                    }
+                    ptrs.push_back(ptr);
+                }
+            }
+            ASSERT_TRUE(db.insertPTR(ptrs[0]));
+            std::vector<const STDFRecord*> rest;
+            for (size_t i = 1; i < ptrs.size(); ++i) {
+                rest.push_back(&ptrs[i]);
+            }
+            ASSERT_TRUE(db.insertBatch(rest));
+            ASSERT_TRUE(db.commitTransaction());
+        }
+
+        // A rolled-back file must not leave its tests marked as defined
+        ASSERT_TRUE(db.beginTransaction());
+        long long rolledBack = db.beginFile("bad.stdf");
+        PTRRecord ptr{};
+        ptr.TEST_NUM = 9;
+        ptr.TEST_TXT = "Test 9";
+        ASSERT_TRUE(db.insertPTR(ptr));
+        ASSERT_TRUE(db.rollbackTransaction());
+        ASSERT_TRUE(db.beginTransaction());
+        ASSERT_EQ(db.beginFile("retry.stdf"), rolledBack);
+        ASSERT_TRUE(db.insertPTR(ptr));
+        ASSERT_TRUE(db.commitTransaction());
+        db.close();
+    }
+
+    // Reopening picks up the normalized layout without being told
+    Database db(dbPath);
+    ASSERT_TRUE(db.open());
+    EXPECT_EQ(db.getSchemaMode(), SchemaMode::Normalized);
+    EXPECT_EQ(db.getRecordCount("files"), 3);
+    EXPECT_EQ(db.getRecordCount("test_defs"), 9);
+    EXPECT_EQ(db.getRecordCount("ptr_records"), 25);
+    db.close();
+
+    sqlite3* raw = nullptr;
+    ASSERT_EQ(sqlite3_open(dbPath.c_str(), &raw), SQLITE_OK);
+    sqlite3_stmt* stmt = nullptr;
+    ASSERT_EQ(sqlite3_prepare_v2(raw, "SELECT COUNT(*) FROM ptr_full WHERE test_txt = 'Test ' || test_num "
+                                      "AND units = 'V' AND hi_limit = 1.5;", -1, &stmt, nullptr), SQLITE_OK);
+    ASSERT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    EXPECT_EQ(sqlite3_column_int(stmt, 0), 24);
+    sqlite3_finalize(stmt);
+    sqlite3_close(raw);
+    std::filesystem::remove(dbPath);
+}
+
+TEST(DatabaseTest, DeferredIndexesAreBuiltOnRequest) {
+    std::string dbPath = temp_db_path();
+    {
+        Database db(dbPath);
+        ASSERT_TRUE(db.open());
+        ASSERT_TRUE(db.createTables());
+        EXPECT_TRUE(db.getMissingIndexes().empty());
+    }
+
+    // A bulk load drops the existing indexes and builds them at the end
+    Database db(dbPath, LoadProfile::BulkLoad);
+    EXPECT_TRUE(db.isDeferringIndexes());
+    ASSERT_TRUE(db.open());
+    ASSERT_TRUE(db.createTables());
+    size_t managed = db.getMissingIndexes().size();
+    EXPECT_GT(managed, 0u);
+
+    ASSERT_TRUE(db.beginTransaction());
+    PRRRecord prr{};
+    for (int i = 0; i < 100; ++i) {
+        prr.HARD_BIN = static_cast<U2>(i % 4);
+        ASSERT_TRUE(db.insertPRR(prr));
+    }
+    ASSERT_TRUE(db.commitTransaction());
+    ASSERT_TRUE(db.createIndexes());
+    EXPECT_TRUE(db.getMissingIndexes().empty());
+
+    db.close(); // Releases the bulk profile's exclusive lock
+
+    std::string plan;
+    sqlite3* raw = nullptr;
+    ASSERT_EQ(sqlite3_open(dbPath.c_str(), &raw), SQLITE_OK);
+    sqlite3_stmt* stmt = nullptr;
+    ASSERT_EQ(sqlite3_prepare_v2(raw, "EXPLAIN QUERY PLAN SELECT COUNT(*) FROM prr_records WHERE hard_bin = 1;",
+                                 -1, &stmt, nullptr), SQLITE_OK);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        plan += reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(raw);
+    EXPECT_NE(plan.find("idx_prr_hard_bin"), std::string::npos) << plan;
+    std::filesystem::remove(dbPath);
+}
+
+TEST(DatabaseTest, SummaryCountsTrackInsertsAndRollbacks) {
+    std::string dbPath = temp_db_path();
+    {
+        Database db(dbPath);
+        ASSERT_TRUE(db.open());
+        ASSERT_TRUE(db.createTables());
+        PRRRecord prr{};
+        for (U2 bin : {1, 1, 2, 3, 5}) {
+            prr.HARD_BIN = bin;
+            ASSERT_TRUE(db.insertPRR(prr));
+        }
+        PTRRecord ptr{};
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_TRUE(db.insertPTR(ptr));
+        }
+        db.close();
+    }
+
+    // Look like a database from before db_summary existed
+    sqlite3* raw = nullptr;
+    ASSERT_EQ(sqlite3_open(dbPath.c_str(), &raw), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(raw, "DROP TABLE db_summary;", nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close(raw);
+
+    Database db(dbPath);
+    ASSERT_TRUE(db.open());
+    auto stats = db.getTestStatistics(); // Aggregate fallback
+    EXPECT_EQ(stats.totalParts, 5);
+    EXPECT_EQ(stats.passedParts, 2);
+    EXPECT_EQ(stats.totalTests, 3);
+
+    ASSERT_TRUE(db.createTables()); // Seeds the summary from the existing rows
+    EXPECT_EQ(db.getRecordCount("prr_records"), 5);
+
+    PRRRecord prr{};
+    prr.HARD_BIN = 1;
+    std::vector<const STDFRecord*> batch(4, &prr);
+    ASSERT_TRUE(db.beginTransaction());
+    ASSERT_TRUE(db.insertBatch(batch));
+    EXPECT_EQ(db.getRecordCount("prr_records"), 9); // Uncommitted rows count on this connection
+    ASSERT_TRUE(db.rollbackTransaction());
+    EXPECT_EQ(db.getRecordCount("prr_records"), 5);
+
+    ASSERT_TRUE(db.beginTransaction());
+    ASSERT_TRUE(db.insertBatch(batch));
+    ASSERT_TRUE(db.insertPRR(prr));
+    ASSERT_TRUE(db.commitTransaction());
+    stats = db.getTestStatistics();
+    EXPECT_EQ(stats.totalParts, 10);
+    EXPECT_EQ(stats.passedParts, 7);
+    EXPECT_EQ(stats.totalTests, 3);
+    db.close();
+
+    // The stored counts agree with the tables
+    ASSERT_EQ(sqlite3_open(dbPath.c_str(), &raw), SQLITE_OK);
+    sqlite3_stmt* stmt = nullptr;
+    ASSERT_EQ(sqlite3_prepare_v2(raw, "SELECT (SELECT value FROM db_summary WHERE key = 'prr_records') = "
+                                      "(SELECT COUNT(*) FROM prr_records) AND "
+                                      "(SELECT value FROM db_summary WHERE key = 'passed_parts') = "
+                                      "(SELECT COUNT(*) FROM prr_records WHERE hard_bin = 1);",
+                                 -1, &stmt, nullptr), SQLITE_OK);
+    ASSERT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    EXPECT_EQ(sqlite3_column_int(stmt, 0), 1);
+    sqlite3_finalize(stmt);
+    sqlite3_close(raw);
+    std::filesystem::remove(dbPath);
+}
+
+TEST(DatabaseTest, FailedAutocommitInsertsLeaveNoRowsOrCounts) {
+    std::string dbPath = temp_db_path();
+    {
+        Database db(dbPath);
+        ASSERT_TRUE(db.open());
+        ASSERT_TRUE(db.createTables());
+        db.close();
+    }
+
+    // Reject one bin so a write fails after earlier rows went in
+    sqlite3* raw = nullptr;
+    ASSERT_EQ(sqlite3_open(dbPath.c_str(), &raw), SQLITE_OK);
+    ASSERT_EQ(sqlite3_exec(raw, "CREATE TRIGGER reject_bin BEFORE INSERT ON prr_records "
+                                "WHEN NEW.hard_bin = 99 BEGIN SELECT RAISE(ABORT, 'bin 99'); END;",
+                           nullptr, nullptr, nullptr), SQLITE_OK);
+    sqlite3_close(raw);
+
+    Database db(dbPath);
+    ASSERT_TRUE(db.open());
+    PRRRecord pass{};
+    pass.HARD_BIN = 1;
+    PRRRecord reject{};
+    reject.HARD_BIN = 99;
+    ASSERT_TRUE(db.insertPRR(pass));
+    EXPECT_FALSE(db.insertPRR(reject));
+    EXPECT_NE(db.getLastError().find("bin 99"), std::string::npos) << db.getLastError();
+
+    // The failing row sits in a later chunk than the first rows
+    std::vector<const STDFRecord*> batch(1000, &pass);
+    batch.push_back(&reject);
+    EXPECT_FALSE(db.insertBatch(batch));
+    EXPECT_EQ(db.getRecordCount("prr_records"), 1);
+    EXPECT_EQ(db.getTestStatistics().passedParts, 1);
+
+    batch.pop_back();
+    ASSERT_TRUE(db.insertBatch(batch));
+    EXPECT_EQ(db.getRecordCount("prr_records"), 1001);
+    db.close();
+
+    ASSERT_EQ(sqlite3_open(dbPath.c_str(), &raw), SQLITE_OK);
+    sqlite3_stmt* stmt = nullptr;
+    ASSERT_EQ(sqlite3_prepare_v2(raw, "SELECT (SELECT value FROM db_summary WHERE key = 'prr_records'), "
+                                      "(SELECT COUNT(*) FROM prr_records), "
+                                      "(SELECT value FROM db_summary WHERE key = 'passed_parts');",
+                                 -1, &stmt, nullptr), SQLITE_OK);
+    ASSERT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    EXPECT_EQ(sqlite3_column_int(stmt, 0), 1001);
+    EXPECT_EQ(sqlite3_column_int(stmt, 1), 1001);
+    EXPECT_EQ(sqlite3_column_int(stmt, 2), 1001);
+    sqlite3_finalize(stmt);
+    sqlite3_close(raw);
+    std::filesystem::remove(dbPath);
+}
+
+TEST(DatabaseTest, InsertStatementsAreReused) {
+    std::string dbPath = temp_db_path();
+    {
+        Database db(dbPath);
+        ASSERT_TRUE(db.open());
+        ASSERT_TRUE(db.createTables());
+        ASSERT_TRUE(db.beginTransaction());
+        PTRRecord ptr{};
+        for (int i = 0; i < 100; ++i) {
+            ptr.TEST_NUM = i;
+            ptr.TEST_TXT = "T" + std::to_string(i);
+            ASSERT_TRUE(db.insertPTR(ptr));
+        }
+        ASSERT_TRUE(db.commitTransaction());
+
+        auto stats = db.getStatementStats(RecordType::PTR);
+        EXPECT_EQ(stats.prepares, 1u);
+        EXPECT_EQ(stats.executions, 100u);
+        EXPECT_EQ(stats.reuses(), 99u);
+        EXPECT_EQ(db.getStatementStats(RecordType::PRR).executions, 0u);
+
+        // A failed step leaves the cached statement usable
+        sqlite3* raw = nullptr;
+        ASSERT_EQ(sqlite3_open(dbPath.c_str(), &raw), SQLITE_OK);
+        ASSERT_EQ(sqlite3_exec(raw, "CREATE TRIGGER no_neg BEFORE INSERT ON ptr_records "
+                                    "WHEN NEW.test_num < 0 BEGIN SELECT RAISE(ABORT, 'neg'); END;",
+                               nullptr, nullptr, nullptr), SQLITE_OK);
+        sqlite3_close(raw);
+        ptr.TEST_NUM = static_cast<U4>(-1);
+        EXPECT_FALSE(db.insertPTR(ptr));
+        ptr.TEST_NUM = 500;
+        EXPECT_TRUE(db.insertPTR(ptr));
+        db.close();
+    }
+    Database reopened(dbPath);
+    ASSERT_TRUE(reopened.open());
+    EXPECT_EQ(reopened.getRecordCount("ptr_records"), 101);
+    reopened.close();
+    std::filesystem::remove(dbPath);
+}
+
+TEST(DatabaseTest, InsertBatchWritesAllRows) {
+    std::string dbPath = temp_db_path();
+    Database db(dbPath);
+    ASSERT_TRUE(db.open());
+    ASSERT_TRUE(db.createTables());
+
+    // Enough rows for several full statements plus a remainder
+    std::vector<PTRRecord> ptrs(5000);
+    std::vector<const STDFRecord*> batch;
+    for (size_t i = 0; i < ptrs.size(); ++i) {
+        ptrs[i].TEST_NUM = static_cast<U4>(i);
+        ptrs[i].TEST_TXT = "T" + std::to_string(i);
+        batch.push_back(&ptrs[i]);
+    }
+    ASSERT_TRUE(db.beginTransaction());
+    ASSERT_TRUE(db.insertBatch(batch));
+    ASSERT_TRUE(db.commitTransaction());
+    EXPECT_EQ(db.getRecordCount("ptr_records"), 5000);
+    EXPECT_EQ(db.getLastBatchTiming().rows, 5000u);
+    EXPECT_GE(db.getLastBatchTiming().statements, 2u);
+    EXPECT_EQ(db.getTotalBatchTiming().rows, 5000u);
+
+    // Mixed record types are rejected without inserting anything
+    PRRRecord prr{};
+    batch.push_back(&prr);
+    EXPECT_FALSE(db.insertBatch(batch));
+    EXPECT_FALSE(db.getLastError().empty());
+    db.close();
+
+    // Every row landed with its own values, in order
+    sqlite3* raw = nullptr;
+    ASSERT_EQ(sqlite3_open(dbPath.c_str(), &raw), SQLITE_OK);
+    sqlite3_stmt* stmt = nullptr;
+    ASSERT_EQ(sqlite3_prepare_v2(raw, "SELECT COUNT(*), SUM(test_num), MIN(test_txt = 'T' || test_num) "
+                                      "FROM ptr_records;", -1, &stmt, nullptr), SQLITE_OK);
+    ASSERT_EQ(sqlite3_step(stmt), SQLITE_ROW);
+    EXPECT_EQ(sqlite3_column_int64(stmt, 0), 5000);
+    EXPECT_EQ(sqlite3_column_int64(stmt, 1), 4999LL * 5000 / 2);
+    EXPECT_EQ(sqlite3_column_int64(stmt, 2), 1);
+    sqlite3_finalize(stmt);
+    sqlite3_close(raw);
+    std::filesystem::remove(dbPath);
+}
+
 // === STDFParser Tests ===
+
 TEST(STDFParserTest, ParseSampleFile) {
     // Use a real sample file from data/
     std::string sample = "../data/benchmark.stdf";
@@ -330,6 +780,556 @@ TEST(STDFParserTest, StreamingParse) {
     EXPECT_GT(recordCount, 0);
 }
 
+TEST(STDFParserTest, MemoryMappedMatchesStream) {
+    std::string dataDir = "../data";
+    if (!std::filesystem::exists(dataDir)) GTEST_SKIP();
+    int filesCompared = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(dataDir)) {
+        if (entry.path().extension() != ".stdf") continue;
+        STDFParser streamParser(entry.path().string());
+        STDFParser mappedParser(entry.path().string(), InputMode::MemoryMapped);
+        EXPECT_EQ(mappedParser.getInputMode(), InputMode::MemoryMapped);
+        EXPECT_EQ(mappedParser.getFileSize(), streamParser.getFileSize());
+        auto streamRecords = streamParser.parseFile();
+        auto mappedRecords = mappedParser.parseFile();
+        ASSERT_EQ(mappedRecords.size(), streamRecords.size()) << entry.path();
+        for (size_t i = 0; i < streamRecords.size(); ++i) {
+            EXPECT_EQ(mappedRecords[i]->getRecordType(), streamRecords[i]->getRecordType());
+            EXPECT_EQ(mappedRecords[i]->toString(), streamRecords[i]->toString());
+        }
+        EXPECT_TRUE(mappedParser.isEndOfFile());
+        EXPECT_EQ(mappedParser.getCurrentPosition(), mappedParser.getFileSize());
+        ++filesCompared;
+    }
+    EXPECT_GT(filesCompared, 0);
+}
+
+TEST(STDFParserTest, MemoryMappedFileNotFound) {
+    EXPECT_THROW(STDFParser parser("nonexistent_file.stdf", InputMode::MemoryMapped), std::runtime_error);
+}
+
+TEST(STDFParserTest, OmittedTrailingFieldsStayWithinRecord) {
+    // PRR cut short after HARD_BIN, followed by a complete PIR
+    StdfBytes b;
+    b.far();
+    b.u1(1).u1(3).u1(0).u2(7).u2(5).record(5, 20);
+    b.pir(1, 4);
+    std::string path = b.write("test_truncated_" + std::to_string(rand()) + ".stdf");
+
+    for (auto mode : {InputMode::Stream, InputMode::MemoryMapped}) {
+        STDFParser parser(path, mode);
+        auto records = parser.parseFile();
+        ASSERT_EQ(records.size(), 3u);
+        auto& prr = static_cast<const PRRRecord&>(*records[1]);
+        EXPECT_EQ(prr.SITE_NUM, 3);
+        EXPECT_EQ(prr.HARD_BIN, 5);
+        EXPECT_EQ(prr.SOFT_BIN, 0);
+        EXPECT_TRUE(prr.PART_ID.empty());
+        auto& pir = static_cast<const PIRRecord&>(*records[2]);
+        EXPECT_EQ(pir.SITE_NUM, 4);
+        EXPECT_EQ(parser.getCurrentPosition(), b.bytes().size());
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(STDFParserTest, BigEndianFile) {
+    StdfBytes b(true);
+    b.far().pir(1, 2).ptr(1234, 2, 2.5f).prr(2, 1, -3, 7);
+    std::string path = b.write("test_big_endian_" + std::to_string(rand()) + ".stdf");
+
+    for (auto mode : {InputMode::Stream, InputMode::MemoryMapped}) {
+        STDFParser parser(path, mode);
+        auto records = parser.parseFile();
+        ASSERT_EQ(records.size(), 4u);
+        auto& ptr = static_cast<const PTRRecord&>(*records[2]);
+        EXPECT_EQ(ptr.TEST_NUM, 1234u);
+        EXPECT_FLOAT_EQ(ptr.RESULT, 2.5f);
+        EXPECT_EQ(ptr.TEST_TXT, "TEST_1234");
+        auto& prr = static_cast<const PRRRecord&>(*records[3]);
+        EXPECT_EQ(prr.X_COORD, -3);
+        EXPECT_EQ(prr.Y_COORD, 7);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(STDFParserTest, TruncatedFileStopsParsing) {
+    StdfBytes b;
+    b.far().pir(1, 1).ptr(1, 1, 1.0f);
+    std::string path = b.writeTruncated("test_cut_" + std::to_string(rand()) + ".stdf", 3);
+
+    for (auto mode : {InputMode::Stream, InputMode::MemoryMapped}) {
+        STDFParser parser(path, mode);
+        auto records = parser.parseFile();
+        EXPECT_EQ(records.size(), 2u);
+        EXPECT_TRUE(parser.isEndOfFile());
+        EXPECT_FALSE(parser.getLastError().empty());
+
+        // A cut inside a skipped body is reported too
+        STDFParser filtered(path, mode);
+        filtered.setRecordFilter({RecordType::PIR});
+        EXPECT_EQ(filtered.parseFile().size(), 1u);
+        EXPECT_TRUE(filtered.isEndOfFile());
+        EXPECT_NE(filtered.getLastError().find("Truncated record"), std::string::npos);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(STDFParserTest, ScanRecordsFindsBoundaries) {
+    StdfBytes b;
+    b.far().pir(1, 1);
+    b.u1(0).record(50, 30); // Unknown record type
+    b.ptr(1, 1, 1.0f);
+    std::string path = b.write("test_scan_" + std::to_string(rand()) + ".stdf");
+
+    STDFParser parser(path);
+    auto locations = parser.scanRecords();
+    ASSERT_EQ(locations.size(), 4u);
+    EXPECT_EQ(locations[0].offset, 0u);
+    EXPECT_EQ(locations[1].offset, 6u);
+    EXPECT_EQ(locations[2].header.recordType, 50);
+    EXPECT_EQ(locations[2].header.recordSub, 30);
+    EXPECT_EQ(locations[2].header.length, 1u);
+    EXPECT_EQ(locations[3].header.recordType, 15);
+    EXPECT_EQ(locations[3].offset + 4 + locations[3].header.length, b.bytes().size());
+    EXPECT_TRUE(parser.getLastError().empty());
+    std::filesystem::remove(path);
+}
+
+TEST(STDFParserTest, ParallelParseMatchesSequential) {
+    std::string dataDir = "../data";
+    if (!std::filesystem::exists(dataDir)) GTEST_SKIP();
+    std::vector<std::string> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(dataDir)) {
+        if (entry.path().extension() == ".stdf") paths.push_back(entry.path().string());
+    }
+    // Unknown records mixed in and a truncated tail
+    StdfBytes b(true);
+    b.far();
+    for (int i = 0; i < 50; ++i) {
+        b.pir(1, i % 4).ptr(i, i % 4, i * 0.5f);
+        b.u1(0).u1(1).record(50, 30);
+        b.prr(i % 4, 1 + i % 3, i, -i);
+    }
+    std::string cutPath = b.writeTruncated("test_parallel_" + std::to_string(rand()) + ".stdf", 2);
+    paths.push_back(cutPath);
+
+    for (const auto& path : paths) {
+        for (auto mode : {InputMode::Stream, InputMode::MemoryMapped}) {
+            auto expected = STDFParser(path, mode).parseFile();
+            for (size_t threads : {1u, 3u, 8u}) {
+                STDFParser parser(path, mode);
+                auto records = parser.parseFileParallel(threads);
+                ASSERT_EQ(records.size(), expected.size()) << path << " threads=" << threads;
+                for (size_t i = 0; i < records.size(); ++i) {
+                    EXPECT_EQ(records[i]->toString(), expected[i]->toString()) << path << " record " << i;
+                }
+                EXPECT_EQ(parser.getLastError().empty(), path != cutPath);
+            }
+        }
+    }
+    std::filesystem::remove(cutPath);
+}
+
+TEST(STDFParserTest, RecordIndexSeeks) {
+    StdfBytes b(true);
+    b.far();
+    b.u1(1).u1(0).u4(100).cn("W01").record(2, 10);
+    b.pir(1, 0).pir(1, 1);
+    b.ptr(10, 0, 1.5f).ptr(10, 1, 2.5f);
+    b.u1(0).record(50, 30); // Unknown record, not indexed
+    b.prr(1, 1, 4, 5).prr(0, 2, 6, 7);
+    b.u1(1).u1(0).u4(200).u4(2).record(2, 20);
+    std::string path = b.write("test_index_" + std::to_string(rand()) + ".stdf");
+    std::string sidecar = RecordIndex::sidecarPath(path);
+
+    auto expected = STDFParser(path).parseFile();
+    {
+        STDFParser parser(path);
+        const RecordIndex& index = parser.getIndex();
+        ASSERT_EQ(index.getRecordCount(), expected.size());
+        EXPECT_TRUE(index.isBigEndian());
+        EXPECT_EQ(index.getRecordsOfType(RecordType::PTR).size(), 2u);
+        ASSERT_EQ(index.getWafers().size(), 1u);
+        EXPECT_EQ(index.getWafers()[0].waferId, "W01");
+        EXPECT_EQ(index.getWafers()[0].firstRecord, 1u);
+        EXPECT_EQ(index.getWafers()[0].lastRecord, 8u);
+        EXPECT_EQ(index.getWafers()[0].endOffset, b.bytes().size());
+        ASSERT_EQ(index.getParts().size(), 2u);
+        EXPECT_EQ(index.getParts()[0].siteNum, 0);
+        EXPECT_EQ(index.getParts()[0].lastRecord, 7u);
+        EXPECT_EQ(index.getParts()[1].lastRecord, 6u);
+        EXPECT_TRUE(std::filesystem::exists(sidecar));
+    }
+
+    // Second open reads the sidecar and never sees the FAR before seeking
+    for (auto mode : {InputMode::Stream, InputMode::MemoryMapped}) {
+        STDFParser parser(path, mode);
+        for (size_t i = expected.size(); i-- > 0;) {
+            ASSERT_TRUE(parser.seekToRecord(i));
+            EXPECT_EQ(parser.parseNextRecord()->toString(), expected[i]->toString());
+        }
+        EXPECT_FALSE(parser.seekToRecord(expected.size()));
+
+        ASSERT_TRUE(parser.seekToPart(1));
+        auto pir = parser.parseNextRecord();
+        EXPECT_EQ(static_cast<const PIRRecord&>(*pir).SITE_NUM, 1);
+        ASSERT_TRUE(parser.seekToWafer("W01"));
+        EXPECT_EQ(parser.parseNextRecord()->getRecordType(), RecordType::WIR);
+        EXPECT_FALSE(parser.seekToWafer("W02"));
+        EXPECT_FALSE(parser.seekToPart(2));
+    }
+
+    // A wafer ID length past any Cn marks the sidecar corrupt; it is rebuilt
+    {
+        size_t idLengthOffset = 8 + 4 + 8 + 8 + 1 + 8 + expected.size() * 9 + 8 + 1;
+        std::fstream sidecarFile(sidecar, std::ios::binary | std::ios::in | std::ios::out);
+        sidecarFile.seekp(static_cast<std::streamoff>(idLengthOffset));
+        uint32_t hugeLength = 0xFFFFFFF0u;
+        sidecarFile.write(reinterpret_cast<const char*>(&hugeLength), sizeof(hugeLength));
+    }
+    RecordIndex corrupt;
+    EXPECT_FALSE(corrupt.load(path));
+    {
+        STDFParser parser(path);
+        EXPECT_EQ(parser.getIndex().getRecordCount(), expected.size());
+        ASSERT_EQ(parser.getIndex().getWafers().size(), 1u);
+        EXPECT_EQ(parser.getIndex().getWafers()[0].waferId, "W01");
+        EXPECT_TRUE(corrupt.load(path));
+    }
+
+    // A changed file invalidates the sidecar
+    RecordIndex stale;
+    EXPECT_TRUE(stale.load(path));
+    std::ofstream(path, std::ios::binary | std::ios::app).put(0);
+    EXPECT_FALSE(stale.load(path));
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(sidecar);
+}
+
+TEST(STDFParserTest, RecordFilterSkipsOtherTypes) {
+    RecordType type;
+    ASSERT_TRUE(recordTypeFromName("prr", type));
+    EXPECT_EQ(type, RecordType::PRR);
+    EXPECT_STREQ(recordTypeName(RecordType::HBR), "HBR");
+    EXPECT_FALSE(recordTypeFromName("XYZ", type));
+
+    // Skipped bodies on both sides of the stream seek threshold
+    StdfBytes b;
+    b.far().pir(1, 0);
+    for (size_t length : {20u, 16383u, 16384u, 65535u}) {
+        for (size_t i = 0; i < length; ++i) b.u1(static_cast<uint8_t>(i));
+        b.record(1, 10); // MIR, filtered out
+        b.ptr(static_cast<uint32_t>(length), 0, 1.0f);
+    }
+    b.prr(0, 1, 2, 3);
+    std::string path = b.write("test_filter_" + std::to_string(rand()) + ".stdf");
+    for (auto mode : {InputMode::Stream, InputMode::MemoryMapped}) {
+        STDFParser parser(path, mode);
+        parser.setRecordFilter({RecordType::PTR, RecordType::PRR});
+        auto records = parser.parseFile();
+        EXPECT_TRUE(parser.getLastError().empty());
+        ASSERT_EQ(records.size(), 5u);
+        EXPECT_EQ(static_cast<const PTRRecord&>(*records[3]).TEST_NUM, 65535u);
+        EXPECT_EQ(records[4]->getRecordType(), RecordType::PRR);
+        EXPECT_EQ(parser.getCurrentPosition(), parser.getFileSize());
+    }
+    std::filesystem::remove(path);
+
+    std::string sample = "../data/benchmark.stdf";
+    if (!std::filesystem::exists(sample)) GTEST_SKIP();
+    auto all = STDFParser(sample).parseFile();
+    std::vector<const STDFRecord*> expected;
+    for (const auto& record : all) {
+        if (record->getRecordType() == RecordType::PRR || record->getRecordType() == RecordType::HBR) {
+            expected.push_back(record.get());
+        }
+    }
+    ASSERT_FALSE(expected.empty());
+
+    for (auto mode : {InputMode::Stream, InputMode::MemoryMapped}) {
+        STDFParser parser(sample, mode);
+        parser.setRecordFilter({RecordType::PRR, RecordType::HBR});
+        EXPECT_FALSE(parser.isRecordTypeEnabled(RecordType::PTR));
+        auto records = parser.parseFile();
+        ASSERT_EQ(records.size(), expected.size());
+        for (size_t i = 0; i < records.size(); ++i) {
+            EXPECT_EQ(records[i]->toString(), expected[i]->toString());
+        }
+        EXPECT_EQ(parser.getCurrentPosition(), parser.getFileSize());
+
+        STDFParser viewParser(sample, mode);
+        viewParser.setRecordFilter({RecordType::PRR});
+        size_t views = 0;
+        while (!viewParser.isEndOfFile()) {
+            if (const RecordView* view = viewParser.parseNextView()) {
+                EXPECT_EQ(view->type, RecordType::PRR);
+                ++views;
+            }
+        }
+        EXPECT_GT(views, 0u);
+        viewParser.clearRecordFilter();
+        EXPECT_EQ(viewParser.parseFile().size(), all.size());
+    }
+}
+
+TEST(STDFParserTest, HandlerParseMatchesParseFile) {
+    struct Collector : RecordHandler {
+        std::vector<std::string> dumps;
+        std::set<const void*> ptrObjects;
+        size_t prrCount = 0;
+        void onRecord(const STDFRecord& record) override { dumps.push_back(record.toString()); }
+        void onPTR(const PTRRecord& record) override {
+            ptrObjects.insert(&record);
+            onRecord(record);
+        }
+        void onPRR(const PRRRecord& record) override {
+            ++prrCount;
+            onRecord(record);
+        }
+    };
+
+    std::string sample = "../data/benchmark.stdf";
+    if (!std::filesystem::exists(sample)) GTEST_SKIP();
+    auto records = STDFParser(sample).parseFile();
+
+    for (auto mode : {InputMode::Stream, InputMode::MemoryMapped}) {
+        STDFParser parser(sample, mode);
+        Collector collector;
+        EXPECT_EQ(parser.parse(collector), records.size());
+        ASSERT_EQ(collector.dumps.size(), records.size());
+        for (size_t i = 0; i < records.size(); ++i) {
+            EXPECT_EQ(collector.dumps[i], records[i]->toString());
+        }
+        EXPECT_GT(collector.prrCount, 0u);
+        EXPECT_EQ(collector.ptrObjects.size(), 1u); // One reused PTRRecord
+        EXPECT_TRUE(parser.getLastError().empty());
+    }
+
+    struct Thrower : RecordHandler {
+        void onPIR(const PIRRecord&) override { throw std::runtime_error("stop"); }
+    } thrower;
+    STDFParser parser(sample);
+    EXPECT_THROW(parser.parse(thrower), std::runtime_error);
+}
+
+// === Record View Tests ===
+TEST(RecordViewTest, ViewsMatchOwningRecords) {
+    std::string sample = "../data/benchmark.stdf";
+    if (!std::filesystem::exists(sample)) GTEST_SKIP();
+    auto records = STDFParser(sample).parseFile();
+
+    for (auto mode : {InputMode::Stream, InputMode::MemoryMapped}) {
+        STDFParser parser(sample, mode);
+        size_t index = 0;
+        while (!parser.isEndOfFile()) {
+            const RecordView* view = parser.parseNextView();
+            if (!view) continue;
+            ASSERT_LT(index, records.size());
+            const STDFRecord& rec = *records[index++];
+            ASSERT_EQ(view->type, rec.getRecordType());
+            if (view->type == RecordType::PTR) {
+                auto& v = static_cast<const PTRView&>(*view);
+                auto& r = static_cast<const PTRRecord&>(rec);
+                EXPECT_EQ(v.TEST_NUM, r.TEST_NUM);
+                EXPECT_EQ(v.RESULT, r.RESULT);
+                EXPECT_EQ(v.TEST_TXT, r.TEST_TXT);
+                EXPECT_EQ(v.ALARM_ID, r.ALARM_ID);
+                EXPECT_EQ(v.OPT_FLAG, r.OPT_FLAG);
+                PTRLimits limits = v.limits();
+                EXPECT_EQ(limits.hasLow, (r.OPT_FLAG & PTR_OPT_LO_LIMIT) != 0);
+                if (limits.hasLow) {
+                    EXPECT_EQ(limits.LO_LIMIT, r.LO_LIMIT);
+                }
+                if (limits.hasHigh) {
+                    EXPECT_EQ(limits.HI_LIMIT, r.HI_LIMIT);
+                }
+                if (r.OPT_FLAG & PTR_OPT_UNITS) {
+                    EXPECT_EQ(v.units(), r.UNITS);
+                }
+            } else if (view->type == RecordType::PRR) {
+                auto& v = static_cast<const PRRView&>(*view);
+                auto& r = static_cast<const PRRRecord&>(rec);
+                EXPECT_EQ(v.HARD_BIN, r.HARD_BIN);
+                EXPECT_EQ(v.X_COORD, r.X_COORD);
+                EXPECT_EQ(v.PART_ID, r.PART_ID);
+                EXPECT_EQ(v.PART_FIX.toBn(), r.PART_FIX);
+            } else if (view->type == RecordType::MIR) {
+                auto& v = static_cast<const MIRView&>(*view);
+                auto& r = static_cast<const MIRRecord&>(rec);
+                EXPECT_EQ(v.LOT_ID, r.LOT_ID);
+                EXPECT_EQ(v.PART_TYP, r.PART_TYP);
+                EXPECT_EQ(v.SUPR_NAM, r.SUPR_NAM);
+            } else if (view->type == RecordType::WRR) {
+                auto& v = static_cast<const WRRView&>(*view);
+                auto& r = static_cast<const WRRRecord&>(rec);
+                EXPECT_EQ(v.WAFER_ID, r.WAFER_ID);
+                EXPECT_EQ(v.GOOD_CNT, r.GOOD_CNT);
+            }
+        }
+        EXPECT_EQ(index, records.size());
+    }
+}
+
+TEST(RecordViewTest, FTRArraysDecodeOnAccess) {
+    for (bool bigEndian : {false, true}) {
+        StdfBytes b(bigEndian);
+        b.far();
+        b.u4(77).u1(1).u1(2).u1(0x80).u1(0).u4(10).u4(20).u4(30).u4(1).u4(0).u4(0).u2(0)
+         .u2(2).u2(1)                // RTN_ICNT, PGM_ICNT
+         .u2(5).u2(6).u2(0x0102).u2(0x0304)  // RTN_INDX, RTN_STAT
+         .u2(9).u2(0xBEEF)           // PGM_INDX, PGM_STAT
+         .u2(1).u1(0xAA)             // FAIL_PIN
+         .cn("VEC").cn("TS").cn("OP").cn("FUNC_77").cn("").cn("").cn("").u1(3).u2(0)
+         .record(15, 20);
+        std::string path = b.write("test_ftr_view_" + std::to_string(rand()) + ".stdf");
+
+        STDFParser parser(path);
+        parser.parseNextView(); // FAR
+        const RecordView* view = parser.parseNextView();
+        ASSERT_NE(view, nullptr);
+        ASSERT_EQ(view->type, RecordType::FTR);
+        auto& ftr = static_cast<const FTRView&>(*view);
+        EXPECT_EQ(ftr.TEST_NUM, 77u);
+        EXPECT_EQ(ftr.variableData.size, 39u);
+        ASSERT_EQ(ftr.rtnIndex().size(), 2u);
+        EXPECT_EQ(ftr.rtnIndex()[1], 6);
+        EXPECT_EQ(ftr.rtnStat()[0], 0x0102);
+        EXPECT_EQ(ftr.pgmIndex().toVector(), std::vector<U2>{9});
+        EXPECT_EQ(ftr.pgmStat().toVector(), std::vector<U2>{0xBEEF});
+        ASSERT_EQ(ftr.failPin().size, 1u);
+        EXPECT_EQ(ftr.failPin().data[0], 0xAA);
+        EXPECT_EQ(ftr.vectName(), "VEC");
+        EXPECT_EQ(ftr.opCode(), "OP");
+        EXPECT_EQ(ftr.testText(), "FUNC_77");
+        EXPECT_EQ(ftr.resultText(), "");
+        EXPECT_EQ(ftr.patternNumber(), 3);
+        EXPECT_TRUE(ftr.spinMap().empty());
+        std::filesystem::remove(path);
+    }
+}
+
+TEST(RecordViewTest, PTROptionalFieldsDecodeOnAccess) {
+    for (bool bigEndian : {false, true}) {
+        StdfBytes b(bigEndian);
+        b.far();
+        b.u4(5).u1(1).u1(0).u1(0).u1(0).r4(1.25f).cn("VDD").cn("")
+         .u1(PTR_OPT_LO_LIMIT | PTR_OPT_HI_LIMIT | PTR_OPT_UNITS | PTR_OPT_LIM_FMT)
+         .u1(0xFD).r4(-0.5f).u1(0xFE).r4(3.5f).cn("V").cn("%.2f").cn("%.3f")
+         .record(15, 10);
+        b.u4(6).u1(1).u1(0).u1(0).u1(0).r4(2.0f).cn("IDD").cn("").u1(PTR_OPT_RES_SCAL).u1(3)
+         .record(15, 10);
+        std::string path = b.write("test_ptr_view_" + std::to_string(rand()) + ".stdf");
+
+        STDFParser parser(path);
+        parser.parseNextView(); // FAR
+        auto& ptr = static_cast<const PTRView&>(*parser.parseNextView());
+        EXPECT_EQ(ptr.RESULT, 1.25f);
+        EXPECT_EQ(ptr.resScale(), 0);
+        PTRLimits limits = ptr.limits();
+        EXPECT_TRUE(limits.hasLow);
+        EXPECT_EQ(limits.LLM_SCAL, -3);
+        EXPECT_EQ(limits.LO_LIMIT, -0.5f);
+        EXPECT_EQ(limits.HLM_SCAL, -2);
+        EXPECT_EQ(limits.HI_LIMIT, 3.5f);
+        EXPECT_EQ(ptr.units(), "V");
+        EXPECT_EQ(ptr.resultFormat(), "");
+        EXPECT_EQ(ptr.lowLimitFormat(), "%.2f");
+        EXPECT_EQ(ptr.highLimitFormat(), "%.3f");
+
+        auto& next = static_cast<const PTRView&>(*parser.parseNextView());
+        EXPECT_EQ(next.resScale(), 3);
+        EXPECT_FALSE(next.limits().hasLow);
+        EXPECT_FALSE(next.limits().hasHigh);
+        EXPECT_EQ(next.units(), "");
+        std::filesystem::remove(path);
+    }
+}
+
+TEST(RecordViewTest, ArenaLoadMatchesOwningRecords) {
+    std::string dataDir = "../data";
+    if (!std::filesystem::exists(dataDir)) GTEST_SKIP();
+    std::vector<std::string> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(dataDir)) {
+        if (entry.path().extension() == ".stdf") paths.push_back(entry.path().string());
+    }
+    ASSERT_FALSE(paths.empty());
+
+    RecordArena arena(4096);
+    for (const auto& path : paths) {
+        auto records = STDFParser(path).parseFile();
+        for (auto mode : {InputMode::Stream, InputMode::MemoryMapped}) {
+            std::vector<const RecordView*> views;
+            {
+                STDFParser parser(path, mode);
+                views = parser.parseFile(arena);
+                EXPECT_TRUE(parser.getLastError().empty());
+            }
+            // Parser is gone; the views live on in the arena
+            ASSERT_EQ(views.size(), records.size()) << path;
+            for (size_t i = 0; i < views.size(); ++i) {
+                ASSERT_EQ(views[i]->type, records[i]->getRecordType());
+                if (views[i]->type == RecordType::PTR) {
+                    auto& v = static_cast<const PTRView&>(*views[i]);
+                    auto& r = static_cast<const PTRRecord&>(*records[i]);
+                    EXPECT_EQ(v.TEST_NUM, r.TEST_NUM);
+                    EXPECT_EQ(v.RESULT, r.RESULT);
+                    EXPECT_EQ(v.TEST_TXT, r.TEST_TXT);
+                    if (r.OPT_FLAG & PTR_OPT_UNITS) {
+                        EXPECT_EQ(v.units(), r.UNITS);
+                    }
+                } else if (views[i]->type == RecordType::PRR) {
+                    auto& v = static_cast<const PRRView&>(*views[i]);
+                    auto& r = static_cast<const PRRRecord&>(*records[i]);
+                    EXPECT_EQ(v.HARD_BIN, r.HARD_BIN);
+                    EXPECT_EQ(v.PART_ID, r.PART_ID);
+                } else if (views[i]->type == RecordType::MIR) {
+                    EXPECT_EQ(static_cast<const MIRView&>(*views[i]).LOT_ID,
+                              static_cast<const MIRRecord&>(*records[i]).LOT_ID);
+                }
+            }
+        }
+    }
+    EXPECT_GT(arena.getBlockCount(), 1u);
+    EXPECT_LE(arena.getBytesUsed(), arena.getBytesReserved());
+
+    arena.reset();
+    EXPECT_EQ(arena.getBytesUsed(), 0u);
+    EXPECT_EQ(arena.getBlockCount(), 1u);
+    void* big = arena.allocate(10000, 1);
+    EXPECT_NE(big, nullptr);
+    auto* aligned = arena.allocate(8, 8);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 8, 0u);
+}
+
+TEST(RecordViewTest, ArenaMoveLeavesSourceEmpty) {
+    RecordArena source(64);
+    auto* first = static_cast<U1*>(source.allocate(16, 1));
+    std::fill(first, first + 16, U1{0xAB});
+
+    RecordArena moved(std::move(source));
+    EXPECT_EQ(moved.getBytesUsed(), 16u);
+    EXPECT_EQ(source.getBytesUsed(), 0u);
+    EXPECT_EQ(source.getBytesReserved(), 0u);
+    EXPECT_EQ(source.getBlockCount(), 0u);
+
+    // The moved-from arena gets a block of its own instead of writing into
+    // the one it gave away
+    auto* later = static_cast<U1*>(source.allocate(16, 1));
+    std::fill(later, later + 16, U1{0xCD});
+    EXPECT_EQ(first[0], 0xAB);
+    EXPECT_EQ(first[15], 0xAB);
+    EXPECT_EQ(source.getBlockCount(), 1u);
+
+    RecordArena assigned;
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.getBytesUsed(), 16u);
+    EXPECT_EQ(moved.getBlockCount(), 0u);
+    moved.allocate(16, 1);
+    EXPECT_EQ(first[0], 0xAB);
+    EXPECT_EQ(assigned.getBlockCount(), 1u);
+}
+
 // === Integration Test: Parse and Insert All Records ===
 TEST(SystemIntegrationTest, ParseAndInsertAllRecords) {
     std::string sample = "../data/benchmark.stdf";
@@ -349,6 +1349,822 @@ TEST(SystemIntegrationTest, ParseAndInsertAllRecords) {
     std::filesystem::remove(dbPath);
 }
 
+// === Batch Ingest Tests ===
+TEST(BatchIngestTest, ExpandInputPaths) {
+    std::filesystem::path dir = "test_inputs_" + std::to_string(rand());
+    std::filesystem::create_directories(dir / "night" / "tester2");
+    StdfBytes b;
+    b.far();
+    b.write((dir / "night" / "a.stdf").string());
+    b.write((dir / "night" / "tester2" / "b.STDF").string());
+    b.write((dir / "night" / "notes.txt").string());
+    b.write((dir / "c.stdf").string());
+    b.write((dir / "d.stdf").string());
+
+    auto fromDir = expandInputPaths({(dir / "night").string()});
+    EXPECT_EQ(fromDir.size(), 2u);
+
+    auto fromGlob = expandInputPaths({(dir / "*.stdf").string(), (dir / "c.stdf").string()});
+    ASSERT_EQ(fromGlob.size(), 2u);
+    EXPECT_EQ(fromGlob[0], (dir / "c.stdf").string());
+
+    auto missing = expandInputPaths({(dir / "missing.stdf").string()});
+    EXPECT_EQ(missing.size(), 1u);
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(BatchIngestTest, ParallelLoadCommitsEachFile) {
+    std::vector<std::string> files;
+    for (int f = 0; f < 4; ++f) {
+        StdfBytes b;
+        b.far();
+        for (int part = 0; part < 5 + f * 20; ++part) {
+            b.pir(1, 1).ptr(1, 1, 1.0f).ptr(2, 1, 2.0f).prr(1, 1, part, 0);
+        }
+        files.push_back(b.write("test_batch_" + std::to_string(f) + "_" + std::to_string(rand()) + ".stdf"));
+    }
+    // A truncated file must be rolled back without affecting the others
+    StdfBytes bad;
+    bad.far().pir(1, 1).ptr(1, 1, 1.0f);
+    std::vector<uint8_t> badBytes = bad.bytes();
+    badBytes.resize(badBytes.size() - 2);
+    std::string badPath = "test_batch_bad_" + std::to_string(rand()) + ".stdf";
+    std::ofstream(badPath, std::ios::binary).write(reinterpret_cast<const char*>(badBytes.data()), badBytes.size());
+    files.push_back(badPath);
+
+    // A one-byte buffer limit makes the pool load one file at a time
+    struct Run { size_t workers; bool pipelined; size_t bufferLimit; };
+    for (Run run : {Run{1, false, 0}, Run{1, true, 0}, Run{3, false, 0}, Run{3, false, 1}}) {
+        std::string dbPath = temp_db_path();
+        Database db(dbPath);
+        ASSERT_TRUE(db.open());
+        ASSERT_TRUE(db.createTables());
+
+        BatchIngest ingest(db, run.workers);
+        ingest.setPipelined(run.pipelined);
+        if (run.bufferLimit > 0) {
+            ingest.setBufferLimit(run.bufferLimit);
+        }
+        auto summary = ingest.run(files);
+        ASSERT_EQ(summary.files.size(), files.size());
+        EXPECT_EQ(summary.filesFailed, 1u);
+        EXPECT_FALSE(summary.files.back().committed);
+        EXPECT_FALSE(summary.files.back().error.empty());
+
+        int expectedParts = 0;
+        for (int f = 0; f < 4; ++f) {
+            expectedParts += 5 + f * 20;
+            EXPECT_TRUE(summary.files[f].committed);
+        }
+        EXPECT_EQ(db.getRecordCount("far_records"), 4);
+        EXPECT_EQ(db.getRecordCount("pir_records"), expectedParts);
+        EXPECT_EQ(db.getRecordCount("ptr_records"), expectedParts * 2);
+        EXPECT_EQ(summary.totalInserted, static_cast<size_t>(4 + expectedParts * 4));
+        EXPECT_GT(summary.totalBytes, 0u);
+        EXPECT_EQ(summary.pipeline.batches > 0, run.pipelined);
+
+        db.close();
+        std::filesystem::remove(dbPath);
+    }
+    for (const auto& file : files) {
+        std::filesystem::remove(file);
+    }
+}
+
+TEST(BatchIngestTest, TestRowsLinkToFileAndPart) {
+    // Two sites tested side by side, then a PTR outside any part
+    StdfBytes b;
+    b.far();
+    for (int touchdown = 0; touchdown < 3; ++touchdown) {
+        b.pir(1, 1).pir(1, 2);
+        b.ptr(1, 1, 1.0f).ptr(1, 2, 1.0f).ptr(2, 1, 2.0f).ptr(2, 2, 2.0f);
+        b.prr(1, 1, touchdown * 2, 0).prr(2, 1, touchdown * 2 + 1, 0);
+    }
+    b.ptr(3, 1, 3.0f);
+    std::string file = b.write("test_links_" + std::to_string(rand()) + ".stdf");
+
+    for (SchemaMode mode : {SchemaMode::Wide, SchemaMode::Normalized}) {
+        for (size_t workers : {1u, 2u}) {
+            std::string dbPath = temp_db_path();
+            {
+                Database db(dbPath);
+                db.setSchemaMode(mode);
+                ASSERT_TRUE(db.open());
+                ASSERT_TRUE(db.createTables());
+                BatchIngest ingest(db, workers);
+                ASSERT_EQ(ingest.run({file}).filesFailed, 0u);
+                db.close();
+            }
+
+            sqlite3* raw = nullptr;
+            ASSERT_EQ(sqlite3_open(dbPath.c_str(), &raw), SQLITE_OK);
+            auto count = [&](const char* sql) {
+                sqlite3_stmt* stmt = nullptr;
+                int value = -1;
+                if (sqlite3_prepare_v2(raw, sql, -1, &stmt, nullptr) == SQLITE_OK &&
+                    sqlite3_step(stmt) == SQLITE_ROW) {
+                    value = sqlite3_column_int(stmt, 0);
+                }
+                sqlite3_finalize(stmt);
+                return value;
+            };
+            EXPECT_EQ(count("SELECT COUNT(*) FROM ptr_records t JOIN pir_records p ON p.id = t.part_id "
+                            "WHERE p.site_num = t.site_num AND p.file_id = 1;"), 12);
+            EXPECT_EQ(count("SELECT COUNT(*) FROM ptr_records WHERE part_id IS NULL;"), 1);
+            EXPECT_EQ(count("SELECT COUNT(*) FROM ptr_records WHERE file_id = 1;"), 13);
+            EXPECT_EQ(count("SELECT COUNT(*) FROM prr_records r JOIN pir_records p ON p.id = r.pir_id "
+                            "WHERE p.site_num = r.site_num;"), 6);
+            // All results for one die
+            EXPECT_EQ(count("SELECT COUNT(*) FROM prr_records r JOIN ptr_records t ON t.part_id = r.pir_id "
+                            "WHERE r.file_id = 1 AND r.x_coord = 3 AND r.y_coord = 0 AND t.site_num = 2;"), 2);
+            sqlite3_close(raw);
+            std::filesystem::remove(dbPath);
+        }
+    }
+    std::filesystem::remove(file);
+}
+
+TEST(BatchIngestTest, SpscRingKeepsOrderUnderBackpressure) {
+    SpscRing<std::vector<int>> ring(3);
+    EXPECT_EQ(ring.capacity(), 4u);
+
+    const int count = 20000;
+    std::thread producer([&]() {
+        for (int i = 0; i < count; ++i) {
+            std::vector<int> item{i, -i};
+            while (!ring.tryPush(item)) {
+                std::this_thread::yield();
+            }
+        }
+        ring.close();
+    });
+
+    int expected = 0;
+    std::vector<int> item;
+    while (!ring.isDrained()) {
+        if (ring.tryPop(item)) {
+            ASSERT_EQ(item.size(), 2u);
+            EXPECT_EQ(item[0], expected);
+            EXPECT_EQ(item[1], -expected);
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_EQ(expected, count);
+    EXPECT_FALSE(ring.tryPop(item));
+}
+
+// === Columnar File Tests ===
+TEST(ColumnarFileTest, RoundTripsColumnsChunksAndDictionaries) {
+    StdfBytes b;
+    b.far();
+    for (int touchdown = 0; touchdown < 3; ++touchdown) {
+        b.pir(1, 1).pir(1, 2);
+        b.ptr(1, 1, 1.0f + touchdown).ptr(1, 2, -1.0f).ptr(2, 1, 2.0f).ptr(2, 2, 2.0f);
+        b.prr(1, 1, touchdown * 2, 0).prr(2, 5, touchdown * 2 + 1, -1);
+    }
+    b.ptr(3, 1, 3.0f);
+    std::string file = b.write("test_columnar_" + std::to_string(rand()) + ".stdf");
+    std::string path = file + "c";
+
+    {
+        ColumnarWriter writer(path, 4);
+        STDFParser parser(file);
+        parser.parse(writer);
+        writer.finish();
+        EXPECT_EQ(writer.getRowCount(RecordType::PTR), 13u);
+    }
+
+    ColumnarReader reader(path);
+    EXPECT_FALSE(reader.hasTable(RecordType::FTR));
+    ASSERT_EQ(reader.getRowCount(RecordType::PTR), 13u);
+    ASSERT_EQ(reader.getChunkCount(RecordType::PTR), 4u);
+    EXPECT_EQ(reader.getChunkRows(RecordType::PTR, 3), 1u);
+    EXPECT_EQ(reader.getColumnType(RecordType::PTR, "result"), ColumnType::F32);
+
+    // Concatenated chunks reproduce the records in file order
+    std::vector<float> results;
+    std::vector<U4> parts;
+    std::vector<std::string> names;
+    const std::vector<std::string>& dictionary = reader.getDictionary(RecordType::PTR, "test_txt");
+    for (size_t chunk = 0; chunk < reader.getChunkCount(RecordType::PTR); ++chunk) {
+        ColumnSpan<R4> result = reader.column<R4>(RecordType::PTR, "result", chunk);
+        ColumnSpan<U4> part = reader.column<U4>(RecordType::PTR, "part_index", chunk);
+        ColumnSpan<U4> text = reader.column<U4>(RecordType::PTR, "test_txt", chunk);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(result.data) % alignof(R4), 0u);
+        ASSERT_EQ(result.size, reader.getChunkRows(RecordType::PTR, chunk));
+        results.insert(results.end(), result.begin(), result.end());
+        parts.insert(parts.end(), part.begin(), part.end());
+        for (U4 code : text) {
+            ASSERT_LT(code, dictionary.size());
+            names.push_back(dictionary[code]);
+        }
+    }
+    EXPECT_EQ(results[0], 1.0f);
+    EXPECT_EQ(results[1], -1.0f);
+    EXPECT_EQ(results[8], 3.0f);
+    EXPECT_EQ(parts[1], 1u);
+    EXPECT_EQ(parts[4], 2u);
+    EXPECT_EQ(parts[12], UINT32_MAX);
+    EXPECT_EQ(names[2], "TEST_2");
+    EXPECT_EQ(dictionary.size(), 3u);
+
+    const ColumnChunkInfo& first = reader.getChunkInfo(RecordType::PTR, "result", 0);
+    EXPECT_EQ(first.min, -1.0f);
+    EXPECT_EQ(first.max, 2.0f);
+    EXPECT_EQ(first.offset % 8, 0u);
+
+    ASSERT_EQ(reader.getRowCount(RecordType::PRR), 6u);
+    ColumnSpan<I2> y = reader.column<I2>(RecordType::PRR, "y_coord", 0);
+    ColumnSpan<U2> bin = reader.column<U2>(RecordType::PRR, "hard_bin", 0);
+    EXPECT_EQ(y[1], -1);
+    EXPECT_EQ(bin[1], 5);
+    EXPECT_THROW(reader.column<R4>(RecordType::PRR, "hard_bin", 0), std::runtime_error);
+    EXPECT_THROW(reader.column<U2>(RecordType::PRR, "missing", 0), std::runtime_error);
+
+    // A PIR left open at the end of one file does not claim the next file's rows
+    StdfBytes open;
+    open.far().pir(1, 1);
+    std::string openFile = open.write("test_columnar_open_" + std::to_string(rand()) + ".stdf");
+    StdfBytes next;
+    next.far().ptr(4, 1, 4.0f).pir(1, 1).ptr(4, 1, 5.0f).prr(1, 1, 0, 0);
+    std::string nextFile = next.write("test_columnar_next_" + std::to_string(rand()) + ".stdf");
+    {
+        ColumnarWriter writer(path);
+        for (const std::string& input : {openFile, nextFile}) {
+            writer.beginFile();
+            STDFParser(input).parse(writer);
+        }
+        writer.finish();
+    }
+    ColumnarReader joined(path);
+    ColumnSpan<U4> joinedParts = joined.column<U4>(RecordType::PTR, "part_index", 0);
+    ASSERT_EQ(joinedParts.size, 2u);
+    EXPECT_EQ(joinedParts[0], UINT32_MAX);
+    EXPECT_EQ(joinedParts[1], 1u);
+
+    std::filesystem::remove(openFile);
+    std::filesystem::remove(nextFile);
+    std::filesystem::remove(path);
+    std::filesystem::remove(file);
+}
+
+TEST(ColumnarFileTest, RejectsMissingAndCorruptFiles) {
+    EXPECT_THROW(ColumnarReader("does_not_exist.stdfc"), std::runtime_error);
+
+    std::string path = "test_columnar_bad_" + std::to_string(rand()) + ".stdfc";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "STDFCOL1 this is not a footer STDFCOL1";
+    }
+    EXPECT_THROW(ColumnarReader reader(path), std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+// === Export Tests ===
+TEST(ExportTest, CsvAndJsonLinesMatchRecords) {
+    StdfBytes b;
+    b.far().pir(1, 1).ptr(7, 1, 0.25f).ptr(8, 1, -1.5e-9f).prr(1, 3, -2, 4);
+    // PTR whose TEST_TXT needs CSV quoting and JSON escaping
+    b.u4(9).u1(1).u1(1).u1(0).u1(0).r4(1.0f).cn("a,\"b\"\n").cn("").u1(0).record(15, 10);
+    std::string file = b.write("test_export_" + std::to_string(rand()) + ".stdf");
+    std::string dir = file + "_csv";
+    std::string jsonl = file + ".jsonl";
+
+    auto slurp = [](const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    };
+
+    {
+        CsvExporter csv(dir);
+        STDFParser(file).parse(csv);
+        csv.finish();
+        EXPECT_EQ(csv.getRowCount(), 6u);
+        EXPECT_EQ(csv.getBytesWritten(),
+                  std::filesystem::file_size(dir + "/ptr.csv") + std::filesystem::file_size(dir + "/prr.csv") +
+                  std::filesystem::file_size(dir + "/pir.csv") + std::filesystem::file_size(dir + "/far.csv"));
+    }
+    std::string ptr = slurp(dir + "/ptr.csv");
+    EXPECT_EQ(ptr.substr(0, ptr.find('\n')),
+              "test_num,head_num,site_num,test_flg,parm_flg,result,test_txt,alarm_id,opt_flag,"
+              "res_scal,llm_scal,hlm_scal,lo_limit,hi_limit,units");
+    EXPECT_NE(ptr.find("\n7,1,1,0,0,0.25,TEST_7,,0,0,0,0,0,0,\n"), std::string::npos);
+    EXPECT_NE(ptr.find("\n8,1,1,0,0,-1.5e-09,TEST_8,"), std::string::npos);
+    EXPECT_NE(ptr.find("\n9,1,1,0,0,1,\"a,\"\"b\"\"\n\","), std::string::npos);
+    EXPECT_NE(slurp(dir + "/prr.csv").find("\n1,1,0,1,3,3,-2,4,100,PART,\n"), std::string::npos);
+    EXPECT_FALSE(std::filesystem::exists(dir + "/ftr.csv"));
+
+    {
+        JsonLinesExporter out(jsonl);
+        STDFParser parser(file);
+        parser.setRecordFilter({RecordType::PTR});
+        parser.parse(out);
+        out.finish();
+        EXPECT_EQ(out.getRowCount(), 3u);
+    }
+    std::string json = slurp(jsonl);
+    EXPECT_EQ(json.substr(0, json.find('\n')),
+              "{\"type\":\"PTR\",\"test_num\":7,\"head_num\":1,\"site_num\":1,\"test_flg\":0,\"parm_flg\":0,"
+              "\"result\":0.25,\"test_txt\":\"TEST_7\",\"alarm_id\":\"\",\"opt_flag\":0,\"res_scal\":0,"
+              "\"llm_scal\":0,\"hlm_scal\":0,\"lo_limit\":0,\"hi_limit\":0,\"units\":\"\"}");
+    EXPECT_NE(json.find("\"test_txt\":\"a,\\\"b\\\"\\n\""), std::string::npos);
+    EXPECT_EQ(std::count(json.begin(), json.end(), '\n'), 3);
+
+    std::filesystem::remove_all(dir);
+    std::filesystem::remove(jsonl);
+    std::filesystem::remove(file);
+}
+
+// === Test Statistics Tests ===
+TEST(TestStatsTest, WelfordMomentsLimitsAndMerge) {
+    // PTR with test flags and optional limits (OPT_FLAG 0x1E: LLM_SCAL/LO_LIMIT, HLM_SCAL/HI_LIMIT)
+    auto ptr = [](StdfBytes& b, uint32_t test, uint8_t site, uint8_t flags, float result, bool limits) {
+        b.u4(test).u1(1).u1(site).u1(flags).u1(0).r4(result).cn("VDD").cn("");
+        if (limits) {
+            b.u1(0x1E).u1(0).r4(0.0f).u1(0).r4(5.0f);
+        } else {
+            b.u1(0);
+        }
+        b.record(15, 10);
+    };
+    StdfBytes b;
+    b.far();
+    ptr(b, 10, 1, 0, 1.0f, true);
+    ptr(b, 10, 2, 0, 2.0f, false);
+    ptr(b, 10, 1, 0, 2.0f, false);
+    ptr(b, 10, 2, 0, 2.0f, false);
+    ptr(b, 10, 1, 0x80, 3.0f, false);
+    ptr(b, 10, 1, 0x10, 99.0f, false);
+    ptr(b, 10, 1, 0, 4.0f, false);
+    std::string file = b.write("test_stats_" + std::to_string(rand()) + ".stdf");
+
+    TestStatsAccumulator stats;
+    STDFParser(file).parse(stats);
+    std::vector<TestStats> results = stats.getResults();
+    ASSERT_EQ(results.size(), 2u);
+
+    const TestStats& site1 = results[0];
+    EXPECT_EQ(site1.siteNum, 1);
+    EXPECT_EQ(site1.testText, "VDD");
+    EXPECT_EQ(site1.count, 4u);
+    EXPECT_EQ(site1.passed, 3u);
+    EXPECT_EQ(site1.failed, 1u);
+    EXPECT_EQ(site1.invalid, 1u);
+    EXPECT_DOUBLE_EQ(site1.mean, 2.5);
+    EXPECT_DOUBLE_EQ(site1.variance(), 5.0 / 3.0);
+    EXPECT_EQ(site1.min, 1.0);
+    EXPECT_EQ(site1.max, 4.0);
+    EXPECT_NEAR(site1.cp(), 5.0 / (6.0 * std::sqrt(5.0 / 3.0)), 1e-12);
+    EXPECT_NEAR(site1.cpk(), 2.5 / (3.0 * std::sqrt(5.0 / 3.0)), 1e-12);
+
+    // Site 2 only saw PTRs without limits but inherits them; no spread, so no capability
+    const TestStats& site2 = results[1];
+    EXPECT_TRUE(site2.hasLoLimit && site2.hasHiLimit);
+    EXPECT_EQ(site2.hiLimit, 5.0);
+    EXPECT_TRUE(std::isnan(site2.cp()));
+
+    // Two halves merged equal a single pass over all four results
+    TestStats first, second;
+    for (double v : {1.0, 2.0}) first.add(v);
+    for (double v : {3.0, 4.0}) second.add(v);
+    first.merge(second);
+    EXPECT_EQ(first.count, 4u);
+    EXPECT_DOUBLE_EQ(first.mean, site1.mean);
+    EXPECT_DOUBLE_EQ(first.variance(), site1.variance());
+
+    TestStatsAccumulator merged;
+    merged.merge(stats);
+    merged.merge(stats);
+    EXPECT_EQ(merged.getResults()[0].count, 8u);
+    EXPECT_DOUBLE_EQ(merged.getResults()[0].mean, 2.5);
+
+    std::ostringstream report;
+    TestStatsAccumulator::writeReport(report, results);
+    EXPECT_NE(report.str().find("VDD"), std::string::npos);
+
+    // collectRecords() merges its per-thread copies and fails on a file cut short
+    auto collected = collectRecords<TestStatsAccumulator>({file, file}, 2, InputMode::Stream,
+                                                          {RecordType::PTR});
+    EXPECT_EQ(collected.getResults()[0].count, 8u);
+    std::string cutFile = b.writeTruncated("test_stats_cut_" + std::to_string(rand()) + ".stdf", 6);
+    for (auto mode : {InputMode::Stream, InputMode::MemoryMapped}) {
+        try {
+            collectRecords<TestStatsAccumulator>({file, cutFile}, 2, mode, {RecordType::PTR});
+            ADD_FAILURE() << "truncated file accepted";
+        } catch (const std::runtime_error& e) {
+            EXPECT_EQ(std::string(e.what()).find(cutFile + ": Truncated record"), 0u) << e.what();
+        }
+    }
+    std::filesystem::remove(cutFile);
+    std::filesystem::remove(file);
+}
+
+// === Quantile Sketch Tests ===
+TEST(QuantileSketchTest, KllQuantilesMergeAndSerialize) {
+    // 0..N-1 in a scrambled order; the exact q-quantile is q * N
+    const uint32_t N = 200000;
+    KllSketch whole, first, second;
+    for (uint32_t i = 0; i < N; ++i) {
+        float value = static_cast<float>((i * 7919u) % N);
+        whole.add(value);
+        (i < N / 2 ? first : second).add(value);
+    }
+    EXPECT_EQ(whole.count(), N);
+    EXPECT_LT(whole.retained(), 3u * KllSketch::DEFAULT_K);
+    EXPECT_EQ(whole.min(), 0.0f);
+    EXPECT_EQ(whole.max(), static_cast<float>(N - 1));
+
+    first.merge(second);
+    EXPECT_EQ(first.count(), N);
+    for (double q : {0.01, 0.25, 0.5, 0.99}) {
+        EXPECT_NEAR(whole.quantile(q), q * N, 0.02 * N) << "q=" << q;
+        EXPECT_NEAR(first.quantile(q), q * N, 0.02 * N) << "merged q=" << q;
+    }
+
+    std::vector<uint8_t> bytes;
+    whole.serialize(bytes);
+    size_t consumed = 0;
+    KllSketch copy = KllSketch::deserialize(bytes.data(), bytes.size(), consumed);
+    EXPECT_EQ(consumed, bytes.size());
+    EXPECT_EQ(copy.count(), N);
+    EXPECT_EQ(copy.quantile(0.5), whole.quantile(0.5));
+    bytes[3] ^= 1; // Count no longer matches the item weights
+    EXPECT_THROW(KllSketch::deserialize(bytes.data(), bytes.size(), consumed), std::runtime_error);
+
+    std::vector<uint64_t> bins = whole.histogram(0.0, N, 4);
+    ASSERT_EQ(bins.size(), 4u);
+    uint64_t total = 0;
+    for (uint64_t count : bins) {
+        EXPECT_NEAR(static_cast<double>(count), N / 4.0, 0.02 * N);
+        total += count;
+    }
+    EXPECT_EQ(total, N);
+}
+
+TEST(QuantileSketchTest, TestQuantilesScaleAndRoundTrip) {
+    // PTRs with RES_SCAL 3 and UNITS "V" (OPT_FLAG 0x21)
+    StdfBytes b;
+    b.far();
+    for (int i = 1; i <= 100; ++i) {
+        b.u4(5).u1(1).u1(1).u1(0).u1(0).r4(i * 0.001f).cn("IDD").cn("").u1(0x21).u1(3).cn("V").record(15, 10);
+    }
+    b.ptr(6, 1, 2.0f);
+    std::string file = b.write("test_quantiles_" + std::to_string(rand()) + ".stdf");
+
+    TestQuantiles quantiles;
+    STDFParser(file).parse(quantiles);
+    ASSERT_EQ(quantiles.size(), 2u);
+    const TestDistribution* idd = quantiles.find(5);
+    ASSERT_NE(idd, nullptr);
+    EXPECT_EQ(idd->sketch.count(), 100u);
+    EXPECT_EQ(idd->scaledUnits(), "mV");
+    EXPECT_NEAR(idd->sketch.quantile(0.5) * idd->scale(), 50.0, 1e-3);
+
+    std::string path = file + ".stdfq";
+    quantiles.save(path);
+    TestQuantiles merged = TestQuantiles::load(path);
+    merged.merge(quantiles);
+    EXPECT_EQ(merged.find(5)->sketch.count(), 200u);
+    EXPECT_EQ(merged.find(5)->scaledUnits(), "mV");
+    EXPECT_EQ(merged.find(6)->sketch.count(), 2u);
+
+    std::ostringstream report;
+    TestQuantiles::writeReport(report, merged.getResults(), 5);
+    EXPECT_NE(report.str().find("mV  IDD"), std::string::npos);
+
+    std::vector<uint8_t> data = quantiles.serialize();
+    data.pop_back();
+    EXPECT_THROW(TestQuantiles::deserialize(data), std::runtime_error);
+
+    // --quantiles path: a file cut inside its last PTR fails instead of
+    // yielding sketches that look complete
+    TestQuantiles collected = collectRecords<TestQuantiles>({file, file}, 2, InputMode::MemoryMapped,
+                                                            {RecordType::PTR});
+    EXPECT_EQ(collected.find(5)->sketch.count(), 200u);
+    std::string cutFile = b.writeTruncated("test_quantiles_cut_" + std::to_string(rand()) + ".stdf", 2);
+    EXPECT_THROW(collectRecords<TestQuantiles>({cutFile}, 1, InputMode::Stream, {RecordType::PTR}),
+                 std::runtime_error);
+
+    std::filesystem::remove(cutFile);
+    std::filesystem::remove(path);
+    std::filesystem::remove(file);
+}
+
+// === Wafer Map Tests ===
+
+TEST(WaferMapTest, BuildsGridsPerWaferAndRoundTrips) {
+    auto wir = [](StdfBytes& b, const std::string& id) { b.u1(1).u1(255).u4(0).cn(id).record(2, 10); };
+    auto wrr = [](StdfBytes& b, const std::string& id) {
+        b.u1(1).u1(255).u4(0).u4(4).u4(1).u4(0).u4(2).u4(0).cn(id).cn("").cn("").cn("").cn("").cn("").record(2, 20);
+    };
+    StdfBytes b;
+    b.far();
+    wir(b, "W1");
+    b.prr(0, 1, -1, 0).prr(1, 1, 0, 0).prr(0, 3, 1, 0).prr(1, 7, 0, 1);
+    b.prr(0, 5, 0, 0);          // Retest replaces the first result
+    b.prr(0, 2, -32768, -32768); // No coordinates
+    wrr(b, "W1");
+    wir(b, "");                  // Wafer ID only in the WRR
+    b.prr(0, 1, 10, 20);
+    wrr(b, "W2");
+    std::string file = b.write("test_wafer_map_" + std::to_string(rand()) + ".stdf");
+
+    WaferMapBuilder builder;
+    STDFParser(file).parse(builder);
+    builder.finish();
+    ASSERT_EQ(builder.getMaps().size(), 2u);
+    const WaferMap& w1 = builder.getMaps()[0];
+    EXPECT_EQ(w1.waferId, "W1");
+    EXPECT_EQ(w1.minX, -1);
+    EXPECT_EQ(w1.minY, 0);
+    EXPECT_EQ(w1.width, 3);
+    EXPECT_EQ(w1.height, 2);
+    EXPECT_EQ(w1.dieCount, 4u);
+    EXPECT_EQ(w1.hardBin(-1, 0), 1);
+    EXPECT_EQ(w1.hardBin(0, 0), 5);
+    EXPECT_EQ(w1.hardBin(0, 1), 7);
+    EXPECT_EQ(w1.hardBin(1, 1), WaferMap::NO_DIE);
+    EXPECT_EQ(w1.hardBin(5, 5), WaferMap::NO_DIE);
+    EXPECT_EQ(builder.getMaps()[1].waferId, "W2");
+    EXPECT_EQ(builder.getMaps()[1].dieCount, 1u);
+
+    // One byte per pixel after the header: pass 255, fail 128, no die 0
+    std::string pgm = file + ".pgm";
+    w1.writePGM(pgm, {1, 3}, false, 1);
+    std::ifstream image(pgm, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(image)), std::istreambuf_iterator<char>());
+    std::string header = "P5\n3 2\n255\n";
+    ASSERT_EQ(data.size(), header.size() + 6);
+    EXPECT_EQ(data.substr(0, header.size()), header);
+    EXPECT_EQ(data.substr(header.size()), std::string("\xFF\x80\xFF\x00\x80\x00", 6));
+
+    std::string path = file + ".wmap";
+    w1.save(path);
+    WaferMap copy = WaferMap::load(path);
+    EXPECT_EQ(copy.waferId, "W1");
+    EXPECT_EQ(copy.minX, -1);
+    EXPECT_EQ(copy.dieCount, 4u);
+    EXPECT_EQ(copy.hardBins, w1.hardBins);
+    EXPECT_EQ(copy.softBins, w1.softBins);
+    std::vector<uint8_t> bytes = w1.serialize();
+    bytes.pop_back();
+    EXPECT_THROW(WaferMap::deserialize(bytes), std::runtime_error);
+
+    // --wafer-maps path: an open wafer at the end of a whole file is mapped,
+    // but a file cut inside its last PRR gives no maps at all
+    StdfBytes open;
+    open.far();
+    wir(open, "W3");
+    open.prr(0, 1, 0, 0).prr(0, 1, 1, 0);
+    std::string openFile = open.write("test_wafer_map_open_" + std::to_string(rand()) + ".stdf");
+    std::vector<WaferMap> maps = loadWaferMaps(openFile);
+    ASSERT_EQ(maps.size(), 1u);
+    EXPECT_EQ(maps[0].dieCount, 2u);
+    std::string cutFile = open.writeTruncated("test_wafer_map_cut_" + std::to_string(rand()) + ".stdf", 4);
+    for (auto mode : {InputMode::Stream, InputMode::MemoryMapped}) {
+        EXPECT_THROW(loadWaferMaps(cutFile, mode), std::runtime_error);
+    }
+
+    std::filesystem::remove(cutFile);
+    std::filesystem::remove(openFile);
+    std::filesystem::remove(pgm);
+    std::filesystem::remove(path);
+    std::filesystem::remove(file);
+}
+
+// === Site Yield Tests ===
+
+TEST(SiteYieldTest, CountsPerSiteAndFlagsOutliers) {
+    // Site 1 passes every part; site 2 passes 60 of 100 (half of them in
+    // bin 2) and reads test 10 one unit higher
+    StdfBytes b;
+    b.far();
+    for (int i = 0; i < 100; ++i) {
+        float jitter = (i % 2) ? 0.1f : -0.1f;
+        b.ptr(10, 1, 1.0f + jitter).ptr(11, 1, 5.0f + jitter).prr(1, 1, 0, 0);
+        uint16_t bin = i < 60 ? (i % 2 ? 1 : 2) : (i < 90 ? 5 : 7);
+        b.ptr(10, 2, 2.0f + jitter).ptr(11, 2, 5.0f - jitter).prr(2, bin, 0, 0);
+    }
+    std::string file = b.write("test_site_yield_" + std::to_string(rand()) + ".stdf");
+
+    SiteYieldAccumulator sites({1, 2});
+    STDFParser(file).parse(sites);
+    ASSERT_EQ(sites.getSites().size(), 2u);
+    const SiteYield* site2 = sites.find(1, 2);
+    ASSERT_NE(site2, nullptr);
+    EXPECT_EQ(site2->parts, 100u);
+    EXPECT_EQ(site2->passed, 60u);
+    EXPECT_EQ(site2->hardBins[5], 30u);
+    EXPECT_EQ(site2->hardBins[7], 10u);
+    EXPECT_DOUBLE_EQ(site2->meanTestTime(), 100.0);
+    EXPECT_DOUBLE_EQ(sites.yield(), 0.8);
+    EXPECT_NEAR(sites.yieldZ(*site2), -5.0, 1e-9);
+    EXPECT_GT(sites.yieldZ(*sites.find(1, 1)), 3.0);
+
+    std::vector<SiteTestDelta> deltas = sites.compareTests();
+    ASSERT_EQ(deltas.size(), 4u);
+    EXPECT_EQ(deltas[1].testNum, 10u);
+    EXPECT_EQ(deltas[1].siteNum, 2);
+    EXPECT_NEAR(deltas[1].delta, 0.5, 1e-6);
+    EXPECT_GT(deltas[1].deltaSigma, 0.9);
+    EXPECT_NEAR(deltas[3].deltaSigma, 0.0, 1e-6); // Test 11 is the same on both sites
+
+    SiteYieldAccumulator twice({1, 2});
+    STDFParser(file).parse(twice);
+    twice.merge(sites);
+    EXPECT_EQ(twice.find(1, 2)->passed, 120u);
+    EXPECT_EQ(twice.getSites()[0].tests[0].count, 200u);
+    EXPECT_NEAR(twice.compareTests()[1].siteMean, deltas[1].siteMean, 1e-6);
+
+    std::ostringstream report;
+    sites.writeReport(report);
+    std::string text = report.str();
+    EXPECT_NE(text.find("5:30 7:10"), std::string::npos);
+    EXPECT_NE(text.find("LOW_YIELD MEAN_SHIFT(1)"), std::string::npos);
+    EXPECT_NE(text.find("(2 of 4 test/site pairs)"), std::string::npos);
+
+    // --site-yield path: per-thread copies keep the prototype's pass bins,
+    // and a file cut inside its last PRR fails the run
+    std::vector<RecordType> types = {RecordType::PRR, RecordType::PTR};
+    SiteYieldAccumulator collected = collectRecords<SiteYieldAccumulator>(
+        {file, file}, 2, InputMode::Stream, types, SiteYieldAccumulator({1, 2}));
+    EXPECT_EQ(collected.find(1, 2)->passed, 120u);
+    std::string cutFile = b.writeTruncated("test_site_yield_cut_" + std::to_string(rand()) + ".stdf", 4);
+    EXPECT_THROW(collectRecords<SiteYieldAccumulator>({file, cutFile}, 2, InputMode::MemoryMapped, types,
+                                                      SiteYieldAccumulator({1, 2})),
+                 std::runtime_error);
+
+    std::filesystem::remove(cutFile);
+    std::filesystem::remove(file);
+}
+
+TEST(SiteYieldTest, KeepsLastHeadSiteAndSkipsMissingSoftBin) {
+    // Every head/site pair in use, so the last one lands in slot 65535
+    SiteYieldAccumulator sites;
+    PRRRecord prr{};
+    prr.HARD_BIN = 1;
+    prr.SOFT_BIN = 65535; // No soft bin
+    for (int key = 0; key < 65536; ++key) {
+        prr.HEAD_NUM = static_cast<U1>(key >> 8);
+        prr.SITE_NUM = static_cast<U1>(key);
+        sites.onPRR(prr);
+    }
+    sites.onPRR(prr);
+
+    ASSERT_EQ(sites.getSites().size(), 65536u);
+    const SiteYield* last = sites.find(255, 255);
+    ASSERT_NE(last, nullptr);
+    EXPECT_EQ(last->parts, 2u);
+    EXPECT_TRUE(last->softBins.empty());
+    EXPECT_EQ(sites.find(255, 254)->parts, 1u);
+
+    SiteYieldAccumulator merged;
+    merged.merge(sites);
+    merged.merge(sites);
+    ASSERT_EQ(merged.getSites().size(), 65536u);
+    EXPECT_EQ(merged.find(255, 255)->passed, 4u);
+}
+
+// === What-If Limit Tests ===
+
+TEST(LimitWhatIfTest, KernelsAgreeOnEdgeValues) {
+    std::vector<float> values;
+    for (int i = 0; i < 1003; ++i) {
+        values.push_back(static_cast<float>((i * 37) % 101) / 10.0f - 2.0f);
+    }
+    values[5] = std::numeric_limits<float>::quiet_NaN();
+    values[70] = std::numeric_limits<float>::infinity();
+    values[71] = 1.0f; // Exactly on the limits: passes
+    values[72] = 5.0f;
+
+    TestLimits limits;
+    limits.hasLo = limits.hasHi = true;
+    limits.lo = 1.0f;
+    limits.hi = 5.0f;
+    size_t expected = 0;
+    for (float value : values) {
+        expected += value < 1.0f || value > 5.0f;
+    }
+
+    size_t words = (values.size() + 63) / 64;
+    std::vector<uint64_t> scalar(words), simd(words);
+    EXPECT_EQ(markLimitFailures(values.data(), values.size(), limits, scalar.data(), LimitKernel::Scalar), expected);
+    EXPECT_EQ(markLimitFailures(values.data(), values.size(), limits, simd.data(), LimitKernel::Avx2), expected);
+    EXPECT_EQ(scalar, simd);
+    EXPECT_FALSE(scalar[0] & (1ull << 5));
+    EXPECT_TRUE(scalar[1] & (1ull << 6));
+    EXPECT_FALSE(scalar[1] & (1ull << 7));
+
+    limits.hasHi = false; // Open high side
+    EXPECT_EQ(markLimitFailures(values.data(), values.size(), limits, scalar.data()),
+              static_cast<size_t>(std::count_if(values.begin(), values.end(), [](float v) { return v < 1.0f; })));
+
+    std::istringstream file("# test lo hi\n10, 0.5, 7\n11 - 2.5  # no low limit\n\n");
+    LimitSet parsed = parseLimits(file);
+    ASSERT_EQ(parsed.size(), 2u);
+    EXPECT_TRUE(parsed[10].hasLo && parsed[10].hasHi);
+    EXPECT_FLOAT_EQ(parsed[10].lo, 0.5f);
+    EXPECT_FALSE(parsed[11].hasLo);
+    std::istringstream bad("10 1\n");
+    EXPECT_THROW(parseLimits(bad), std::runtime_error);
+}
+
+TEST(LimitWhatIfTest, RecomputesYieldFromStdfAndColumnarFiles) {
+    // Ten parts: test 10 reads 0..9 against limits 0..7, so parts 8 and 9
+    // fail in bin 5; part 3 is binned out with no failing test
+    StdfBytes b;
+    b.far();
+    for (int i = 0; i < 10; ++i) {
+        bool fails = i > 7;
+        b.pir(1, 1);
+        b.u4(10).u1(1).u1(1).u1(fails ? 0x80 : 0).u1(0).r4(static_cast<float>(i))
+         .cn("VOUT").cn("").u1(0x1E).u1(0).r4(0.0f).u1(0).r4(7.0f).record(15, 10);
+        b.ptr(11, 1, 1.0f);
+        b.prr(1, fails ? 5 : (i == 3 ? 7 : 1), 0, 0);
+    }
+    std::string file = b.write("test_whatif_" + std::to_string(rand()) + ".stdf");
+
+    LimitWhatIf engine;
+    STDFParser(file).parse(engine);
+    EXPECT_EQ(engine.getPartCount(), 10u);
+    EXPECT_EQ(engine.getResultCount(), 20u);
+
+    // Tighter high limit on test 10: parts 6 and 7 now fail too
+    LimitSet tighter;
+    tighter[10].hasLo = tighter[10].hasHi = true;
+    tighter[10].hi = 5.5f;
+    WhatIfResult result = engine.evaluate(tighter);
+    EXPECT_EQ(result.parts, 10u);
+    EXPECT_EQ(result.binPassed, 7u);
+    EXPECT_EQ(result.newPassed, 5u);
+    EXPECT_EQ(result.newlyFailing, 2u);
+    ASSERT_EQ(result.tests.size(), 1u);
+    EXPECT_EQ(result.tests[0].oldFails, 2u);
+    EXPECT_EQ(result.tests[0].newFails, 4u);
+    EXPECT_FLOAT_EQ(result.tests[0].oldLimits.hi, 7.0f);
+    EXPECT_EQ(result.tests[0].testText, "VOUT");
+
+    // Opening the limit recovers parts 8 and 9 but not the bin 7 part
+    LimitSet open;
+    open[10] = TestLimits();
+    result = engine.evaluate(open, LimitKernel::Scalar);
+    EXPECT_EQ(result.newPassed, 9u);
+    EXPECT_EQ(result.newlyPassing, 2u);
+
+    std::ostringstream report;
+    LimitWhatIf::writeReport(report, engine.evaluate(tighter));
+    EXPECT_NE(report.str().find("Yield delta:     -20.00%"), std::string::npos);
+
+    std::string columnar = file + ".stdfc";
+    {
+        ColumnarWriter writer(columnar);
+        STDFParser(file).parse(writer);
+        writer.finish();
+    }
+    LimitWhatIf fromColumns;
+    fromColumns.loadColumnar(ColumnarReader(columnar));
+    result = fromColumns.evaluate(tighter);
+    EXPECT_EQ(result.parts, 10u);
+    EXPECT_EQ(result.newPassed, 5u);
+    EXPECT_EQ(result.tests[0].testText, "VOUT");
+
+    // A part left open at the end of one file takes no results from the next
+    StdfBytes openPart;
+    openPart.far().pir(1, 1);
+    std::string openFile = openPart.write("test_whatif_open_" + std::to_string(rand()) + ".stdf");
+    StdfBytes next;
+    next.far().ptr(10, 1, 9.0f).pir(1, 1).ptr(10, 1, 1.0f).prr(1, 1, 0, 0);
+    std::string nextFile = next.write("test_whatif_next_" + std::to_string(rand()) + ".stdf");
+    LimitWhatIf joined;
+    joined.loadFile(openFile);
+    joined.loadFile(nextFile);
+    EXPECT_EQ(joined.getResultCount(), 1u);
+    EXPECT_EQ(joined.evaluate(tighter).newPassed, 1u);
+
+    // --what-if path: a file cut inside its last PRR fails the run, and
+    // .stdfc inputs go through loadColumnar()
+    std::string cutFile = b.writeTruncated("test_whatif_cut_" + std::to_string(rand()) + ".stdf", 4);
+    LimitWhatIf partial;
+    partial.loadFile(columnar);
+    EXPECT_EQ(partial.getPartCount(), 10u);
+    try {
+        partial.loadFile(cutFile, InputMode::MemoryMapped);
+        ADD_FAILURE() << "a truncated input must fail --what-if";
+    } catch (const std::runtime_error& e) {
+        EXPECT_EQ(std::string(e.what()).find(cutFile + ": "), 0u) << e.what();
+    }
+
+    std::filesystem::remove(cutFile);
+    std::filesystem::remove(openFile);
+    std::filesystem::remove(nextFile);
+    std::filesystem::remove(columnar);
+    std::filesystem::remove(file);
+}
+
 // === Main ===
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);